@@ -27,8 +27,10 @@
 #include "srsran/support/srsran_assert.h"
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <new>
 #include <string>
 
 namespace asn1 {
@@ -185,6 +187,110 @@ public:
   SRSASN_CODE align_bytes_zero();
 };
 
+/************************
+      unpack arena
+************************/
+
+/**
+ * Monotonic allocator for the storage of dyn_array, ext_array and copy_ptr. While an unpack_arena_scope is alive in
+ * the current thread, these containers take their storage from the arena instead of the heap, and they only run the
+ * element destructors when they give it back. The memory itself is returned in one shot by reset() or by the arena
+ * destructor, so every object built under the scope must be destroyed before that happens. Copies made outside the
+ * scope go to the heap as usual.
+ */
+class unpack_arena
+{
+public:
+  explicit unpack_arena(std::size_t block_size_ = 4096) : block_size(block_size_) {}
+  unpack_arena(const unpack_arena&) = delete;
+  unpack_arena& operator=(const unpack_arena&) = delete;
+  ~unpack_arena();
+
+  void* allocate(std::size_t sz, std::size_t align);
+  /// Rewinds the arena, keeping its blocks for the next message
+  void        reset();
+  std::size_t nof_bytes_used() const { return used; }
+
+private:
+  struct block_t {
+    block_t*    next;
+    std::size_t size;
+  };
+  void next_block(std::size_t min_size);
+
+  std::size_t block_size;
+  block_t*    head  = nullptr;
+  block_t*    cur   = nullptr;
+  uintptr_t   pos   = 0;
+  uintptr_t   limit = 0;
+  std::size_t used  = 0;
+};
+
+/// Arena used by the containers of the current thread, or nullptr if none
+unpack_arena* get_unpack_arena();
+
+class unpack_arena_scope
+{
+public:
+  explicit unpack_arena_scope(unpack_arena& arena);
+  /// Heap allocations for the containers of the current thread, even inside the scope of an arena
+  explicit unpack_arena_scope(std::nullptr_t);
+  unpack_arena_scope(const unpack_arena_scope&) = delete;
+  unpack_arena_scope& operator=(const unpack_arena_scope&) = delete;
+  ~unpack_arena_scope();
+
+private:
+  unpack_arena* prev;
+};
+
+namespace detail {
+
+template <class T>
+T* new_array(uint32_t n, unpack_arena* arena)
+{
+  if (arena == nullptr) {
+    return new T[n];
+  }
+  T* p = static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+  for (uint32_t i = 0; i < n; ++i) {
+    new (&p[i]) T;
+  }
+  return p;
+}
+
+template <class T>
+void delete_array(T* p, uint32_t n, bool in_arena)
+{
+  if (not in_arena) {
+    delete[] p;
+    return;
+  }
+  for (uint32_t i = 0; i < n; ++i) {
+    p[i].~T();
+  }
+}
+
+template <class T, class... Args>
+T* new_object(unpack_arena* arena, Args&&... args)
+{
+  if (arena == nullptr) {
+    return new T(std::forward<Args>(args)...);
+  }
+  return new (arena->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
+
+template <class T>
+void delete_object(T* p, bool in_arena)
+{
+  if (not in_arena) {
+    delete p;
+    return;
+  }
+  p->~T();
+}
+
+} // namespace detail
+
 /*********************
   function helpers
 *********************/
@@ -196,15 +302,17 @@ public:
   using iterator       = T*;
   using const_iterator = const T*;
 
-  dyn_array() = default;
-  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size) { data_ = new T[size_]; }
+  dyn_array() : cap_(0), in_arena_(false) {}
+  explicit dyn_array(uint32_t new_size) : size_(new_size), cap_(new_size), in_arena_(false)
+  {
+    data_ = allocate_(size_);
+  }
   dyn_array(const dyn_array<T>& other) : dyn_array(&other[0], other.size_) {}
-  dyn_array(const T* ptr, uint32_t nof_items)
+  dyn_array(const T* ptr, uint32_t nof_items) : cap_(nof_items), in_arena_(false)
   {
     size_ = nof_items;
-    cap_  = nof_items;
     if (ptr != NULL) {
-      data_ = new T[cap_];
+      data_ = allocate_(cap_);
       std::copy(ptr, ptr + size_, data_);
     } else {
       data_ = NULL;
@@ -213,7 +321,7 @@ public:
   ~dyn_array()
   {
     if (data_ != NULL) {
-      delete[] data_;
+      detail::delete_array(data_, cap_, in_arena_);
     }
   }
   uint32_t      size() const { return size_; }
@@ -239,10 +347,12 @@ public:
       return;
     }
 
-    T* old_data = data_;
-    cap_        = new_size > new_cap ? new_size : new_cap;
+    T*       old_data     = data_;
+    uint32_t old_cap      = cap_;
+    bool     old_in_arena = in_arena_;
+    cap_                  = new_size > new_cap ? new_size : new_cap;
     if (cap_ > 0) {
-      data_ = new T[cap_];
+      data_ = allocate_(cap_);
       if (old_data != NULL) {
         srsran_assert(cap_ > size_, "Old size larger than new capacity in dyn_array\n");
         std::copy(&old_data[0], &old_data[size_], data_);
@@ -252,7 +362,7 @@ public:
     }
     size_ = new_size;
     if (old_data != NULL) {
-      delete[] old_data;
+      detail::delete_array(old_data, old_cap, old_in_arena);
     }
   }
   iterator erase(iterator it)
@@ -287,9 +397,17 @@ public:
   const_iterator end() const { return &data_[size()]; }
 
 private:
+  T* allocate_(uint32_t n)
+  {
+    unpack_arena* arena = get_unpack_arena();
+    in_arena_           = arena != nullptr;
+    return detail::new_array<T>(n, arena);
+  }
+
   T*       data_ = nullptr;
   uint32_t size_ = 0;
-  uint32_t cap_  = 0;
+  uint32_t cap_ : 31;
+  uint32_t in_arena_ : 1; // data_ was taken from an unpack_arena
 };
 
 template <class T, uint32_t MAX_N>
@@ -359,7 +477,7 @@ public:
       std::copy(other.data(), other.data() + other.size(), head);
     } else {
       head              = other.head;
-      small_buffer.cap_ = other.small_buffer.cap_;
+      small_buffer.heap = other.small_buffer.heap;
       other.head        = &other.small_buffer.data[0];
       other.size_       = 0;
     }
@@ -367,7 +485,7 @@ public:
   ~ext_array()
   {
     if (not is_in_small_buffer()) {
-      delete[] head;
+      detail::delete_array(head, small_buffer.heap.cap_, small_buffer.heap.in_arena);
     }
   }
   ext_array<T, Nthres>& operator=(const ext_array<T, Nthres>& other)
@@ -380,7 +498,7 @@ public:
   }
 
   uint32_t size() const { return size_; }
-  uint32_t capacity() const { return is_in_small_buffer() ? Nthres : small_buffer.cap_; }
+  uint32_t capacity() const { return is_in_small_buffer() ? Nthres : small_buffer.heap.cap_; }
   T&       operator[](uint32_t index) { return head[index]; }
   const T& operator[](uint32_t index) const { return head[index]; }
   T*       data() { return &head[0]; }
@@ -405,22 +523,27 @@ public:
       size_ = new_size;
       return;
     }
-    T*       old_data = head;
-    uint32_t newcap   = new_size + 5;
-    head              = new T[newcap];
-    std::copy(&small_buffer.data[0], &small_buffer.data[size_], head);
+    T*            old_data = head;
+    uint32_t      newcap   = new_size + 5;
+    unpack_arena* arena    = get_unpack_arena();
+    head                   = detail::new_array<T>(newcap, arena);
+    std::copy(&old_data[0], &old_data[size_], head);
     size_ = new_size;
     if (old_data != &small_buffer.data[0]) {
-      delete[] old_data;
+      detail::delete_array(old_data, small_buffer.heap.cap_, small_buffer.heap.in_arena);
     }
-    small_buffer.cap_ = newcap;
+    small_buffer.heap.cap_     = newcap;
+    small_buffer.heap.in_arena = arena != nullptr;
   }
   bool is_in_small_buffer() const { return head == &small_buffer.data[0]; }
 
 private:
   union {
-    T        data[Nthres];
-    uint32_t cap_;
+    T data[Nthres];
+    struct {
+      uint32_t cap_;
+      bool     in_arena; // head was taken from an unpack_arena
+    } heap;
   } small_buffer;
   uint32_t size_;
   T*       head;
@@ -1167,20 +1290,27 @@ class copy_ptr
 public:
   copy_ptr() : ptr(nullptr) {}
   explicit copy_ptr(T* ptr_) : ptr(ptr_) {}
-  copy_ptr(copy_ptr<T>&& other) noexcept : ptr(other.ptr) { other.ptr = nullptr; }
-  copy_ptr(const copy_ptr<T>& other) { ptr = (other.ptr == nullptr) ? nullptr : new T(*other.ptr); }
+  copy_ptr(copy_ptr<T>&& other) noexcept : ptr(other.ptr), in_arena(other.in_arena) { other.ptr = nullptr; }
+  copy_ptr(const copy_ptr<T>& other) : ptr(nullptr)
+  {
+    if (other.ptr != nullptr) {
+      create_(*other.ptr);
+    }
+  }
   ~copy_ptr() { destroy_(); }
   copy_ptr<T>& operator=(const copy_ptr<T>& other)
   {
     if (this != &other) {
-      reset((other.ptr == nullptr) ? nullptr : new T(*other.ptr));
+      *this = copy_ptr<T>(other);
     }
     return *this;
   }
   copy_ptr<T>& operator=(copy_ptr<T>&& other) noexcept
   {
     if (this != &other) {
+      destroy_();
       ptr       = other.ptr;
+      in_arena  = other.in_arena;
       other.ptr = nullptr;
     }
     return *this;
@@ -1192,21 +1322,30 @@ public:
   const T& operator*() const { return *ptr; } // like pointers, don't call this if ptr==NULL
   T*       get() { return ptr; }
   const T* get() const { return ptr; }
-  T*       release()
+  // the caller owns the returned object and deletes it, so arena-backed objects are copied to the heap first. A move
+  // would leave the nested containers of the object in the arena
+  T* release()
   {
     T* ret = ptr;
-    ptr    = nullptr;
+    if (ptr != nullptr and in_arena) {
+      unpack_arena_scope heap_scope(nullptr);
+      ret = new T(*ptr);
+      destroy_();
+    }
+    ptr = nullptr;
     return ret;
   }
   void reset(T* ptr_ = nullptr)
   {
     destroy_();
-    ptr = ptr_;
+    ptr      = ptr_;
+    in_arena = false;
   }
   void set_present(bool flag = true)
   {
     if (flag) {
-      reset(new T());
+      destroy_();
+      create_();
     } else {
       reset();
     }
@@ -1214,13 +1353,21 @@ public:
   bool is_present() const { return get() != nullptr; }
 
 private:
+  template <class... Args>
+  void create_(Args&&... args)
+  {
+    unpack_arena* arena = get_unpack_arena();
+    ptr                 = detail::new_object<T>(arena, std::forward<Args>(args)...);
+    in_arena            = arena != nullptr;
+  }
   void destroy_()
   {
     if (ptr != NULL) {
-      delete ptr;
+      detail::delete_object(ptr, in_arena);
     }
   }
-  T* ptr;
+  T*   ptr;
+  bool in_arena = false; // ptr was taken from an unpack_arena
 };
 
 template <class T>
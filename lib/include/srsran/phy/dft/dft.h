@@ -24,6 +24,7 @@
 
 #include "srsran/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -124,6 +125,32 @@ SRSRAN_API void srsran_dft_run_guru_c(srsran_dft_plan_t* plan);
 
 SRSRAN_API void srsran_dft_run_r(srsran_dft_plan_t* plan, const float* in, float* out);
 
+/* Wisdom */
+
+/**
+ * @brief Switches the wisdom file, by default ~/.srsran_fftwisdom or the path in the SRSRAN_FFTW_WISDOM environment
+ * variable, and imports it if it exists. The file is only read at runtime, it is written by srsran_dft_wisdom_export()
+ * alone.
+ */
+SRSRAN_API int srsran_dft_wisdom_set_file(const char* path);
+
+/**
+ * @brief Merges the current wisdom with the wisdom file content and atomically replaces the file with the result.
+ * Concurrent exports are serialized on a lock file next to the wisdom file.
+ */
+SRSRAN_API int srsran_dft_wisdom_export(void);
+
+/**
+ * @brief Plans forward and backward complex DFTs of every size, as batches of how_many transforms when how_many is
+ * greater than 1, so that the wisdom holds them. Used to generate wisdom ahead of time.
+ */
+SRSRAN_API int srsran_dft_precompute(const uint32_t* sizes, uint32_t nof_sizes, uint32_t how_many);
+
+/**
+ * @brief Number of FFTW plans created by this process and the total time spent creating them
+ */
+SRSRAN_API void srsran_dft_get_plan_stats(uint32_t* nof_plans, double* time_s);
+
 #ifdef __cplusplus
 }
 #endif
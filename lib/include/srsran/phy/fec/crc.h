@@ -44,6 +44,11 @@ typedef struct SRSRAN_API {
   uint64_t crcmask;
   uint64_t crchighbit;
   uint32_t srsran_crc_out;
+
+  // Bit-unpacked checksum engine. The register is kept aligned to bit 31 so every order up to 32 shares the code.
+  uint32_t table8[8][256]; // Slicing-by-8 tables
+  uint64_t fold[4];        // x^192, x^128, x^576 and x^512 modulo the aligned polynomial
+  bool     use_pclmul;     // Fold with carry-less multiplications, set at init if the CPU supports them
 } srsran_crc_t;
 
 SRSRAN_API int srsran_crc_init(srsran_crc_t* h, uint32_t srsran_crc_poly, int srsran_crc_order);
@@ -45,7 +45,9 @@ typedef enum SRSRAN_API {
   SRSRAN_POLAR_DECODER_SSC_S = 1, /*!< \brief Fixed-point (16 bit) Simplified Successive Cancellation (SSC) decoder. */
   SRSRAN_POLAR_DECODER_SSC_C = 2, /*!< \brief Fixed-point (8 bit) Simplified Successive Cancellation (SSC) decoder. */
   SRSRAN_POLAR_DECODER_SSC_C_AVX2 =
-      3 /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation (SSC) decoder. */
+      3, /*!< \brief Fixed-point (8 bit, avx2) Simplified Successive Cancellation (SSC) decoder. */
+  SRSRAN_POLAR_DECODER_FAST_SSC_C =
+      4 /*!< \brief Fixed-point (8 bit) Fast-SSC decoder, with REP, SPC and REP-SPC nodes and cached schedules. */
 } srsran_polar_decoder_type_t;
 
 /*!
@@ -35,9 +35,10 @@
  * @brief Describes the NR PBCH object initialisation arguments
  */
 typedef struct SRSRAN_API {
-  bool enable_encode; ///< Enable encoder
-  bool enable_decode; ///< Enable decoder
-  bool disable_simd;  ///< Disable SIMD polar encoder/decoder
+  bool enable_encode;    ///< Enable encoder
+  bool enable_decode;    ///< Enable decoder
+  bool disable_simd;     ///< Disable SIMD polar encoder/decoder
+  bool disable_fast_ssc; ///< Use the SSC polar decoder instead of Fast-SSC
 } srsran_pbch_nr_args_t;
 
 /**
@@ -50,6 +50,7 @@ extern "C" {
  */
 typedef struct {
   bool disable_simd;
+  bool disable_fast_ssc;
   bool measure_evm;
   bool measure_time;
 } srsran_pdcch_nr_args_t;
@@ -47,10 +47,25 @@
 // Short PRACH ZC sequence sequence length
 #define SRSRAN_PRACH_N_ZC_SHORT 139
 
+// Number of preambles transformed by a single run of the batched generation IFFT
+#define SRSRAN_PRACH_GEN_BATCH_MAX 16
+
+// Number of root sequences correlated by a single run of the batched detection IFFT
+#define SRSRAN_PRACH_DETECT_BATCH_MAX 16
+
+/**
+ * @brief Preamble sequences of one (N_zc, rsi, N_cs, hs) combination and their DFTs. Tables are reference counted and
+ * shared by every PRACH object using the same combination, sequences are only generated when first used.
+ */
+typedef struct srsran_prach_seq_table_s srsran_prach_seq_table_t;
+
 /** Generation and detection of RACH signals for uplink.
  *  Currently only supports preamble formats 0-3.
  *  Does not currently support high speed flag.
  *  Based on 3GPP TS 36.211 version 10.7.0 Release 10.
+ *  Objects must not be copied by assignment: the buffers, DFT plans and the seq_table reference are owned by the
+ *  object and released by srsran_prach_free(). Initialize another object with the same configuration instead, both
+ *  then share the sequence table.
  */
 
 typedef struct {
@@ -81,10 +96,9 @@ typedef struct SRSRAN_API {
   uint32_t N_cp;  // Cyclic prefix length
 
   // Generated tables
-  cf_t     seqs[64][SRSRAN_PRACH_N_ZC_LONG];     // Our set of 64 preamble sequences
-  cf_t     dft_seqs[64][SRSRAN_PRACH_N_ZC_LONG]; // DFT-precoded seqs
-  uint64_t dft_gen_bitmap;    // Bitmap where each bit Indicates if the dft has been generated for sequence i.
-  uint32_t root_seqs_idx[64]; // Indices of root seqs in seqs table
+  srsran_prach_seq_table_t* seq_table;         // Shared 64 preamble sequences and their DFTs, one reference per object
+  uint32_t                  root_seqs_idx[64]; // Indices of root seqs in seqs table
+  cf_t*                     dft_seqs[64];      // DFTs already looked up in seq_table, saves locking it
   uint32_t N_roots;           // Number of root sequences used in this configuration
   cf_t*    td_signals[64];
   // Containers
@@ -102,6 +116,19 @@ typedef struct SRSRAN_API {
   srsran_dft_plan_t zc_fft;
   srsran_dft_plan_t zc_ifft;
 
+  // Batched PRACH IFFT, planned for N_ifft_prach on the first srsran_prach_gen_batch() call
+  srsran_dft_plan_t ifft_batch;
+  cf_t*             ifft_batch_in;
+  cf_t*             ifft_batch_out;
+  uint32_t          ifft_batch_size; // IFFT size of ifft_batch, 0 if not planned
+
+  // Batched ZC-sequence IFFT of the detector, planned for N_zc on the first srsran_prach_process() call
+  srsran_dft_plan_t zc_ifft_batch;
+  cf_t*             zc_batch_in;   // Correlation spectra, one per root sequence
+  cf_t*             zc_batch_out;  // Correlations in time domain
+  float*            zc_batch_corr; // Correlation power
+  uint32_t          zc_batch_size; // IFFT size of zc_ifft_batch, 0 if not planned
+
   cf_t* signal_fft;
   float detect_factor;
 
@@ -218,6 +245,25 @@ SRSRAN_API int srsran_prach_set_cfg(srsran_prach_t* p, srsran_prach_cfg_t* cfg,
 
 SRSRAN_API int srsran_prach_gen(srsran_prach_t* p, uint32_t seq_index, uint32_t freq_offset, cf_t* signal);
 
+/**
+ * @brief Generates several preambles at once, same as calling srsran_prach_gen() for each of them
+ *
+ * The IFFTs of up to SRSRAN_PRACH_GEN_BATCH_MAX preambles are computed by a single FFTW plan. The cyclic prefix and
+ * the periodic extension are written, together with the IFFT normalisation, straight into the caller buffers.
+ *
+ * @param p PRACH object
+ * @param seq_indices Preamble indices to generate
+ * @param nof_seqs Number of preambles
+ * @param freq_offset Frequency offset in resource blocks
+ * @param signals One output buffer of N_cp + N_seq samples per preamble, e.g. slots of a single arena
+ * @return SRSRAN_SUCCESS if the preambles are generated, SRSRAN_ERROR otherwise
+ */
+SRSRAN_API int srsran_prach_gen_batch(srsran_prach_t*  p,
+                                      const uint32_t* seq_indices,
+                                      uint32_t        nof_seqs,
+                                      uint32_t        freq_offset,
+                                      cf_t**          signals);
+
 SRSRAN_API int srsran_prach_detect(srsran_prach_t* p,
                                    uint32_t        freq_offset,
                                    cf_t*           signal,
@@ -76,6 +76,9 @@ typedef struct SRSRAN_API {
   /// LDPC Rate matcher
   srsran_ldpc_rm_t tx_rm;
   srsran_ldpc_rm_t rx_rm;
+
+  /// Code-block-parallel decoding threads, NULL if disabled
+  void* coworkers_ptr;
 } srsran_sch_nr_t;
 
 /**
@@ -85,7 +88,8 @@ typedef struct SRSRAN_API {
   bool     disable_simd;
   bool     decoder_use_flooded;
   float    decoder_scaling_factor;
-  uint32_t max_nof_iter; ///< Maximum number of LDPC iterations
+  uint32_t max_nof_iter;  ///< Maximum number of LDPC iterations
+  uint32_t nof_coworkers; ///< Threads decoding code blocks alongside the caller, 0 decodes them all in the caller
 } srsran_sch_nr_args_t;
 
 /**
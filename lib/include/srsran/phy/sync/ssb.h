@@ -70,6 +70,9 @@
    bool disable_polar_simd; ///< Disables polar encoder/decoder SIMD acceleration
    float pbch_dmrs_thr; ///< NR-PBCH DMRS threshold for blind decoding, set to 0
                         ///< for default
+   float pss_prune_thr; ///< PSS search skips correlation windows with less
+                        ///< average power than this factor times the average
+                        ///< power of the input, set to 0 to search every window
  } srsran_ssb_args_t;
  
  /**
@@ -128,6 +131,7 @@
    srsran_dft_plan_t fft;       ///< FFT object for demodulate the SSB.
    srsran_dft_plan_t fft_corr;  ///< FFT for correlation
    srsran_dft_plan_t ifft_corr; ///< IFFT for correlation
+   srsran_dft_plan_t ifft_hyp;  ///< IFFT of every PSS search hypothesis at once
    srsran_pbch_nr_t pbch;       ///< PBCH encoder and decoder
  
    /// Frequency/Time domain temporal data
@@ -137,6 +141,14 @@
    cf_t *sf_buffer; ///< subframe buffer
    cf_t
        *pss_seq[SRSRAN_NOF_NID_2_NR]; ///< Possible frequency domain PSS for find
+   float *pss_pwr[SRSRAN_NOF_NID_2_NR]; ///< Power of each frequency domain PSS
+   float *tmp_pwr; ///< Power of the correlation input in frequency domain
+
+   /// PSS search hypotheses (N_id_2 and coarse frequency shift)
+   uint32_t nof_hyp;     ///< Number of hypotheses planned in ifft_hyp
+   uint32_t hyp_corr_sz; ///< Correlation size planned in ifft_hyp
+   cf_t *hyp_corr;       ///< Frequency domain correlation of each hypothesis
+   cf_t *hyp_time;       ///< Time domain correlation of each hypothesis
  } srsran_ssb_t;
  
  /**
@@ -74,7 +74,8 @@ typedef struct SRSRAN_API {
   srsran_pdcch_nr_t             pdcch;
   srsran_dmrs_pdcch_ce_t*       pdcch_ce;
 
-  /// Store Blind-search information from all possible candidate locations for debug purposes
+  /// Store Blind-search information from all possible candidate locations for debug purposes. Each location is measured
+  /// once, nof_bits is zero if it was discarded or skipped before decoding
   srsran_ue_dl_nr_pdcch_info_t pdcch_info[SRSRAN_MAX_NOF_CANDIDATES_SLOT_NR];
   uint32_t                     pdcch_info_count;
 
@@ -51,6 +51,7 @@ typedef struct SRSRAN_API {
   // Signal detection thresholds and averaging coefficients
   float pbch_dmrs_thr; ///< NR-PBCH DMRS threshold for blind decoding, set to 0 for default
   float cfo_alpha;     ///< Exponential Moving Average (EMA) alpha coefficient for CFO
+  float pss_prune_thr; ///< Skips PSS correlation windows below this factor of the average power, 0 disables
 
   // Receive callback
   void* recv_obj;                               ///< Receive object
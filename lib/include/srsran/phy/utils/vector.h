@@ -401,6 +401,20 @@ SRSRAN_API float srsran_vec_papr_c(const cf_t* in, const int len);
 SRSRAN_API float
 srsran_vec_acpr_c(const cf_t* x_f, const uint32_t win_pos_len, const uint32_t win_neg_len, const uint32_t len);
 
+/*!
+ * @brief Gets the instruction set used by the hot vector kernels
+ * @returns "baseline" for the project-wide build flags, otherwise the name of the wider build picked at load time
+ */
+SRSRAN_API const char* srsran_vec_get_isa(void);
+
+/*!
+ * @brief Selects the instruction set of the hot vector kernels, overriding the choice made at load time
+ * @attention Not thread safe, call it before any other thread uses the vector functions
+ * @param[in]  name  "baseline", "avx2" or "avx512". The environment variable SRSRAN_VEC_ISA does the same at load time
+ * @returns SRSRAN_SUCCESS, or SRSRAN_ERROR if the build or the CPU lacks that instruction set
+ */
+SRSRAN_API int srsran_vec_set_isa(const char* name);
+
 #ifdef __cplusplus
 }
 #endif
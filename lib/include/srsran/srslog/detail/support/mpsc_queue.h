@@ -0,0 +1,213 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLOG_DETAIL_SUPPORT_MPSC_QUEUE_H
+#define SRSLOG_DETAIL_SUPPORT_MPSC_QUEUE_H
+
+#include "srsran/srslog/detail/support/backend_capacity.h"
+#include "srsran/srslog/shared_types.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace srslog {
+
+namespace detail {
+
+/// Bounded lock free multi producer queue, drained by the backend thread.
+///
+/// Every cell carries a sequence number that tells producers and consumers
+/// whose turn it is (D. Vyukov's bounded queue), so pushing an element only
+/// takes a CAS on the enqueue position and never blocks behind another thread.
+/// When the queue is full the overflow policy decides whether the new element
+/// is discarded, the oldest queued one is discarded to make room, or the
+/// producer waits. Discarded elements are counted, elements evicted by
+/// drop_oldest are handed to the discard handler so that their resources can
+/// be released.
+template <typename T, size_t capacity = SRSLOG_QUEUE_CAPACITY>
+class mpsc_queue
+{
+  static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "Queue capacity must be a power of two");
+
+  static constexpr size_t mask      = capacity - 1;
+  static constexpr size_t threshold = capacity * 0.98;
+
+  struct cell {
+    std::atomic<size_t> seq;
+    T                   value;
+  };
+
+  std::unique_ptr<cell[]> cells;
+  // Producers and the consumer write different cache lines.
+  alignas(64) std::atomic<size_t> enqueue_pos{0};
+  alignas(64) std::atomic<size_t> dequeue_pos{0};
+  alignas(64) std::atomic<uint64_t> nof_dropped{0};
+  std::atomic<queue_overflow_policy> policy{queue_overflow_policy::drop_newest};
+  std::function<void(T&&)>           discard_handler = [](T&&) {};
+
+public:
+  mpsc_queue() : cells(new cell[capacity])
+  {
+    for (size_t i = 0; i != capacity; ++i) {
+      cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpsc_queue(const mpsc_queue&) = delete;
+  mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+  /// Selects the behaviour of push when the queue is full.
+  void set_overflow_policy(queue_overflow_policy new_policy) { policy = new_policy; }
+
+  /// Installs the callback receiving the elements evicted by the drop_oldest
+  /// policy. It runs in the producer thread that evicted them.
+  /// NOTE: Not thread safe, call before any push.
+  void set_discard_handler(std::function<void(T&&)> handler)
+  {
+    if (!handler) {
+      discard_handler = [](T&&) {};
+      return;
+    }
+    discard_handler = std::move(handler);
+  }
+
+  /// Inserts a new element into the back of the queue. Returns false when the
+  /// queue is full and the element was discarded, in which case it is left
+  /// untouched, otherwise true.
+  bool push(const T& value)
+  {
+    T tmp = value;
+    return push(std::move(tmp));
+  }
+
+  /// Inserts a new element into the back of the queue. Returns false when the
+  /// queue is full and the element was discarded, in which case it is left
+  /// untouched, otherwise true.
+  bool push(T&& value)
+  {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell&     c    = cells[pos & mask];
+      size_t    seq  = c.seq.load(std::memory_order_acquire);
+      ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)pos;
+
+      if (diff == 0) {
+        // The cell is free, claim it.
+        if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          c.value = std::move(value);
+          c.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+        continue;
+      }
+
+      if (diff > 0) {
+        // Another producer took this position, retry with the current one.
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      // The cell still holds an element from the previous lap: full.
+      switch (policy.load(std::memory_order_relaxed)) {
+        case queue_overflow_policy::drop_newest:
+          nof_dropped.fetch_add(1, std::memory_order_relaxed);
+          return false;
+        case queue_overflow_policy::drop_oldest: {
+          T oldest;
+          if (pop(oldest)) {
+            nof_dropped.fetch_add(1, std::memory_order_relaxed);
+            discard_handler(std::move(oldest));
+          }
+          break;
+        }
+        case queue_overflow_policy::block:
+          // Check for room again once the backend had time to drain some.
+          std::this_thread::sleep_for(std::chrono::microseconds(10));
+          break;
+      }
+      pos = enqueue_pos.load(std::memory_order_relaxed);
+    }
+  }
+
+  /// Extracts the top most element from the queue if it exists.
+  /// Returns a pair with a bool indicating if the pop has been successful.
+  std::pair<bool, T> try_pop()
+  {
+    T item;
+    if (!pop(item)) {
+      return {false, T()};
+    }
+    return {true, std::move(item)};
+  }
+
+  /// Capacity of the queue.
+  size_t get_capacity() const { return capacity; }
+
+  /// Number of elements discarded because the queue was full.
+  uint64_t get_nof_dropped() const { return nof_dropped.load(std::memory_order_relaxed); }
+
+  /// Returns true when the queue is almost full, otherwise returns false.
+  bool is_almost_full() const
+  {
+    size_t head = dequeue_pos.load(std::memory_order_relaxed);
+    size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+    return tail - head > threshold;
+  }
+
+private:
+  /// Pops from the front of the queue. Besides the backend thread, producers
+  /// evicting under drop_oldest also pop, so the dequeue position is claimed
+  /// with a CAS as well.
+  bool pop(T& item)
+  {
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    while (true) {
+      cell&     c    = cells[pos & mask];
+      size_t    seq  = c.seq.load(std::memory_order_acquire);
+      ptrdiff_t diff = (ptrdiff_t)seq - (ptrdiff_t)(pos + 1);
+
+      if (diff == 0) {
+        if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          item = std::move(c.value);
+          c.seq.store(pos + capacity, std::memory_order_release);
+          return true;
+        }
+        continue;
+      }
+
+      if (diff < 0) {
+        // Empty, or the producer of this cell has not finished writing it.
+        return false;
+      }
+      pos = dequeue_pos.load(std::memory_order_relaxed);
+    }
+  }
+};
+
+} // namespace detail
+
+} // namespace srslog
+
+#endif // SRSLOG_DETAIL_SUPPORT_MPSC_QUEUE_H
@@ -40,6 +40,16 @@ enum class backend_priority {
   very_high
 };
 
+/// Behaviour of the backend queue when it is full.
+enum class queue_overflow_policy {
+  /// Discard the entry being pushed.
+  drop_newest,
+  /// Discard the oldest queued entry to make room for the new one.
+  drop_oldest,
+  /// Wait in the producer thread until the backend makes room.
+  block
+};
+
 /// syslog log local types
 enum class syslog_local_type {
   local0,
@@ -254,6 +254,14 @@ void flush();
 /// NOTE: This function should be called before init() and is NOT thread safe.
 void set_error_handler(error_handler handler);
 
+/// Selects what happens to new log entries when the backend queue is full. By
+/// default they are discarded (drop_newest).
+void set_queue_overflow_policy(queue_overflow_policy policy);
+
+/// Returns the number of log entries discarded so far because the backend
+/// queue was full.
+uint64_t get_nof_dropped_entries();
+
 } // namespace srslog
 
 #endif // SRSLOG_SRSLOG_H
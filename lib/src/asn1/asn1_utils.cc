@@ -345,6 +345,82 @@ SRSASN_CODE bit_ref::align_bytes_zero()
   return SRSASN_SUCCESS;
 }
 
+/************************
+      unpack arena
+************************/
+
+static thread_local unpack_arena* current_unpack_arena = nullptr;
+
+unpack_arena::~unpack_arena()
+{
+  while (head != nullptr) {
+    block_t* next = head->next;
+    ::operator delete(head);
+    head = next;
+  }
+}
+
+void* unpack_arena::allocate(std::size_t sz, std::size_t align)
+{
+  uintptr_t p = (pos + align - 1) & ~(uintptr_t)(align - 1);
+  if (cur == nullptr or p + sz > limit) {
+    next_block(sz + align);
+    p = (pos + align - 1) & ~(uintptr_t)(align - 1);
+  }
+  pos = p + sz;
+  used += sz;
+  return reinterpret_cast<void*>(p);
+}
+
+void unpack_arena::reset()
+{
+  cur   = nullptr;
+  pos   = 0;
+  limit = 0;
+  used  = 0;
+}
+
+void unpack_arena::next_block(std::size_t min_size)
+{
+  // Reuse the following block if it is large enough, otherwise insert a new one in front of it
+  block_t* next = cur != nullptr ? cur->next : head;
+  if (next == nullptr or next->size < min_size) {
+    std::size_t size  = std::max(block_size, min_size);
+    block_t*    block = static_cast<block_t*>(::operator new(sizeof(block_t) + size));
+    block->next       = next;
+    block->size       = size;
+    if (cur != nullptr) {
+      cur->next = block;
+    } else {
+      head = block;
+    }
+    next = block;
+  }
+  cur   = next;
+  pos   = reinterpret_cast<uintptr_t>(cur + 1);
+  limit = pos + cur->size;
+}
+
+unpack_arena* get_unpack_arena()
+{
+  return current_unpack_arena;
+}
+
+unpack_arena_scope::unpack_arena_scope(unpack_arena& arena) : prev(current_unpack_arena)
+{
+  current_unpack_arena = &arena;
+}
+
+unpack_arena_scope::unpack_arena_scope(std::nullptr_t) : prev(current_unpack_arena)
+{
+  current_unpack_arena = nullptr;
+}
+
+unpack_arena_scope::~unpack_arena_scope()
+{
+  current_unpack_arena = prev;
+}
+
 /*********************
      ext packing
 *********************/
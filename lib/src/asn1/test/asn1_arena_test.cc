@@ -0,0 +1,268 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/rrc_nr.h"
+#include "srsran/common/test_common.h"
+#include <memory>
+#include <vector>
+
+using namespace asn1;
+using namespace asn1::rrc_nr;
+
+namespace {
+
+using pdu_t = std::vector<uint8_t>;
+
+/// Object with containers nested at two levels, like the extension groups of the generated messages
+struct node_t {
+  dyn_array<uint32_t>    values;
+  ext_array<uint32_t, 2> ext_values;
+  copy_ptr<node_t>       child;
+};
+
+void fill_node(node_t& node, uint32_t seed, uint32_t depth)
+{
+  node.values.resize(16 + seed);
+  for (uint32_t i = 0; i < node.values.size(); ++i) {
+    node.values[i] = seed + i;
+  }
+  for (uint32_t i = 0; i < 8; ++i) {
+    node.ext_values.push_back(seed * i);
+  }
+  if (depth > 0) {
+    node.child.set_present();
+    fill_node(*node.child, seed + 1, depth - 1);
+  }
+}
+
+bool check_node(const node_t& node, uint32_t seed, uint32_t depth)
+{
+  if (node.values.size() != 16 + seed or node.ext_values.size() != 8) {
+    return false;
+  }
+  for (uint32_t i = 0; i < node.values.size(); ++i) {
+    if (node.values[i] != seed + i) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < node.ext_values.size(); ++i) {
+    if (node.ext_values[i] != seed * i) {
+      return false;
+    }
+  }
+  if (depth == 0) {
+    return not node.child.is_present();
+  }
+  return node.child.is_present() and check_node(*node.child, seed + 1, depth - 1);
+}
+
+/// Takes the memory given back by reset() in small pieces, so that every block of the arena is overwritten
+void scribble(unpack_arena& arena)
+{
+  unpack_arena_scope scope(arena);
+  for (uint32_t n = 0; n < 1024; ++n) {
+    dyn_array<uint32_t> junk(8);
+    for (uint32_t i = 0; i < junk.size(); ++i) {
+      junk[i] = 0xdeadbeef;
+    }
+  }
+}
+
+template <class Msg>
+bool pack_msg(const Msg& msg, pdu_t& pdu)
+{
+  pdu.resize(4096);
+  bit_ref bref(pdu.data(), pdu.size());
+  if (msg.pack(bref) != SRSASN_SUCCESS) {
+    return false;
+  }
+  pdu.resize(bref.distance_bytes());
+  return true;
+}
+
+pdu_t make_cell_group_pdu()
+{
+  cell_group_cfg_s cg;
+  cg.cell_group_id = 0;
+  cg.rlc_bearer_to_add_mod_list.resize(2);
+  for (uint32_t i = 0; i < cg.rlc_bearer_to_add_mod_list.size(); ++i) {
+    rlc_bearer_cfg_s& bearer                = cg.rlc_bearer_to_add_mod_list[i];
+    bearer.lc_ch_id                         = i + 1;
+    bearer.served_radio_bearer_present      = true;
+    bearer.served_radio_bearer.set_srb_id() = i + 1;
+  }
+  cg.sp_cell_cfg_present                    = true;
+  cg.sp_cell_cfg.sp_cell_cfg_ded_present    = true;
+  serving_cell_cfg_s& cell                  = cg.sp_cell_cfg.sp_cell_cfg_ded;
+  cell.ul_cfg_present                       = true;
+  cell.ul_cfg.init_ul_bwp_present           = true;
+  cell.ul_cfg.init_ul_bwp.pucch_cfg_present = true;
+  pucch_cfg_s& pucch                        = cell.ul_cfg.init_ul_bwp.pucch_cfg.set_setup();
+  pucch.res_to_add_mod_list.resize(8);
+  for (uint32_t i = 0; i < pucch.res_to_add_mod_list.size(); ++i) {
+    pucch_res_s& res                           = pucch.res_to_add_mod_list[i];
+    res.pucch_res_id                           = i;
+    res.start_prb                              = i;
+    res.format.set_format0().init_cyclic_shift = i % 12;
+  }
+  pucch.dl_data_to_ul_ack.push_back(4);
+
+  pdu_t pdu;
+  pack_msg(cg, pdu);
+  return pdu;
+}
+
+/// The object released from an arena-backed copy_ptr, and every container nested in it, must be on the heap
+int test_release()
+{
+  unpack_arena arena(256);
+
+  copy_ptr<node_t> ptr;
+  {
+    unpack_arena_scope scope(arena);
+    ptr.set_present();
+    fill_node(*ptr, 1, 2);
+  }
+  TESTASSERT(arena.nof_bytes_used() > 0);
+  std::unique_ptr<node_t> released(ptr.release());
+  TESTASSERT(not ptr.is_present());
+
+  arena.reset();
+  scribble(arena);
+  TESTASSERT(check_node(*released, 1, 2));
+
+  // Releasing inside the scope must not copy into the arena either
+  {
+    unpack_arena_scope scope(arena);
+    ptr.set_present();
+    fill_node(*ptr, 3, 1);
+    released.reset(ptr.release());
+  }
+  arena.reset();
+  scribble(arena);
+  TESTASSERT(check_node(*released, 3, 1));
+
+  // Heap-backed objects are handed over as they are
+  ptr.set_present();
+  node_t* raw = ptr.get();
+  released.reset(ptr.release());
+  TESTASSERT(released.get() == raw);
+
+  return SRSRAN_SUCCESS;
+}
+
+/// Objects moved out of the scope keep the arena storage, copies made outside of it get their own
+int test_move_out_of_scope()
+{
+  unpack_arena arena(256);
+  pdu_t        pdu = make_cell_group_pdu();
+  pdu_t        repacked;
+
+  cell_group_cfg_s copy;
+  copy_ptr<node_t> heap_ptr;
+  {
+    cell_group_cfg_s moved;
+    copy_ptr<node_t> moved_ptr;
+    {
+      unpack_arena_scope scope(arena);
+      cell_group_cfg_s   cg;
+      cbit_ref           bref(pdu.data(), pdu.size());
+      TESTASSERT(cg.unpack(bref) == SRSASN_SUCCESS);
+      moved = std::move(cg);
+
+      copy_ptr<node_t> ptr;
+      ptr.set_present();
+      fill_node(*ptr, 5, 2);
+      moved_ptr = std::move(ptr);
+
+      // Every container built on this thread while the scope is open takes arena storage, not only the unpacked ones
+      std::size_t         before = arena.nof_bytes_used();
+      dyn_array<uint32_t> unrelated(64);
+      TESTASSERT(arena.nof_bytes_used() > before);
+    }
+    std::size_t used = arena.nof_bytes_used();
+
+    // Usable until the arena is reset
+    TESTASSERT(pack_msg(moved, repacked) and repacked == pdu);
+    TESTASSERT(check_node(*moved_ptr, 5, 2));
+
+    // Copies made outside of the scope do not take memory from the arena
+    copy     = moved;
+    heap_ptr = moved_ptr;
+    TESTASSERT(arena.nof_bytes_used() == used);
+  }
+
+  // The moved objects are gone before the arena is reset, the copies survive it
+  arena.reset();
+  scribble(arena);
+  TESTASSERT(pack_msg(copy, repacked) and repacked == pdu);
+  TESTASSERT(check_node(*heap_ptr, 5, 2));
+
+  return SRSRAN_SUCCESS;
+}
+
+/// A rewound arena hands out the same memory again to the next message
+int test_reset_and_reuse()
+{
+  unpack_arena arena(256);
+  pdu_t        pdu = make_cell_group_pdu();
+
+  std::size_t used = 0;
+  for (uint32_t i = 0; i < 4; ++i) {
+    {
+      unpack_arena_scope scope(arena);
+      cell_group_cfg_s   cg;
+      cbit_ref           bref(pdu.data(), pdu.size());
+      TESTASSERT(cg.unpack(bref) == SRSASN_SUCCESS);
+      pdu_t repacked;
+      TESTASSERT(pack_msg(cg, repacked) and repacked == pdu);
+    }
+    TESTASSERT(arena.nof_bytes_used() > 0);
+    if (i == 0) {
+      used = arena.nof_bytes_used();
+    }
+    TESTASSERT(arena.nof_bytes_used() == used);
+    arena.reset();
+    TESTASSERT(arena.nof_bytes_used() == 0);
+  }
+
+  // Outside of any scope the containers use the heap
+  TESTASSERT(get_unpack_arena() == nullptr);
+  dyn_array<uint32_t> heap_array(64);
+  TESTASSERT(arena.nof_bytes_used() == 0);
+
+  return SRSRAN_SUCCESS;
+}
+
+} // namespace
+
+int main()
+{
+  srslog::init();
+
+  TESTASSERT(test_release() == SRSRAN_SUCCESS);
+  TESTASSERT(test_move_out_of_scope() == SRSRAN_SUCCESS);
+  TESTASSERT(test_reset_and_reuse() == SRSRAN_SUCCESS);
+
+  srslog::flush();
+  printf("Success\n");
+  return 0;
+}
@@ -0,0 +1,336 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/asn1/rrc_nr.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+/// Decodes a corpus of RRCSetup (including its CellGroupConfig) and SIB1 PDUs with the containers allocating from the
+/// heap, and again with them allocating from an unpack_arena that is rewound after every message.
+
+using namespace asn1;
+using namespace asn1::rrc_nr;
+
+namespace {
+
+using pdu_t = std::vector<uint8_t>;
+
+template <class Msg>
+bool pack_msg(const Msg& msg, pdu_t& pdu)
+{
+  pdu.resize(4096);
+  bit_ref bref(pdu.data(), pdu.size());
+  if (msg.pack(bref) != SRSASN_SUCCESS) {
+    return false;
+  }
+  pdu.resize(bref.distance_bytes());
+  return true;
+}
+
+/// CellGroupConfig in the style of a gNB RRCSetup, with nof_res PUCCH resources and search spaces
+void fill_cell_group(cell_group_cfg_s& cg, uint32_t nof_res)
+{
+  cg.cell_group_id = 0;
+  cg.rlc_bearer_to_add_mod_list.resize(2);
+  for (uint32_t i = 0; i < cg.rlc_bearer_to_add_mod_list.size(); ++i) {
+    rlc_bearer_cfg_s& bearer                = cg.rlc_bearer_to_add_mod_list[i];
+    bearer.lc_ch_id                         = i + 1;
+    bearer.served_radio_bearer_present      = true;
+    bearer.served_radio_bearer.set_srb_id() = i + 1;
+  }
+
+  cg.sp_cell_cfg_present                 = true;
+  cg.sp_cell_cfg.sp_cell_cfg_ded_present = true;
+  serving_cell_cfg_s& cell               = cg.sp_cell_cfg.sp_cell_cfg_ded;
+  cell.init_dl_bwp_present               = true;
+  cell.init_dl_bwp.pdcch_cfg_present     = true;
+  pdcch_cfg_s& pdcch                     = cell.init_dl_bwp.pdcch_cfg.set_setup();
+  pdcch.ctrl_res_set_to_add_mod_list.resize(1);
+  ctrl_res_set_s& coreset = pdcch.ctrl_res_set_to_add_mod_list[0];
+  coreset.ctrl_res_set_id = 1;
+  coreset.freq_domain_res.from_number(0x1ffe0000000ULL);
+  coreset.dur = 1;
+  coreset.cce_reg_map_type.set_non_interleaved();
+  coreset.precoder_granularity.value = ctrl_res_set_s::precoder_granularity_opts::same_as_reg_bundle;
+  pdcch.search_spaces_to_add_mod_list.resize(nof_res);
+  for (uint32_t i = 0; i < nof_res; ++i) {
+    search_space_s& ss                                = pdcch.search_spaces_to_add_mod_list[i];
+    ss.search_space_id                                = i + 2;
+    ss.ctrl_res_set_id_present                        = true;
+    ss.ctrl_res_set_id                                = 1;
+    ss.monitoring_slot_periodicity_and_offset_present = true;
+    ss.monitoring_slot_periodicity_and_offset.set_sl1();
+    ss.monitoring_symbols_within_slot_present = true;
+    ss.monitoring_symbols_within_slot.from_number(0x2000);
+    ss.nrof_candidates_present                   = true;
+    ss.nrof_candidates.aggregation_level1.value  = search_space_s::nrof_candidates_s_::aggregation_level1_opts::n0;
+    ss.nrof_candidates.aggregation_level2.value  = search_space_s::nrof_candidates_s_::aggregation_level2_opts::n2;
+    ss.nrof_candidates.aggregation_level4.value  = search_space_s::nrof_candidates_s_::aggregation_level4_opts::n1;
+    ss.nrof_candidates.aggregation_level8.value  = search_space_s::nrof_candidates_s_::aggregation_level8_opts::n0;
+    ss.nrof_candidates.aggregation_level16.value = search_space_s::nrof_candidates_s_::aggregation_level16_opts::n0;
+    ss.search_space_type_present                 = true;
+    ss.search_space_type.set_ue_specific().dci_formats.value =
+        search_space_s::search_space_type_c_::ue_specific_s_::dci_formats_opts::formats0_minus0_and_minus1_minus0;
+  }
+
+  cell.init_dl_bwp.pdsch_cfg_present = true;
+  pdsch_cfg_s& pdsch                 = cell.init_dl_bwp.pdsch_cfg.set_setup();
+  pdsch.res_alloc.value              = pdsch_cfg_s::res_alloc_opts::res_alloc_type1;
+  pdsch.rbg_size.value               = pdsch_cfg_s::rbg_size_opts::cfg1;
+  pdsch.prb_bundling_type.set_static_bundling();
+  pdsch.pdsch_time_domain_alloc_list_present = true;
+  auto& tdra                                 = pdsch.pdsch_time_domain_alloc_list.set_setup();
+  tdra.resize(4);
+  for (uint32_t i = 0; i < tdra.size(); ++i) {
+    tdra[i].map_type.value       = pdsch_time_domain_res_alloc_s::map_type_opts::type_a;
+    tdra[i].start_symbol_and_len = 40 + i;
+  }
+
+  cell.ul_cfg_present                       = true;
+  cell.ul_cfg.init_ul_bwp_present           = true;
+  cell.ul_cfg.init_ul_bwp.pucch_cfg_present = true;
+  pucch_cfg_s& pucch                        = cell.ul_cfg.init_ul_bwp.pucch_cfg.set_setup();
+  pucch.res_set_to_add_mod_list.resize(2);
+  for (uint32_t i = 0; i < pucch.res_set_to_add_mod_list.size(); ++i) {
+    pucch.res_set_to_add_mod_list[i].pucch_res_set_id = i;
+    for (uint32_t r = 0; r < nof_res && r < 8; ++r) {
+      pucch.res_set_to_add_mod_list[i].res_list.push_back(r);
+    }
+  }
+  pucch.res_to_add_mod_list.resize(nof_res);
+  for (uint32_t i = 0; i < nof_res; ++i) {
+    pucch_res_s& res                           = pucch.res_to_add_mod_list[i];
+    res.pucch_res_id                           = i;
+    res.start_prb                              = i;
+    res.format.set_format0().init_cyclic_shift = i % 12;
+  }
+  pucch.dl_data_to_ul_ack.push_back(4);
+}
+
+void fill_rrc_setup(dl_ccch_msg_s& msg, uint32_t nof_res)
+{
+  rrc_setup_s& setup       = msg.msg.set_c1().set_rrc_setup();
+  setup.rrc_transaction_id = 0;
+  rrc_setup_ies_s& ies     = setup.crit_exts.set_rrc_setup();
+  ies.radio_bearer_cfg.srb_to_add_mod_list.resize(1);
+  ies.radio_bearer_cfg.srb_to_add_mod_list[0].srb_id = 1;
+
+  cell_group_cfg_s cg;
+  fill_cell_group(cg, nof_res);
+  pdu_t cg_pdu;
+  pack_msg(cg, cg_pdu);
+  ies.master_cell_group.resize(cg_pdu.size());
+  std::copy(cg_pdu.begin(), cg_pdu.end(), ies.master_cell_group.data());
+}
+
+void fill_sib1(bcch_dl_sch_msg_s& msg, uint32_t nof_plmns)
+{
+  sib1_s& sib1 = msg.msg.set_c1().set_sib_type1();
+
+  sib1.cell_sel_info_present = true;
+  sib1.cell_access_related_info.plmn_id_list.resize(1);
+  plmn_id_info_s& info = sib1.cell_access_related_info.plmn_id_list[0];
+  info.plmn_id_list.resize(nof_plmns);
+  for (uint32_t i = 0; i < nof_plmns; ++i) {
+    info.plmn_id_list[i].mcc_present = true;
+    info.plmn_id_list[i].mcc         = {0, 0, 1};
+    info.plmn_id_list[i].mnc.resize(2);
+    info.plmn_id_list[i].mnc[0] = 0;
+    info.plmn_id_list[i].mnc[1] = i % 10;
+  }
+  info.tac_present = true;
+  info.tac.from_number(7);
+  info.cell_id.from_number(0x19b01);
+  info.cell_reserved_for_oper.value = plmn_id_info_s::cell_reserved_for_oper_opts::not_reserved;
+
+  sib1.si_sched_info_present = true;
+  sib1.si_sched_info.sched_info_list.resize(2);
+  for (uint32_t i = 0; i < sib1.si_sched_info.sched_info_list.size(); ++i) {
+    sched_info_s& sched             = sib1.si_sched_info.sched_info_list[i];
+    sched.si_broadcast_status.value = sched_info_s::si_broadcast_status_opts::broadcasting;
+    sched.si_periodicity.value      = sched_info_s::si_periodicity_opts::rf16;
+    sched.sib_map_info.resize(1);
+    sched.sib_map_info[0].type.value = (sib_type_info_s::type_opts::options)i;
+  }
+  sib1.si_sched_info.si_win_len.value = si_sched_info_s::si_win_len_opts::s20;
+
+  sib1.serving_cell_cfg_common_present = true;
+  serving_cell_cfg_common_sib_s& cell  = sib1.serving_cell_cfg_common;
+  freq_info_dl_sib_s&            freq  = cell.dl_cfg_common.freq_info_dl;
+  freq.freq_band_list.resize(1);
+  freq.freq_band_list[0].freq_band_ind_nr_present = true;
+  freq.freq_band_list[0].freq_band_ind_nr         = 78;
+  freq.scs_specific_carrier_list.resize(1);
+  freq.scs_specific_carrier_list[0].subcarrier_spacing.value = subcarrier_spacing_opts::khz30;
+  freq.scs_specific_carrier_list[0].carrier_bw               = 106;
+
+  bwp_dl_common_s& bwp                        = cell.dl_cfg_common.init_dl_bwp;
+  bwp.generic_params.location_and_bw          = 28875;
+  bwp.generic_params.subcarrier_spacing.value = subcarrier_spacing_opts::khz30;
+  bwp.pdcch_cfg_common_present                = true;
+  pdcch_cfg_common_s& pdcch                   = bwp.pdcch_cfg_common.set_setup();
+  pdcch.ctrl_res_set_zero_present             = true;
+  pdcch.search_space_zero_present             = true;
+  pdcch.ra_search_space_present               = true;
+  pdcch.ra_search_space                       = 1;
+  pdcch.common_search_space_list.resize(1);
+  search_space_s& ss                                = pdcch.common_search_space_list[0];
+  ss.search_space_id                                = 1;
+  ss.ctrl_res_set_id_present                        = true;
+  ss.monitoring_slot_periodicity_and_offset_present = true;
+  ss.monitoring_slot_periodicity_and_offset.set_sl1();
+  ss.search_space_type_present                                                    = true;
+  ss.search_space_type.set_common().dci_format0_minus0_and_format1_minus0_present = true;
+
+  bwp.pdsch_cfg_common_present             = true;
+  pdsch_time_domain_res_alloc_list_l& tdra = bwp.pdsch_cfg_common.set_setup().pdsch_time_domain_alloc_list;
+  tdra.resize(2);
+  for (uint32_t i = 0; i < tdra.size(); ++i) {
+    tdra[i].map_type.value       = pdsch_time_domain_res_alloc_s::map_type_opts::type_a;
+    tdra[i].start_symbol_and_len = 40 + i;
+  }
+  cell.dl_cfg_common.bcch_cfg.mod_period_coeff.value     = bcch_cfg_s::mod_period_coeff_opts::n4;
+  cell.dl_cfg_common.pcch_cfg.default_paging_cycle.value = paging_cycle_opts::rf128;
+  cell.dl_cfg_common.pcch_cfg.nand_paging_frame_offset.set_one_t();
+  cell.dl_cfg_common.pcch_cfg.ns.value = pcch_cfg_s::ns_opts::one;
+
+  cell.ssb_positions_in_burst.in_one_group.from_number(0x80);
+  cell.ssb_periodicity_serving_cell.value = serving_cell_cfg_common_sib_s::ssb_periodicity_serving_cell_opts::ms20;
+}
+
+/// Unpacks one PDU, and the CellGroupConfig carried by an RRCSetup. If "check" is set, the decoded messages are packed
+/// again and compared with the originals.
+bool decode(const pdu_t& pdu, bool is_sib1, bool check = false)
+{
+  pdu_t    repacked;
+  cbit_ref bref(pdu.data(), pdu.size());
+  if (is_sib1) {
+    bcch_dl_sch_msg_s msg;
+    if (msg.unpack(bref) != SRSASN_SUCCESS) {
+      return false;
+    }
+    return not check or (pack_msg(msg, repacked) and repacked == pdu);
+  }
+  dl_ccch_msg_s msg;
+  if (msg.unpack(bref) != SRSASN_SUCCESS) {
+    return false;
+  }
+  const dyn_octstring& mcg = msg.msg.c1().rrc_setup().crit_exts.rrc_setup().master_cell_group;
+  cell_group_cfg_s     cg;
+  cbit_ref             cg_bref(mcg.data(), mcg.size());
+  if (cg.unpack(cg_bref) != SRSASN_SUCCESS) {
+    return false;
+  }
+  if (not check) {
+    return true;
+  }
+  pdu_t cg_repacked;
+  return pack_msg(msg, repacked) and repacked == pdu and pack_msg(cg, cg_repacked) and
+         cg_repacked == pdu_t(mcg.data(), mcg.data() + mcg.size());
+}
+
+double run(const std::vector<pdu_t>& corpus, const std::vector<bool>& is_sib1, unpack_arena* arena, unsigned nof_iter)
+{
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned it = 0; it != nof_iter; ++it) {
+    for (size_t i = 0; i != corpus.size(); ++i) {
+      bool ok;
+      if (arena != nullptr) {
+        unpack_arena_scope scope(*arena);
+        ok = decode(corpus[i], is_sib1[i]);
+        arena->reset();
+      } else {
+        ok = decode(corpus[i], is_sib1[i]);
+      }
+      if (not ok) {
+        std::printf("Failed to decode PDU %zu\n", i);
+        std::exit(EXIT_FAILURE);
+      }
+    }
+  }
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return elapsed * 1e9 / (nof_iter * corpus.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  // Passes over the corpus in each round.
+  unsigned nof_iter = (argc > 1) ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 2000;
+
+  std::vector<pdu_t> corpus;
+  std::vector<bool>  is_sib1;
+  size_t             nof_bytes = 0;
+  for (uint32_t n = 1; n <= 8; ++n) {
+    dl_ccch_msg_s setup;
+    fill_rrc_setup(setup, n);
+    bcch_dl_sch_msg_s sib1;
+    fill_sib1(sib1, n);
+
+    corpus.emplace_back();
+    is_sib1.push_back(false);
+    if (not pack_msg(setup, corpus.back())) {
+      std::printf("Failed to pack RRCSetup\n");
+      return EXIT_FAILURE;
+    }
+    corpus.emplace_back();
+    is_sib1.push_back(true);
+    if (not pack_msg(sib1, corpus.back())) {
+      std::printf("Failed to pack SIB1\n");
+      return EXIT_FAILURE;
+    }
+  }
+  for (const pdu_t& pdu : corpus) {
+    nof_bytes += pdu.size();
+  }
+
+  // Messages decoded from the arena must match the ones decoded from the heap
+  unpack_arena arena;
+  for (size_t i = 0; i != corpus.size(); ++i) {
+    unpack_arena_scope scope(arena);
+    if (not decode(corpus[i], is_sib1[i], true)) {
+      std::printf("PDU %zu does not survive an unpack/pack round trip\n", i);
+      return EXIT_FAILURE;
+    }
+  }
+  arena.reset();
+
+  // Alternate both modes and keep the best round of each, to filter out the noise of other processes
+  double heap_ns  = std::numeric_limits<double>::max();
+  double arena_ns = std::numeric_limits<double>::max();
+  for (unsigned round = 0; round != 5; ++round) {
+    heap_ns  = std::min(heap_ns, run(corpus, is_sib1, nullptr, nof_iter));
+    arena_ns = std::min(arena_ns, run(corpus, is_sib1, &arena, nof_iter));
+  }
+  std::printf("%zu PDUs, %zu bytes: heap %.0f ns/PDU, arena %.0f ns/PDU (%.2fx)\n",
+              corpus.size(),
+              nof_bytes,
+              heap_ns,
+              arena_ns,
+              heap_ns / arena_ns);
+
+  return 0;
+}
@@ -21,10 +21,13 @@
 
 #include "srsran/srsran.h"
 #include <complex.h>
+#include <fcntl.h>
 #include <fftw3.h>
 #include <math.h>
 #include <pwd.h>
 #include <string.h>
+#include <sys/file.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "srsran/phy/dft/dft.h"
@@ -35,8 +38,16 @@
 
 #define FFTW_WISDOM_FILE "%s/.srsran_fftwisdom"
 
+// Overrides the wisdom file path
+#define FFTW_WISDOM_ENV "SRSRAN_FFTW_WISDOM"
+
 static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 {
+  const char* path = getenv(FFTW_WISDOM_ENV);
+  if (path != NULL && path[0] != '\0') {
+    return snprintf(full_path, n, "%s", path);
+  }
+
   const char* homedir = NULL;
   if ((homedir = getenv("HOME")) == NULL) {
     homedir = getpwuid(getuid())->pw_dir;
@@ -53,58 +64,183 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-// This function is called in the beggining of any executable where it is linked
-__attribute__((constructor)) static void srsran_dft_load()
+// Wisdom file, guarded by fft_mutex
+static char wisdom_path[256] = {};
+
+// Planning statistics, guarded by fft_mutex
+static uint32_t plan_count  = 0;
+static double   plan_time_s = 0.0;
+
+static struct timespec plan_tic(void)
 {
-#ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  // lockf needs a file descriptor open for writing, so this must be r+
-  FILE* fd = fopen(full_path, "r+");
+  struct timespec t = {};
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t;
+}
+
+static void plan_toc(struct timespec t0)
+{
+  struct timespec t1 = plan_tic();
+  plan_count++;
+  plan_time_s += (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+}
+
+// Writers replace the file atomically, so it can be read without locking
+static int wisdom_import(const char* path)
+{
+  FILE* fd = fopen(path, "r");
   if (fd == NULL) {
-    return;
+    return SRSRAN_ERROR;
   }
-  if (lockf(fileno(fd), F_LOCK, 0) == -1) {
-    perror("lockf()");
-    fclose(fd);
-    return;
+  int ret = fftwf_import_wisdom_from_file(fd) ? SRSRAN_SUCCESS : SRSRAN_ERROR;
+  fclose(fd);
+  return ret;
+}
+
+static int wisdom_write(const char* path)
+{
+  char tmp_path[sizeof(wisdom_path) + 32];
+  snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%d", path, (int)getpid());
+  FILE* fd = fopen(tmp_path, "w");
+  if (fd == NULL) {
+    return SRSRAN_ERROR;
   }
-  fftwf_import_wisdom_from_file(fd);
-  if (lockf(fileno(fd), F_ULOCK, 0) == -1) {
-    perror("u-lockf()");
-    fclose(fd);
-    return;
+  fftwf_export_wisdom_to_file(fd);
+  bool ok = !ferror(fd);
+
+  // A reader sees either the old file or the complete new one
+  if (fclose(fd) != 0 || !ok || rename(tmp_path, path) != 0) {
+    unlink(tmp_path);
+    return SRSRAN_ERROR;
   }
-  fclose(fd);
+  return SRSRAN_SUCCESS;
+}
+
+// Merges the file content into the current wisdom and replaces the file with the result. Writers serialize on a lock
+// file next to the wisdom file, since the rename replaces the wisdom file itself, so that none of them discards the
+// wisdom another one stored between its merge and its rename.
+static int wisdom_export(const char* path)
+{
+  char lock_path[sizeof(wisdom_path) + 8];
+  snprintf(lock_path, sizeof(lock_path), "%s.lock", path);
+  int lock_fd = open(lock_path, O_RDWR | O_CREAT, 0644);
+  if (lock_fd < 0) {
+    perror("open()");
+    return SRSRAN_ERROR;
+  }
+  if (flock(lock_fd, LOCK_EX) == -1) {
+    perror("flock()");
+    close(lock_fd);
+    return SRSRAN_ERROR;
+  }
+
+  // Keep what other processes stored since this one started
+  wisdom_import(path);
+  int ret = wisdom_write(path);
+
+  flock(lock_fd, LOCK_UN);
+  close(lock_fd);
+  return ret;
+}
+
+// This function is called in the beggining of any executable where it is linked
+__attribute__((constructor)) static void srsran_dft_load()
+{
+#ifdef FFTW_WISDOM_FILE
+  get_fftw_wisdom_file(wisdom_path, sizeof(wisdom_path));
+  wisdom_import(wisdom_path);
 #else
   printf("Warning: FFTW Wisdom file not defined\n");
 #endif
 }
 
-// This function is called in the ending of any executable where it is linked
+// This function is called in the ending of any executable where it is linked. The wisdom file is read-only at runtime,
+// it is only written by srsran_dft_wisdom_export().
 __attribute__((destructor)) void srsran_dft_exit()
 {
-#ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  FILE* fd = fopen(full_path, "w");
-  if (fd == NULL) {
-    return;
+  fftwf_cleanup();
+}
+
+int srsran_dft_wisdom_set_file(const char* path)
+{
+  if (path == NULL || strlen(path) >= sizeof(wisdom_path)) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
   }
-  if (lockf(fileno(fd), F_LOCK, 0) == -1) {
-    perror("lockf()");
-    fclose(fd);
-    return;
+
+  pthread_mutex_lock(&fft_mutex);
+  snprintf(wisdom_path, sizeof(wisdom_path), "%s", path);
+  wisdom_import(wisdom_path);
+  pthread_mutex_unlock(&fft_mutex);
+
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_dft_wisdom_export(void)
+{
+  pthread_mutex_lock(&fft_mutex);
+  int ret = wisdom_export(wisdom_path);
+  pthread_mutex_unlock(&fft_mutex);
+
+  if (ret < SRSRAN_SUCCESS) {
+    ERROR("Error writing FFTW wisdom to %s", wisdom_path);
   }
-  fftwf_export_wisdom_to_file(fd);
-  if (lockf(fileno(fd), F_ULOCK, 0) == -1) {
-    perror("u-lockf()");
-    fclose(fd);
-    return;
+  return ret;
+}
+
+int srsran_dft_precompute(const uint32_t* sizes, uint32_t nof_sizes, uint32_t how_many)
+{
+  if (sizes == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
   }
-  fclose(fd);
-#endif
-  fftwf_cleanup();
+  how_many = SRSRAN_MAX(how_many, 1);
+
+  for (uint32_t i = 0; i < nof_sizes; i++) {
+    // Batches are planned out of place on aligned buffers like the callers' ones, alignment is part of the problem
+    cf_t* in  = srsran_vec_cf_malloc(sizes[i] * how_many);
+    cf_t* out = srsran_vec_cf_malloc(sizes[i] * how_many);
+    if (in == NULL || out == NULL) {
+      free(in);
+      free(out);
+      return SRSRAN_ERROR;
+    }
+
+    int ret = SRSRAN_SUCCESS;
+    for (int d = 0; d < 2 && ret == SRSRAN_SUCCESS; d++) {
+      srsran_dft_dir_t  dir  = (d == 0) ? SRSRAN_DFT_FORWARD : SRSRAN_DFT_BACKWARD;
+      srsran_dft_plan_t plan = {};
+      if (how_many == 1) {
+        ret = srsran_dft_plan_c(&plan, (int)sizes[i], dir);
+      } else {
+        ret = srsran_dft_plan_guru_c(
+            &plan, (int)sizes[i], dir, in, out, 1, 1, (int)how_many, (int)sizes[i], (int)sizes[i]);
+      }
+      if (ret == SRSRAN_SUCCESS) {
+        srsran_dft_plan_free(&plan);
+      } else {
+        ERROR("Error planning DFT of size %u (x%u)", sizes[i], how_many);
+      }
+    }
+
+    free(in);
+    free(out);
+    if (ret < SRSRAN_SUCCESS) {
+      return ret;
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
+void srsran_dft_get_plan_stats(uint32_t* nof_plans, double* time_s)
+{
+  pthread_mutex_lock(&fft_mutex);
+  if (nof_plans != NULL) {
+    *nof_plans = plan_count;
+  }
+  if (time_s != NULL) {
+    *time_s = plan_time_s;
+  }
+  pthread_mutex_unlock(&fft_mutex);
 }
 
 int srsran_dft_plan(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_dir_t dir, srsran_dft_mode_t mode)
@@ -161,7 +297,9 @@ int srsran_dft_replan_guru_c(srsran_dft_plan_t* plan,
   /* Destroy current plan */
   fftwf_destroy_plan(plan->p);
 
+  struct timespec t0 = plan_tic();
   plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  plan_toc(t0);
 
   pthread_mutex_unlock(&fft_mutex);
 
@@ -188,7 +326,9 @@ int srsran_dft_replan_c(srsran_dft_plan_t* plan, const int new_dft_points)
     fftwf_destroy_plan(plan->p);
     plan->p = NULL;
   }
+  struct timespec t0 = plan_tic();
   plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan_toc(t0);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -216,7 +356,9 @@ int srsran_dft_plan_guru_c(srsran_dft_plan_t* plan,
 
   pthread_mutex_lock(&fft_mutex);
 
+  struct timespec t0 = plan_tic();
   plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  plan_toc(t0);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -244,7 +386,9 @@ int srsran_dft_plan_c(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
   pthread_mutex_lock(&fft_mutex);
 
   int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  struct timespec t0 = plan_tic();
   plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan_toc(t0);
 
   pthread_mutex_unlock(&fft_mutex);
 
@@ -274,7 +418,9 @@ int srsran_dft_replan_r(srsran_dft_plan_t* plan, const int new_dft_points)
     fftwf_destroy_plan(plan->p);
     plan->p = NULL;
   }
+  struct timespec t0 = plan_tic();
   plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan_toc(t0);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -290,7 +436,9 @@ int srsran_dft_plan_r(srsran_dft_plan_t* plan, const int dft_points, srsran_dft_
   int sign = (dir == SRSRAN_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
   pthread_mutex_lock(&fft_mutex);
+  struct timespec t0 = plan_tic();
   plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan_toc(t0);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -22,11 +22,26 @@
 #include "srsran/phy/fec/crc.h"
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+
+#include <string.h>
 
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif // LV_HAVE_SSE
 
+// The folding engine is built for any x86-64 target and only selected at run time when the CPU has PCLMULQDQ
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CRC_HAVE_PCLMUL
+#include <immintrin.h>
+#endif // defined(__x86_64__) && defined(__GNUC__)
+
+// Bits packed and checksummed at a time, multiple of 128
+#define CRC_CHUNK_BITS 4096
+
+// Below this many bytes folding does not pay off its final reduction
+#define CRC_FOLD_MIN_BYTES 64
+
 static void gen_crc_table(srsran_crc_t* h)
 {
   uint32_t pad        = (h->order < 8) ? (8 - h->order) : 0;
@@ -47,17 +62,163 @@ static void gen_crc_table(srsran_crc_t* h)
   }
 }
 
-uint64_t reversecrcbit(uint32_t crc, int nbits, srsran_crc_t* h)
+// Multiplies an aligned register by x modulo the aligned polynomial q
+static inline uint32_t crc_mulx(uint32_t crc, uint32_t q)
 {
-  uint64_t m, rmask = 0x1;
+  return (crc & 0x80000000U) ? ((crc << 1U) ^ q) : (crc << 1U);
+}
+
+static void gen_crc_engine(srsran_crc_t* h)
+{
+  // A CRC of order n with polynomial P is the CRC of order 32 with P * x^(32 - n), shifted right by 32 - n
+  uint32_t shift = 32U - (uint32_t)h->order;
+  uint32_t q     = (uint32_t)(((uint64_t)h->polynom << shift) & 0xffffffffU);
 
-  for (m = 0; m < nbits; m++) {
-    if ((rmask & crc) == 0x01)
-      crc = (crc ^ h->polynom) >> 1;
-    else
-      crc = crc >> 1;
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i << 24U;
+    for (uint32_t j = 0; j < 8; j++) {
+      crc = crc_mulx(crc, q);
+    }
+    h->table8[0][i] = crc;
+  }
+  for (uint32_t k = 1; k < 8; k++) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t prev    = h->table8[k - 1][i];
+      h->table8[k][i] = (prev << 8U) ^ h->table8[0][prev >> 24U];
+    }
+  }
+
+  // x^n mod Q, starting from x^31
+  const uint32_t exps[4] = {192, 128, 576, 512};
+  for (uint32_t k = 0; k < 4; k++) {
+    uint32_t r = 0x80000000U;
+    for (uint32_t e = 31; e < exps[k]; e++) {
+      r = crc_mulx(r, q);
+    }
+    h->fold[k] = r;
+  }
+
+#ifdef CRC_HAVE_PCLMUL
+  __builtin_cpu_init();
+  h->use_pclmul = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+#else  /* CRC_HAVE_PCLMUL */
+  h->use_pclmul = false;
+#endif /* CRC_HAVE_PCLMUL */
+}
+
+static inline uint32_t crc_update_byte(const srsran_crc_t* h, uint32_t crc, uint8_t byte)
+{
+  return (crc << 8U) ^ h->table8[0][(crc >> 24U) ^ byte];
+}
+
+static uint32_t crc_update_slice8(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+  const uint32_t(*t)[256] = h->table8;
+
+  for (; len >= 8; len -= 8, data += 8) {
+    uint32_t x = crc ^ (((uint32_t)data[0] << 24U) | ((uint32_t)data[1] << 16U) | ((uint32_t)data[2] << 8U) | data[3]);
+    crc        = t[7][x >> 24U] ^ t[6][(x >> 16U) & 0xffU] ^ t[5][(x >> 8U) & 0xffU] ^ t[4][x & 0xffU] ^ t[3][data[4]] ^
+          t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+  }
+  for (; len > 0; len--, data++) {
+    crc = crc_update_byte(h, crc, *data);
+  }
+  return crc;
+}
+
+#ifdef CRC_HAVE_PCLMUL
+// Multiplies the halves of x by the constants in k and adds the products, i.e. moves x forward by the constants' span
+__attribute__((target("pclmul,sse4.1"))) static inline __m128i crc_fold_128(__m128i x, __m128i k)
+{
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00));
+}
+
+/*
+ * Carry-less multiplication folding (Intel, "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ").
+ * Four 128-bit accumulators move 512 bits forward per step, they are then folded into one, whose remainder is
+ * computed with the tables. Blocks are byte-swapped so that the first transmitted bit is the polynomial MSB.
+ */
+__attribute__((target("pclmul,sse4.1"))) static uint32_t
+crc_update_pclmul(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+  const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+  const __m128i k128  = _mm_set_epi64x((long long)h->fold[0], (long long)h->fold[1]);
+  const __m128i k512  = _mm_set_epi64x((long long)h->fold[2], (long long)h->fold[3]);
+
+  __m128i x[4];
+  for (uint32_t i = 0; i < 4; i++) {
+    x[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[16 * i]), bswap);
+  }
+  x[0] = _mm_xor_si128(x[0], _mm_set_epi32((int)crc, 0, 0, 0));
+  data += 64;
+  len -= 64;
+
+  for (; len >= 64; len -= 64, data += 64) {
+    for (uint32_t i = 0; i < 4; i++) {
+      __m128i next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)&data[16 * i]), bswap);
+      x[i]         = _mm_xor_si128(crc_fold_128(x[i], k512), next);
+    }
+  }
+
+  __m128i acc = x[0];
+  for (uint32_t i = 1; i < 4; i++) {
+    acc = _mm_xor_si128(crc_fold_128(acc, k128), x[i]);
+  }
+  for (; len >= 16; len -= 16, data += 16) {
+    __m128i next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)data), bswap);
+    acc          = _mm_xor_si128(crc_fold_128(acc, k128), next);
+  }
+
+  // The accumulator is congruent to the data so far, its CRC is the register
+  uint8_t rem[16];
+  _mm_storeu_si128((__m128i*)rem, _mm_shuffle_epi8(acc, bswap));
+  crc = crc_update_slice8(h, 0, rem, 16);
+
+  return crc_update_slice8(h, crc, data, len);
+}
+#endif /* CRC_HAVE_PCLMUL */
+
+static uint32_t crc_update(const srsran_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+#ifdef CRC_HAVE_PCLMUL
+  if (h->use_pclmul && len >= CRC_FOLD_MIN_BYTES) {
+    return crc_update_pclmul(h, crc, data, len);
+  }
+#endif /* CRC_HAVE_PCLMUL */
+  return crc_update_slice8(h, crc, data, len);
+}
+
+// Packs 8 * nof_bytes bits, first bit in the MSB of each byte
+static void crc_pack(const uint8_t* bits, uint8_t* bytes, uint32_t nof_bytes)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  // Reverse every group of 8 bits so that the first one lands in the mask MSB
+  const __m256i reverse = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 4 <= nof_bytes; i += 4) {
+    __m256i v    = _mm256_loadu_si256((const __m256i*)&bits[8 * i]);
+    v            = _mm256_cmpgt_epi8(_mm256_shuffle_epi8(v, reverse), _mm256_setzero_si256());
+    uint32_t msk = (uint32_t)_mm256_movemask_epi8(v);
+    memcpy(&bytes[i], &msk, sizeof(msk));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i reverse128 = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 2 <= nof_bytes; i += 2) {
+    __m128i v    = _mm_loadu_si128((const __m128i*)&bits[8 * i]);
+    v            = _mm_cmpgt_epi8(_mm_shuffle_epi8(v, reverse128), _mm_setzero_si128());
+    uint16_t msk = (uint16_t)_mm_movemask_epi8(v);
+    memcpy(&bytes[i], &msk, sizeof(msk));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < nof_bytes; i++) {
+    uint8_t* ptr = (uint8_t*)&bits[8 * i];
+    bytes[i]     = (uint8_t)(srsran_bit_pack(&ptr, 8) & 0xFF);
   }
-  return (crc & h->crcmask);
 }
 
 int srsran_crc_set_init(srsran_crc_t* crc_par, uint64_t crc_init_value)
@@ -72,6 +233,11 @@ int srsran_crc_set_init(srsran_crc_t* crc_par, uint64_t crc_init_value)
 
 int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
 {
+  if (crc_order < 1 || crc_order > 32) {
+    ERROR("Invalid CRC order %d", crc_order);
+    return -1;
+  }
+
   // Set crc working default parameters
   h->polynom = crc_poly;
   h->order   = crc_order;
@@ -88,57 +254,38 @@ int srsran_crc_init(srsran_crc_t* h, uint32_t crc_poly, int crc_order)
 
   // generate lookup table
   gen_crc_table(h);
+  gen_crc_engine(h);
 
   return 0;
 }
 
 uint32_t srsran_crc_checksum(srsran_crc_t* h, uint8_t* data, int len)
 {
-  int      i, k, len8, res8, a = 0;
+  uint8_t  packed[CRC_CHUNK_BITS / 8];
   uint32_t crc = 0;
-  uint8_t* pter;
-
-  srsran_crc_set_init(h, 0);
 
-  // Pack bits into bytes
-  len8 = (len >> 3);
-  res8 = (len - (len8 << 3));
-  if (res8 > 0) {
-    a = 1;
+  if (len < 0) {
+    return 0;
   }
 
-  // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
-    pter = (uint8_t*)(data + 8 * i);
-    uint8_t byte;
-    if (i == len8) {
-      byte = 0x00;
-      for (k = 0; k < res8; k++) {
-        byte |= ((uint8_t) * (pter + k)) << (7 - k);
-      }
-    } else {
-#ifdef LV_HAVE_SSE
-      // Get 8 Bit
-      __m64 mask = _mm_cmpgt_pi8(*((__m64*)pter), _mm_set1_pi8(0));
-
-      // Reverse
-      mask = _mm_shuffle_pi8(mask, _mm_set_pi8(0, 1, 2, 3, 4, 5, 6, 7));
-
-      // Get mask and write
-      byte = (uint8_t)_mm_movemask_pi8(mask);
-#else  /* LV_HAVE_SSE */
-      byte = (uint8_t)(srsran_bit_pack(&pter, 8) & 0xFF);
-#endif /* LV_HAVE_SSE */
-    }
-    srsran_crc_checksum_put_byte(h, byte);
+  // Whole bytes, packed and checksummed chunk by chunk
+  uint32_t nof_bytes = (uint32_t)len / 8;
+  for (uint32_t i = 0; i < nof_bytes;) {
+    uint32_t n = SRSRAN_MIN(nof_bytes - i, (uint32_t)sizeof(packed));
+    crc_pack(&data[8 * i], packed, n);
+    crc = crc_update(h, crc, packed, n);
+    i += n;
   }
-  crc = (uint32_t)srsran_crc_checksum_get(h);
 
-  // Reverse CRC res8 positions
-  if (a == 1) {
-    crc = reversecrcbit(crc, 8 - res8, h);
+  // Remaining bits one at a time
+  uint32_t q = (uint32_t)(((uint64_t)h->polynom << (32U - h->order)) & 0xffffffffU);
+  for (uint32_t i = nof_bytes * 8; i < (uint32_t)len; i++) {
+    crc ^= (uint32_t)(data[i] > 0) << 31U;
+    crc = crc_mulx(crc, q);
   }
 
+  crc >>= (32U - h->order);
+
   // Return CRC value
   return crc;
 }
@@ -33,9 +33,11 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "srsran/phy/fec/ldpc/ldpc_common.h" //FILLER_BIT definition
 #include "srsran/phy/fec/ldpc/ldpc_rm.h"
+#include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 
 #include "srsran/phy/utils/debug.h"
@@ -87,24 +89,21 @@ struct pRM_tx {
  * \brief Describes an rate dematcher (float version).
  */
 struct pRM_rx_f {
-  float*    tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
-  uint32_t* indices;       /*!< \brief Pointer to a temporal buffer with the indices for bit-selection. */
+  float* tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
 };
 
 /*!
  * \brief Describes an rate dematcher (short version).
  */
 struct pRM_rx_s {
-  int16_t*  tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
-  uint32_t* indices;       /*!< \brief Pointer to a temporal buffer with the indices for bit-selection. */
+  int16_t* tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
 };
 
 /*!
  * \brief Describes an rate dematcher (char version).
  */
 struct pRM_rx_c {
-  int8_t*   tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
-  uint32_t* indices;       /*!< \brief Pointer to a temporal buffer with the indices for bit-selection. */
+  int8_t* tmp_rm_symbol; /*!< \brief Pointer to a temporal buffer between bit-selection and interleaver. */
 };
 
 /*!
@@ -166,6 +165,32 @@ static int init_rm(srsran_ldpc_rm_t*  p,
   return 0;
 }
 
+/*!
+ * Bit selection reads the circular buffer from k0, wrapping at Ncb and skipping the filler bits
+ * [ini_exclude, end_exclude). The read is split into runs of consecutive buffer positions, so that bits can be copied
+ * or combined a run at a time instead of through a per-bit index list. Moves *pos to the start of the next run and
+ * returns its length, never more than the remaining bits.
+ */
+static inline uint32_t bit_selection_run(uint32_t*      pos,
+                                         const uint32_t remaining,
+                                         const uint32_t ini_exclude,
+                                         const uint32_t end_exclude,
+                                         const uint32_t Ncb)
+{
+  while (true) {
+    if (*pos >= Ncb) {
+      *pos = 0;
+    } else if (*pos >= ini_exclude && *pos < end_exclude) {
+      *pos = end_exclude;
+    } else {
+      break;
+    }
+  }
+
+  uint32_t run_end = (*pos < ini_exclude) ? SRSRAN_MIN(ini_exclude, Ncb) : Ncb;
+  return SRSRAN_MIN(run_end - *pos, remaining);
+}
+
 /*!
  * Bit selection for the rate-matching block. Selects out_len bits, starting from
  * the k0th, ingoring filler bits, and consider an input buffer of length Ncb.
@@ -178,18 +203,26 @@ static void bit_selection_rm_tx(const uint8_t* input,
 {
   uint32_t E = out_len;
 
-  uint32_t k    = 0;
-  uint32_t j    = 0;
-  uint32_t icwd = 0;
+  // The encoder places all filler bits in a single block at the end of the systematic part
+  uint32_t       ini_exclude = Ncb;
+  uint32_t       end_exclude = Ncb;
+  const uint8_t* filler      = memchr(input, FILLER_BIT, Ncb);
+  if (filler != NULL) {
+    ini_exclude = (uint32_t)(filler - input);
+    end_exclude = ini_exclude;
+    while (end_exclude < Ncb && input[end_exclude] == FILLER_BIT) {
+      end_exclude++;
+    }
+  }
 
+  uint32_t k    = 0;
+  uint32_t icwd = k0;
   while (k < E) {
-    icwd = (k0 + j) % Ncb;
-    if (input[icwd] != FILLER_BIT) {
-      output[k] = input[icwd];
-      k         = k + 1;
-    }
-    j = j + 1;
-  } // while
+    uint32_t len = bit_selection_run(&icwd, E - k, ini_exclude, end_exclude, Ncb);
+    srsran_vec_u8_copy(&output[k], &input[icwd], len);
+    k += len;
+    icwd += len;
+  }
 }
 
 /*!
@@ -203,7 +236,6 @@ static void bit_selection_rm_tx(const uint8_t* input,
 static void bit_selection_rm_rx(const float*   input,
                                 const uint32_t in_len,
                                 float*         output,
-                                uint32_t*      indices,
                                 const uint32_t ini_exclude,
                                 const uint32_t end_exclude,
                                 const uint32_t k0,
@@ -211,26 +243,60 @@ static void bit_selection_rm_rx(const float*   input,
 {
   uint32_t E = in_len;
 
-  uint32_t k    = 0;
-  uint32_t j    = 0;
-  uint32_t icwd = 0;
-  while (k < E) {
-    icwd = (k0 + j) % Ncb;
-    if (!(icwd >= ini_exclude && icwd < end_exclude)) { // avoid filler bits
-      indices[k] = icwd;
-      k          = k + 1;
-    }
-    j = j + 1;
-  } // while
-
   // set filler bits to INFINITY
   for (uint32_t i = ini_exclude; i < end_exclude; i++) {
     output[i] = INFINITY;
   }
 
   // Add soft bits, in case of repetition
-  for (uint32_t i = 0; i < E; i++) {
-    output[indices[i]] = output[indices[i]] + input[i];
+  uint32_t k    = 0;
+  uint32_t icwd = k0;
+  while (k < E) {
+    uint32_t len = bit_selection_run(&icwd, E - k, ini_exclude, end_exclude, Ncb);
+    srsran_vec_sum_fff(&output[icwd], &input[k], &output[icwd], len);
+    k += len;
+    icwd += len;
+  }
+}
+
+/*!
+ * Adds len soft bits to output, saturating at +/- infinity15.
+ */
+static void bit_combine_s(int16_t* output, const int16_t* input, const uint32_t len, const int16_t infinity15)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  __m256i max256 = _mm256_set1_epi16(infinity15);
+  __m256i min256 = _mm256_set1_epi16(-infinity15);
+  for (; i + 16 <= len; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)&output[i]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)&input[i]);
+    __m256i r = _mm256_min_epi16(_mm256_max_epi16(_mm256_adds_epi16(a, b), min256), max256);
+    _mm256_storeu_si256((__m256i*)&output[i], r);
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  __m128i max128 = _mm_set1_epi16(infinity15);
+  __m128i min128 = _mm_set1_epi16(-infinity15);
+  for (; i + 8 <= len; i += 8) {
+    __m128i a = _mm_loadu_si128((const __m128i*)&output[i]);
+    __m128i b = _mm_loadu_si128((const __m128i*)&input[i]);
+    __m128i r = _mm_min_epi16(_mm_max_epi16(_mm_adds_epi16(a, b), min128), max128);
+    _mm_storeu_si128((__m128i*)&output[i], r);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    long tmp = (long)output[i] + input[i];
+    if (tmp > infinity15) {
+      tmp = infinity15;
+    }
+    if (tmp < -infinity15) {
+      tmp = -infinity15;
+    }
+    output[i] = (int16_t)tmp;
   }
 }
 
@@ -245,7 +311,6 @@ static void bit_selection_rm_rx(const float*   input,
 static void bit_selection_rm_rx_s(const int16_t* input,
                                   const uint32_t in_len,
                                   int16_t*       output,
-                                  uint32_t*      indices,
                                   const uint32_t ini_exclude,
                                   const uint32_t end_exclude,
                                   const uint32_t k0,
@@ -253,18 +318,6 @@ static void bit_selection_rm_rx_s(const int16_t* input,
 {
   uint32_t E = in_len;
 
-  uint32_t k    = 0;
-  uint32_t j    = 0;
-  uint32_t icwd = 0;
-  while (k < E) {
-    icwd = (k0 + j) % Ncb;
-    if (!(icwd >= ini_exclude && icwd < end_exclude)) { // avoid filler bits
-      indices[k] = icwd;
-      k          = k + 1;
-    }
-    j = j + 1;
-  } // while
-
   // set filler bits to INFINITY
   const long infinity16 = (1U << 15U) - 1; // Max positive value in 16-bit representation
   for (uint32_t i = ini_exclude; i < end_exclude; i++) {
@@ -275,16 +328,54 @@ static void bit_selection_rm_rx_s(const int16_t* input,
   const int16_t infinity15 =
       (1U << 14U) - 1; // Messages use a 15-bit quantization. Soft bits use the remaining bit to denote infinity.
   // input is assume to be quantized from -infinity15 to infinity15. Only filler bits can be infinity16
-  long tmp = 0;
-  for (uint32_t i = 0; i < E; i++) {
-    tmp = (long)output[indices[i]] + input[i];
-    if (tmp > infinity15) {
-      tmp = infinity15;
+  uint32_t k    = 0;
+  uint32_t icwd = k0;
+  while (k < E) {
+    uint32_t len = bit_selection_run(&icwd, E - k, ini_exclude, end_exclude, Ncb);
+    bit_combine_s(&output[icwd], &input[k], len, infinity15);
+    k += len;
+    icwd += len;
+  }
+}
+
+/*!
+ * Adds len soft bits to output, saturating at +/- infinity7.
+ */
+static void bit_combine_c(int8_t* output, const int8_t* input, const uint32_t len, const int8_t infinity7)
+{
+  uint32_t i = 0;
+
+#ifdef LV_HAVE_AVX2
+  __m256i max256 = _mm256_set1_epi8(infinity7);
+  __m256i min256 = _mm256_set1_epi8(-infinity7);
+  for (; i + 32 <= len; i += 32) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)&output[i]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)&input[i]);
+    __m256i r = _mm256_min_epi8(_mm256_max_epi8(_mm256_adds_epi8(a, b), min256), max256);
+    _mm256_storeu_si256((__m256i*)&output[i], r);
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  __m128i max128 = _mm_set1_epi8(infinity7);
+  __m128i min128 = _mm_set1_epi8(-infinity7);
+  for (; i + 16 <= len; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i*)&output[i]);
+    __m128i b = _mm_loadu_si128((const __m128i*)&input[i]);
+    __m128i r = _mm_min_epi8(_mm_max_epi8(_mm_adds_epi8(a, b), min128), max128);
+    _mm_storeu_si128((__m128i*)&output[i], r);
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    long tmp = (long)output[i] + input[i];
+    if (tmp > infinity7) {
+      tmp = infinity7;
     }
-    if (tmp < -infinity15) {
-      tmp = -infinity15;
+    if (tmp < -infinity7) {
+      tmp = -infinity7;
     }
-    output[indices[i]] = (int16_t)tmp;
+    output[i] = (int8_t)tmp;
   }
 }
 
@@ -299,7 +390,6 @@ static void bit_selection_rm_rx_s(const int16_t* input,
 static void bit_selection_rm_rx_c(const int8_t*  input,
                                   const uint32_t in_len,
                                   int8_t*        output,
-                                  uint32_t*      indices,
                                   const uint32_t ini_exclude,
                                   const uint32_t end_exclude,
                                   const uint32_t k0,
@@ -307,18 +397,6 @@ static void bit_selection_rm_rx_c(const int8_t*  input,
 {
   uint32_t E = in_len;
 
-  uint32_t k    = 0;
-  uint32_t j    = 0;
-  uint32_t icwd = 0;
-  while (k < E) {
-    icwd = (k0 + j) % Ncb;
-    if (!(icwd >= ini_exclude && icwd < end_exclude)) { // avoid filler bits
-      indices[k] = icwd;
-      k          = k + 1;
-    }
-    j = j + 1;
-  } // while
-
   // set filler bits to INFINITY
   const long infinity8 = (1U << 7U) - 1; // Max positive value in 8-bit representation
   for (uint32_t i = ini_exclude; i < end_exclude; i++) {
@@ -326,37 +404,64 @@ static void bit_selection_rm_rx_c(const int8_t*  input,
   }
 
   // Add soft bits, in case of repetition
-  const int16_t infinity7 =
+  const int8_t infinity7 =
       (1U << 6U) - 1; // Messages use a 15-bit quantization. Soft bits use the remaining bit to denote infinity.
   // input is assume to be quantized from -infinity15 to infinity15. Only filler bits can be infinity16
-  long tmp = 0;
-  for (uint32_t i = 0; i < E; i++) {
-    tmp = (long)output[indices[i]] + input[i];
-    if (tmp > infinity7) {
-      tmp = infinity7;
-    }
-    if (tmp < -infinity7) {
-      tmp = -infinity7;
-    }
-    output[indices[i]] = (int8_t)tmp;
+  uint32_t k    = 0;
+  uint32_t icwd = k0;
+  while (k < E) {
+    uint32_t len = bit_selection_run(&icwd, E - k, ini_exclude, end_exclude, Ncb);
+    bit_combine_c(&output[icwd], &input[k], len, infinity7);
+    k += len;
+    icwd += len;
   }
 }
 
+/*!
+ * Row/column (de)interleaver bodies. The callers switch on the modulation order so that ROWS is a constant for the
+ * usual orders and the compiler can turn the strided accesses into vector shuffles.
+ */
+#define BIT_INTERLEAVE(ROWS)                                                                                           \
+  for (uint32_t j = 0; j < cols; j++) {                                                                                \
+    for (uint32_t i = 0; i < (ROWS); i++) {                                                                            \
+      output[i + j * (ROWS)] = input[i * cols + j];                                                                    \
+    }                                                                                                                  \
+  }
+
+#define BIT_DEINTERLEAVE(ROWS)                                                                                         \
+  for (uint32_t j = 0; j < cols; j++) {                                                                                \
+    for (uint32_t i = 0; i < (ROWS); i++) {                                                                            \
+      output[i * cols + j] = input[j * (ROWS) + i];                                                                    \
+    }                                                                                                                  \
+  }
+
+#define BIT_INTERLEAVER_SWITCH(BODY, ROWS)                                                                             \
+  switch (ROWS) {                                                                                                      \
+    case 2:                                                                                                            \
+      BODY(2);                                                                                                         \
+      break;                                                                                                           \
+    case 4:                                                                                                            \
+      BODY(4);                                                                                                         \
+      break;                                                                                                           \
+    case 6:                                                                                                            \
+      BODY(6);                                                                                                         \
+      break;                                                                                                           \
+    case 8:                                                                                                            \
+      BODY(8);                                                                                                         \
+      break;                                                                                                           \
+    default:                                                                                                           \
+      BODY(ROWS);                                                                                                      \
+  }
+
 /*!
  * Bit interleaver
  */
 static void
 bit_interleaver_rm_tx(const uint8_t* input, uint8_t* output, const uint32_t in_out_len, const uint32_t mod_order)
 {
-  uint32_t cols = 0;
-  uint32_t rows = 0;
-  rows          = mod_order;
-  cols          = in_out_len / rows;
-  for (uint32_t j = 0; j < cols; j++) {
-    for (uint32_t i = 0; i < rows; i++) {
-      output[i + j * rows] = input[i * cols + j];
-    }
-  }
+  uint32_t rows = mod_order;
+  uint32_t cols = in_out_len / rows;
+  BIT_INTERLEAVER_SWITCH(BIT_INTERLEAVE, rows);
 }
 
 /*!
@@ -365,15 +470,9 @@ bit_interleaver_rm_tx(const uint8_t* input, uint8_t* output, const uint32_t in_o
 static void
 bit_interleaver_rm_rx(const float* input, float* output, const uint32_t in_out_len, const uint32_t mod_order)
 {
-  uint32_t cols = 0;
-  uint32_t rows = 0;
-  rows          = mod_order;
-  cols          = in_out_len / rows;
-  for (uint32_t j = 0; j < cols; j++) {
-    for (uint32_t i = 0; i < rows; i++) {
-      output[i * cols + j] = input[j * rows + i];
-    }
-  }
+  uint32_t rows = mod_order;
+  uint32_t cols = in_out_len / rows;
+  BIT_INTERLEAVER_SWITCH(BIT_DEINTERLEAVE, rows);
 }
 
 /*!
@@ -382,32 +481,20 @@ bit_interleaver_rm_rx(const float* input, float* output, const uint32_t in_out_l
 static void
 bit_interleaver_rm_rx_s(const int16_t* input, int16_t* output, const uint32_t in_out_len, const uint32_t mod_order)
 {
-  uint32_t cols = 0;
-  uint32_t rows = 0;
-  rows          = mod_order;
-  cols          = in_out_len / rows;
-  for (uint32_t j = 0; j < cols; j++) {
-    for (uint32_t i = 0; i < rows; i++) {
-      output[i * cols + j] = input[j * rows + i];
-    }
-  }
+  uint32_t rows = mod_order;
+  uint32_t cols = in_out_len / rows;
+  BIT_INTERLEAVER_SWITCH(BIT_DEINTERLEAVE, rows);
 }
 
 /*!
- * Bit deinterleaver (short)
+ * Bit deinterleaver (char)
  */
 static void
 bit_interleaver_rm_rx_c(const int8_t* input, int8_t* output, const uint32_t in_out_len, const uint32_t mod_order)
 {
-  uint32_t cols = 0;
-  uint32_t rows = 0;
-  rows          = mod_order;
-  cols          = in_out_len / rows;
-  for (uint32_t j = 0; j < cols; j++) {
-    for (uint32_t i = 0; i < rows; i++) {
-      output[i * cols + j] = input[j * rows + i];
-    }
-  }
+  uint32_t rows = mod_order;
+  uint32_t cols = in_out_len / rows;
+  BIT_INTERLEAVER_SWITCH(BIT_DEINTERLEAVE, rows);
 }
 
 int srsran_ldpc_rm_tx_init(srsran_ldpc_rm_t* p)
@@ -452,12 +539,6 @@ int srsran_ldpc_rm_rx_init_f(srsran_ldpc_rm_t* p)
     free(pp);
     return -1;
   }
-
-  if ((pp->indices = srsran_vec_u32_malloc(MAXE)) == NULL) {
-    free(pp->tmp_rm_symbol);
-    free(pp);
-    return -1;
-  }
   return 0;
 }
 
@@ -481,12 +562,6 @@ int srsran_ldpc_rm_rx_init_s(srsran_ldpc_rm_t* p)
     return -1;
   }
 
-  if ((pp->indices = srsran_vec_u32_malloc(MAXE)) == NULL) {
-    free(pp->tmp_rm_symbol);
-    free(pp);
-    return -1;
-  }
-
   return 0;
 }
 int srsran_ldpc_rm_rx_init_c(srsran_ldpc_rm_t* p)
@@ -509,12 +584,6 @@ int srsran_ldpc_rm_rx_init_c(srsran_ldpc_rm_t* p)
     return -1;
   }
 
-  if ((pp->indices = srsran_vec_u32_malloc(MAXE)) == NULL) {
-    free(pp->tmp_rm_symbol);
-    free(pp);
-    return -1;
-  }
-
   return 0;
 }
 
@@ -539,9 +608,6 @@ void srsran_ldpc_rm_rx_free_f(srsran_ldpc_rm_t* q)
       if (qq->tmp_rm_symbol != NULL) {
         free(qq->tmp_rm_symbol);
       }
-      if (qq->indices != NULL) {
-        free(qq->indices);
-      }
       free(qq);
     }
   }
@@ -555,9 +621,6 @@ void srsran_ldpc_rm_rx_free_s(srsran_ldpc_rm_t* q)
       if (qq->tmp_rm_symbol != NULL) {
         free(qq->tmp_rm_symbol);
       }
-      if (qq->indices != NULL) {
-        free(qq->indices);
-      }
       free(qq);
     }
   }
@@ -571,9 +634,6 @@ void srsran_ldpc_rm_rx_free_c(srsran_ldpc_rm_t* q)
       if (qq->tmp_rm_symbol != NULL) {
         free(qq->tmp_rm_symbol);
       }
-      if (qq->indices != NULL) {
-        free(qq->indices);
-      }
       free(qq);
     }
   }
@@ -627,15 +687,14 @@ int srsran_ldpc_rm_rx_f(srsran_ldpc_rm_t*        q,
 
   struct pRM_rx_f* pp            = q->ptr;
   float*           tmp_rm_symbol = pp->tmp_rm_symbol;
-  uint32_t*        indices       = pp->indices;
   uint32_t         end_exclude   = q->K - 2 * q->ls;
   uint32_t         ini_exclude   = end_exclude - q->F;
 
   if (q->mod_order == 1) { // interleaver can be skipped
-    bit_selection_rm_rx(input, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx(input, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   } else {
     bit_interleaver_rm_rx(input, tmp_rm_symbol, q->E, q->mod_order);
-    bit_selection_rm_rx(tmp_rm_symbol, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx(tmp_rm_symbol, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   }
   return 0;
 }
@@ -658,15 +717,14 @@ int srsran_ldpc_rm_rx_s(srsran_ldpc_rm_t*        q,
 
   struct pRM_rx_f* pp            = q->ptr;
   int16_t*         tmp_rm_symbol = (int16_t*)pp->tmp_rm_symbol;
-  uint32_t*        indices       = pp->indices;
   uint32_t         end_exclude   = q->K - 2 * q->ls;
   uint32_t         ini_exclude   = end_exclude - q->F;
 
   if (q->mod_order == 1) { // interleaver can be skipped
-    bit_selection_rm_rx_s(input, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_s(input, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   } else {
     bit_interleaver_rm_rx_s(input, tmp_rm_symbol, q->E, q->mod_order);
-    bit_selection_rm_rx_s(tmp_rm_symbol, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_s(tmp_rm_symbol, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   }
 
   return 0;
@@ -690,15 +748,14 @@ int srsran_ldpc_rm_rx_c(srsran_ldpc_rm_t*        q,
 
   struct pRM_rx_c* pp            = q->ptr;
   int8_t*          tmp_rm_symbol = pp->tmp_rm_symbol;
-  uint32_t*        indices       = pp->indices;
   uint32_t         end_exclude   = q->K - 2 * q->ls;
   uint32_t         ini_exclude   = end_exclude - q->F;
 
   if (q->mod_order == 1) { // interleaver can be skipped
-    bit_selection_rm_rx_c(input, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_c(input, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   } else {
     bit_interleaver_rm_rx_c(input, tmp_rm_symbol, q->E, q->mod_order);
-    bit_selection_rm_rx_c(tmp_rm_symbol, q->E, output, indices, ini_exclude, end_exclude, q->k0, q->Ncb);
+    bit_selection_rm_rx_c(tmp_rm_symbol, q->E, output, ini_exclude, end_exclude, q->k0, q->Ncb);
   }
 
   // Return the number of useful LLR
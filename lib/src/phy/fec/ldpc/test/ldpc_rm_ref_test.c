@@ -0,0 +1,273 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file ldpc_rm_ref_test.c
+ * \brief Compares the LDPC RateMatcher and RateDematchers against a bit-by-bit reference.
+ *
+ * The reference walks the circular buffer one bit at a time, as in TS 38.212 Section 5.4.2, skipping the filler
+ * bits. Random sets of (base graph, lifting size, rv, modulation, E, F, Nref) are rate-matched and rate-dematched
+ * by both. The rate-matched bits and the int16_t and int8_t rate-dematched symbols must be identical, the
+ * float ones equal up to rounding.
+ *
+ * Synopsis: **ldpc_rm_ref_test [options]**
+ *
+ * Options:
+ *  - **-n \<number\>** Number of random sets (Default 3000).
+ *  - **-s \<number\>** Random seed (Default 0).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "srsran/phy/fec/ldpc/ldpc_common.h"
+#include "srsran/phy/fec/ldpc/ldpc_rm.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+
+static uint32_t nof_sets = 3000; /*!< \brief Number of random parameter sets. */
+static uint32_t seed     = 0;    /*!< \brief Random seed. */
+
+static const uint32_t BASEK0[4][2] = {{0, 0}, {17, 13}, {33, 25}, {56, 43}};
+static const uint32_t BASEN[2]     = {66, 50};
+static const uint32_t BASEK[2]     = {22, 10};
+
+// Largest E drawn by the test, three times the largest codeword
+#define MAX_E (3 * 66 * 384)
+
+/*!
+ * \brief Prints test help when a wrong parameter is passed as input.
+ */
+void usage(char* prog)
+{
+  printf("Usage: %s [-nX] [-sX]\n", prog);
+  printf("\t-n Number of random sets [Default %d]\n", nof_sets);
+  printf("\t-s Random seed [Default %d]\n", seed);
+}
+
+/*!
+ * \brief Parses the input line.
+ */
+void parse_args(int argc, char** argv)
+{
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "n:s:")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_sets = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      case 's':
+        seed = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/*!
+ * \brief Circular buffer index of every rate-matched bit, skipping the filler bits in [ini_exclude, end_exclude).
+ */
+static void ref_indices(uint32_t* indices,
+                        uint32_t  E,
+                        uint32_t  k0,
+                        uint32_t  Ncb,
+                        uint32_t  ini_exclude,
+                        uint32_t  end_exclude)
+{
+  uint32_t k = 0;
+  for (uint32_t j = 0; k < E; j++) {
+    uint32_t icwd = (k0 + j) % Ncb;
+    if (icwd < ini_exclude || icwd >= end_exclude) {
+      indices[k++] = icwd;
+    }
+  }
+}
+
+/*!
+ * \brief Position of bit k of the rate-matched block after the row-column interleaver with Qm rows.
+ */
+static inline uint32_t ref_interleave(uint32_t k, uint32_t E, uint32_t Qm)
+{
+  uint32_t cols = E / Qm;
+  return (k % cols) * Qm + k / cols;
+}
+
+static int16_t ref_sat(long value, long limit)
+{
+  return (int16_t)SRSRAN_MAX(-limit, SRSRAN_MIN(limit, value));
+}
+
+int main(int argc, char** argv)
+{
+  parse_args(argc, argv);
+
+  srsran_ldpc_rm_t rm_tx, rm_rx_f, rm_rx_s, rm_rx_c;
+  if (srsran_ldpc_rm_tx_init(&rm_tx) != 0 || srsran_ldpc_rm_rx_init_f(&rm_rx_f) != 0 ||
+      srsran_ldpc_rm_rx_init_s(&rm_rx_s) != 0 || srsran_ldpc_rm_rx_init_c(&rm_rx_c) != 0) {
+    ERROR("Error initializing rate matchers");
+    return SRSRAN_ERROR;
+  }
+
+  const uint32_t max_N = BASEN[0] * 384;
+
+  uint32_t* indices   = srsran_vec_u32_malloc(MAX_E);
+  uint8_t*  codeword  = srsran_vec_u8_malloc(max_N);
+  uint8_t*  rm_bits   = srsran_vec_u8_malloc(MAX_E);
+  uint8_t*  ref_bits  = srsran_vec_u8_malloc(MAX_E);
+  float*    llr_f     = srsran_vec_f_malloc(MAX_E);
+  int16_t*  llr_s     = srsran_vec_i16_malloc(MAX_E);
+  int8_t*   llr_c     = srsran_vec_i8_malloc(MAX_E);
+  float*    out_f     = srsran_vec_f_malloc(max_N);
+  int16_t*  out_s     = srsran_vec_i16_malloc(max_N);
+  int8_t*   out_c     = srsran_vec_i8_malloc(max_N);
+  float*    ref_out_f = srsran_vec_f_malloc(max_N);
+  int16_t*  ref_out_s = srsran_vec_i16_malloc(max_N);
+  int8_t*   ref_out_c = srsran_vec_i8_malloc(max_N);
+  if (!indices || !codeword || !rm_bits || !ref_bits || !llr_f || !llr_s || !llr_c || !out_f || !out_s || !out_c ||
+      !ref_out_f || !ref_out_s || !ref_out_c) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  static const srsran_mod_t mods[] = {
+      SRSRAN_MOD_BPSK, SRSRAN_MOD_QPSK, SRSRAN_MOD_16QAM, SRSRAN_MOD_64QAM, SRSRAN_MOD_256QAM};
+  static const uint32_t sizes[] = {2, 3, 7, 16, 52, 104, 208, 384};
+
+  srsran_random_t random_gen = srsran_random_init(seed);
+  int             errors     = 0;
+
+  for (uint32_t set = 0; set < nof_sets; set++) {
+    srsran_basegraph_t bg       = (srsran_basegraph_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+    uint32_t           ls       = sizes[srsran_random_uniform_int_dist(random_gen, 0, 7)];
+    uint8_t            rv       = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 3);
+    srsran_mod_t       mod_type = mods[srsran_random_uniform_int_dist(random_gen, 0, 4)];
+    uint32_t           Qm       = srsran_mod_bits_x_symbol(mod_type);
+
+    uint32_t N = ls * BASEN[bg];
+    uint32_t K = ls * BASEK[bg];
+    uint32_t F = srsran_random_bool(random_gen, 0.33f) ? 0 : srsran_random_uniform_int_dist(random_gen, 0, K / 2 - 1);
+    uint32_t Nref =
+        srsran_random_bool(random_gen, 0.5f) ? N : 2 * N / 3 + srsran_random_uniform_int_dist(random_gen, 0, N / 3 - 1);
+    uint32_t E = SRSRAN_MAX(Qm, srsran_random_uniform_int_dist(random_gen, 1, 3 * N) / Qm * Qm);
+
+    uint32_t Ncb         = SRSRAN_MIN(N, Nref);
+    uint32_t k0          = ls * ((BASEK0[rv][bg] * Ncb) / N);
+    uint32_t end_exclude = K - 2 * ls;
+    uint32_t ini_exclude = end_exclude - F;
+
+    // Rate matching
+    srsran_random_bit_vector(random_gen, codeword, N);
+    memset(&codeword[ini_exclude], FILLER_BIT, F);
+    ref_indices(indices, E, k0, Ncb, ini_exclude, end_exclude);
+    for (uint32_t k = 0; k < E; k++) {
+      ref_bits[ref_interleave(k, E, Qm)] = codeword[indices[k]];
+    }
+    srsran_ldpc_rm_tx(&rm_tx, codeword, rm_bits, E, bg, ls, rv, mod_type, Nref);
+    if (memcmp(rm_bits, ref_bits, E) != 0) {
+      ERROR("Set %d (bg=%d ls=%d rv=%d Qm=%d E=%d Nref=%d): rate-matched bits differ",
+            set,
+            bg + 1,
+            ls,
+            rv,
+            Qm,
+            E,
+            Nref);
+      errors++;
+    }
+
+    // Rate dematching, on top of the soft bits of a previous transmission
+    for (uint32_t k = 0; k < E; k++) {
+      llr_f[k] = srsran_random_uniform_real_dist(random_gen, -15.0f, 15.0f);
+      llr_s[k] = (int16_t)srsran_random_uniform_int_dist(random_gen, -16383, 16383);
+      llr_c[k] = (int8_t)srsran_random_uniform_int_dist(random_gen, -63, 63);
+    }
+    for (uint32_t n = 0; n < N; n++) {
+      out_f[n] = ref_out_f[n] = srsran_random_uniform_real_dist(random_gen, 0.0f, 16.0f);
+      out_s[n] = ref_out_s[n] = (int16_t)srsran_random_uniform_int_dist(random_gen, -1000, 1000);
+      out_c[n] = ref_out_c[n] = (int8_t)srsran_random_uniform_int_dist(random_gen, -30, 30);
+    }
+
+    for (uint32_t n = ini_exclude; n < end_exclude; n++) {
+      ref_out_f[n] = INFINITY;
+      ref_out_s[n] = INT16_MAX;
+      ref_out_c[n] = INT8_MAX;
+    }
+    for (uint32_t k = 0; k < E; k++) {
+      uint32_t i   = ref_interleave(k, E, Qm);
+      uint32_t n   = indices[k];
+      ref_out_f[n] = ref_out_f[n] + llr_f[i];
+      ref_out_s[n] = ref_sat((long)ref_out_s[n] + llr_s[i], (1L << 14) - 1);
+      ref_out_c[n] = (int8_t)ref_sat((long)ref_out_c[n] + llr_c[i], (1L << 6) - 1);
+    }
+
+    srsran_ldpc_rm_rx_f(&rm_rx_f, llr_f, out_f, E, F, bg, ls, rv, mod_type, Nref);
+    srsran_ldpc_rm_rx_s(&rm_rx_s, llr_s, out_s, E, F, bg, ls, rv, mod_type, Nref);
+    int ret = srsran_ldpc_rm_rx_c(&rm_rx_c, llr_c, out_c, E, F, bg, ls, rv, mod_type, Nref);
+
+    for (uint32_t n = 0; n < N; n++) {
+      if (out_f[n] != ref_out_f[n] && fabsf(out_f[n] - ref_out_f[n]) > 1e-3f) {
+        ERROR("Set %d: float rate-dematched symbol %d is %f instead of %f", set, n, out_f[n], ref_out_f[n]);
+        errors++;
+        break;
+      }
+    }
+    if (memcmp(out_s, ref_out_s, N * sizeof(int16_t)) != 0) {
+      ERROR("Set %d: int16_t rate-dematched symbols differ", set);
+      errors++;
+    }
+    if (memcmp(out_c, ref_out_c, N * sizeof(int8_t)) != 0 || ret != (int)SRSRAN_MIN(k0 + E, Ncb)) {
+      ERROR("Set %d: int8_t rate-dematched symbols differ", set);
+      errors++;
+    }
+  }
+
+  srsran_random_free(random_gen);
+  srsran_ldpc_rm_tx_free(&rm_tx);
+  srsran_ldpc_rm_rx_free_f(&rm_rx_f);
+  srsran_ldpc_rm_rx_free_s(&rm_rx_s);
+  srsran_ldpc_rm_rx_free_c(&rm_rx_c);
+  free(indices);
+  free(codeword);
+  free(rm_bits);
+  free(ref_bits);
+  free(llr_f);
+  free(llr_s);
+  free(llr_c);
+  free(out_f);
+  free(out_s);
+  free(out_c);
+  free(ref_out_f);
+  free(ref_out_s);
+  free(ref_out_c);
+
+  if (errors > 0) {
+    printf("Test FAILED: %d mismatches in %d sets\n", errors, nof_sets);
+    return SRSRAN_ERROR;
+  }
+  printf("Test passed: %d sets\n", nof_sets);
+  return SRSRAN_SUCCESS;
+}
@@ -37,6 +37,7 @@
 #include <math.h>
 #include <string.h>
 
+#include "polar_decoder_fast_ssc_c.h"
 #include "polar_decoder_ssc_c.h"
 #include "polar_decoder_ssc_c_avx2.h"
 #include "polar_decoder_ssc_f.h"
@@ -95,6 +96,23 @@ static int decode_ssc_c(void*           o,
   return 0;
 }
 
+/*! Fast-SSC Polar decoder with int8_t LLR inputs. */
+static int decode_fast_ssc_c(void*           o,
+                             const int8_t*   symbols,
+                             uint8_t*        data,
+                             const uint8_t   n,
+                             const uint16_t* frozen_set,
+                             const uint16_t  frozen_set_size)
+{
+  srsran_polar_decoder_t* q = o;
+
+  if (init_polar_decoder_fast_ssc_c(q->ptr, symbols, data, n, frozen_set, frozen_set_size) < 0) {
+    return -1;
+  }
+
+  return polar_decoder_fast_ssc_c(q->ptr, data);
+}
+
 #ifdef LV_HAVE_AVX2
 /*! SSC Polar decoder AVX2 with int8_t LLR inputs . */
 static int decode_ssc_c_avx2(void*           o,
@@ -135,6 +153,13 @@ static void free_ssc_c(void* o)
   delete_polar_decoder_ssc_c(q->ptr);
 }
 
+/*! Destructor of a (int8_t) Fast-SSC polar decoder. */
+static void free_fast_ssc_c(void* o)
+{
+  srsran_polar_decoder_t* q = o;
+  delete_polar_decoder_fast_ssc_c(q->ptr);
+}
+
 #ifdef LV_HAVE_AVX2
 /*! Destructor of a (int8_t, avx2) SSC polar decoder. */
 static void free_ssc_c_avx2(void* o)
@@ -186,6 +211,20 @@ static int init_ssc_c(srsran_polar_decoder_t* q)
   return 0;
 }
 
+/*! Initializes a polar decoder structure to use the Fast-SSC polar decoder algorithm with uint8_t LLR inputs. */
+static int init_fast_ssc_c(srsran_polar_decoder_t* q)
+{
+  q->decode_c = decode_fast_ssc_c;
+  q->free     = free_fast_ssc_c;
+
+  if ((q->ptr = create_polar_decoder_fast_ssc_c(q->nMax)) == NULL) {
+    ERROR("create_polar_decoder_fast_ssc_c failed");
+    free_fast_ssc_c(q);
+    return -1;
+  }
+  return 0;
+}
+
 #ifdef LV_HAVE_AVX2
 /*! Initializes a polar decoder structure to use the SSC polar decoder algorithm with uint8_t LLR inputs and AVX2
  * instructions. */
@@ -213,6 +252,8 @@ int srsran_polar_decoder_init(srsran_polar_decoder_t* q, srsran_polar_decoder_ty
       return init_ssc_s(q);
     case SRSRAN_POLAR_DECODER_SSC_C:
       return init_ssc_c(q);
+    case SRSRAN_POLAR_DECODER_FAST_SSC_C:
+      return init_fast_ssc_c(q);
 #ifdef LV_HAVE_AVX2
     case SRSRAN_POLAR_DECODER_SSC_C_AVX2:
       return init_ssc_c_avx2(q);
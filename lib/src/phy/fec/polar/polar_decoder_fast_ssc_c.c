@@ -0,0 +1,503 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_fast_ssc_c.c
+ * \brief Definition of the Fast-SSC polar decoder working with 8-bit integer-valued LLRs.
+ *
+ * On top of the ::RATE_0 and ::RATE_1 shortcuts of the SSC decoder, Fast-SSC decodes repetition (REP) and
+ * single-parity-check (SPC) nodes, and a REP node followed by an SPC node of size 4 (REP-SPC), with dedicated
+ * maximum-likelihood kernels instead of descending to their leaves.
+ *
+ * The decoding tree only depends on the frozen set, so it is flattened once into a list of operations (the schedule)
+ * and cached. Decoding a codeword then runs the operations in order without any tree traversal.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#include "polar_decoder_fast_ssc_c.h"
+#include "srsran/phy/utils/vector.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * \brief Operations of a Fast-SSC schedule.
+ */
+typedef enum {
+  OP_F = 0,   /*!< \brief Left child LLRs, \f$ f(a, b) \f$ of the two halves. */
+  OP_G,       /*!< \brief Right child LLRs, \f$ g(\beta, a, b) \f$ with the left child codeword \f$ \beta \f$. */
+  OP_G0,      /*!< \brief Right child LLRs when the left child is rate-0, \f$ a + b \f$. */
+  OP_COMBINE, /*!< \brief Node codeword from its children, left half XOR right half. */
+  OP_RATE_1,  /*!< \brief All bits are information bits, hard decision. */
+  OP_REP,     /*!< \brief Only the last bit is an information bit, the codeword repeats it. */
+  OP_SPC,     /*!< \brief Only the first bit is frozen, the codeword has even parity. */
+  OP_REP_SPC, /*!< \brief Node of size 8 whose left child is REP and right child is SPC. */
+} fast_ssc_op_type_t;
+
+/*!
+ * \brief One operation at a node of the decoding tree.
+ */
+typedef struct {
+  uint8_t  type;    /*!< \brief A ::fast_ssc_op_type_t. */
+  uint8_t  stage;   /*!< \brief Stage of the node, it spans \f$2^{stage}\f$ bits. */
+  uint16_t bit_pos; /*!< \brief First bit of the node. */
+} fast_ssc_op_t;
+
+/*!
+ * \brief Decoding schedule of a frozen set.
+ */
+typedef struct {
+  uint8_t        code_size_log;   /*!< \brief \f$log_2\f$ of code size. */
+  uint16_t       frozen_set_size; /*!< \brief Number of frozen bits. */
+  uint16_t*      frozen_set;      /*!< \brief Copy of the frozen set, key of the cache entry. */
+  fast_ssc_op_t* ops;             /*!< \brief Operations, in decoding order. */
+  uint32_t       nof_ops;         /*!< \brief Number of operations. */
+} fast_ssc_schedule_t;
+
+/*!
+ * \brief Describes a Fast-SSC polar decoder (8-bit version).
+ */
+struct pFastSSC_c {
+  uint8_t              nMax;                              /*!< \brief Maximum \f$log_2\f$ of code size. */
+  int8_t*              llr_buffer;                        /*!< \brief LLR memory of all stages below the root. */
+  int8_t*              llr[16];                           /*!< \brief LLRs of the active node at each stage. */
+  uint8_t*             est_bit;                           /*!< \brief Codeword estimates of the decoded nodes. */
+  uint8_t*             is_info;                           /*!< \brief Information bit indicator, for compiling. */
+  uint16_t*            nof_info;                          /*!< \brief Prefix count of is_info, for compiling. */
+  fast_ssc_op_t*       ops;                               /*!< \brief Scratch schedule, for compiling. */
+  fast_ssc_schedule_t  cache[POLAR_FAST_SSC_CACHE_SIZE];  /*!< \brief Compiled schedules. */
+  uint32_t             cache_next;                        /*!< \brief Next cache entry to replace. */
+  fast_ssc_schedule_t* schedule;                          /*!< \brief Schedule of the current codeword. */
+};
+
+// Upper bound of operations per schedule: every R node emits at most 4 operations and there are less than 2N nodes
+#define FAST_SSC_MAX_OPS(N) (4U * (N))
+
+static inline int8_t saturate(int16_t x)
+{
+  return (int8_t)(x > 127 ? 127 : (x < -127 ? -127 : x));
+}
+
+/*!
+ * Box-plus (min-sum) of the two halves of the parent LLRs, same as srsran_vec_function_f_ccc().
+ */
+static void f_kernel(const int8_t* x, const int8_t* y, int8_t* z, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    int16_t abs_x = (int16_t)abs(x[i]);
+    int16_t abs_y = (int16_t)abs(y[i]);
+    int16_t m     = (abs_x < abs_y) ? abs_x : abs_y;
+    z[i]          = (int8_t)(((x[i] ^ y[i]) < 0) ? -m : m);
+  }
+}
+
+/*!
+ * Right child LLRs, same as srsran_vec_function_g_bccc().
+ */
+static void g_kernel(const uint8_t* b, const int8_t* x, const int8_t* y, int8_t* z, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    z[i] = saturate((int16_t)y[i] + (b[i] ? -(int16_t)x[i] : (int16_t)x[i]));
+  }
+}
+
+/*!
+ * Right child LLRs when the left child codeword is all zeros.
+ */
+static void g0_kernel(const int8_t* x, const int8_t* y, int8_t* z, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    z[i] = saturate((int16_t)y[i] + (int16_t)x[i]);
+  }
+}
+
+static void hard_bit_kernel(const int8_t* x, uint8_t* z, uint16_t len)
+{
+  for (uint16_t i = 0; i < len; i++) {
+    z[i] = (x[i] < 0);
+  }
+}
+
+/*!
+ * Polar transform of a node codeword, which is its own inverse. It gives the message bits of the node.
+ */
+static void transform(const uint8_t* x, uint8_t* u, uint16_t len)
+{
+  if (u != x) {
+    memcpy(u, x, len);
+  }
+  for (uint16_t half = len / 2; half > 0; half /= 2) {
+    for (uint16_t j = 0; j < len; j += 2 * half) {
+      for (uint16_t i = j; i < j + half; i++) {
+        u[i] ^= u[i + half];
+      }
+    }
+  }
+}
+
+/*!
+ * Decodes a repetition node: the sign of the LLR sum decides the only information bit.
+ */
+static uint8_t rep_kernel(const int8_t* llr, uint8_t* x, uint8_t* u, uint16_t len)
+{
+  int32_t sum = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    sum += llr[i];
+  }
+  uint8_t bit = (sum < 0);
+
+  memset(x, bit, len);
+  u[len - 1] = bit;
+  return bit;
+}
+
+/*!
+ * Decodes a single-parity-check node (Wagner decoding): hard decisions, and the least reliable bit flipped if the
+ * parity does not check.
+ */
+static void spc_kernel(const int8_t* llr, uint8_t* x, uint8_t* u, uint16_t len)
+{
+  uint8_t  parity  = 0;
+  uint16_t min_idx = 0;
+  int16_t  min_abs = INT16_MAX;
+  for (uint16_t i = 0; i < len; i++) {
+    int16_t abs_llr = (int16_t)abs(llr[i]);
+    x[i]            = (llr[i] < 0);
+    parity ^= x[i];
+    if (abs_llr < min_abs) {
+      min_abs = abs_llr;
+      min_idx = i;
+    }
+  }
+  x[min_idx] ^= parity;
+
+  transform(x, u, len);
+}
+
+/*!
+ * Decodes a REP node of size 4 followed by an SPC node of size 4 without going through the parent node buffers.
+ */
+static void rep_spc_kernel(const int8_t* llr, uint8_t* x, uint8_t* u)
+{
+  int8_t llr_child[4];
+
+  f_kernel(llr, llr + 4, llr_child, 4);
+  rep_kernel(llr_child, x, u, 4);
+
+  g_kernel(x, llr, llr + 4, llr_child, 4);
+  spc_kernel(llr_child, x + 4, u + 4, 4);
+
+  for (uint16_t i = 0; i < 4; i++) {
+    x[i] ^= x[i + 4];
+  }
+}
+
+void* create_polar_decoder_fast_ssc_c(const uint8_t nMax)
+{
+  if (nMax >= 16) {
+    return NULL;
+  }
+
+  struct pFastSSC_c* pp = calloc(1, sizeof(struct pFastSSC_c));
+  if (pp == NULL) {
+    return NULL;
+  }
+  pp->nMax = nMax;
+
+  uint16_t code_size = (uint16_t)(1U << nMax);
+
+  // Stage s < nMax needs 2^s LLRs, 2^nMax - 1 in total. The root LLRs are read from the input.
+  pp->llr_buffer = srsran_vec_i8_malloc(code_size);
+  pp->est_bit    = srsran_vec_u8_malloc(code_size);
+  pp->is_info    = srsran_vec_u8_malloc(code_size);
+  pp->nof_info   = srsran_vec_u16_malloc(code_size + 1);
+  pp->ops        = SRSRAN_MEM_ALLOC(fast_ssc_op_t, FAST_SSC_MAX_OPS(code_size));
+  if (pp->llr_buffer == NULL || pp->est_bit == NULL || pp->is_info == NULL || pp->nof_info == NULL ||
+      pp->ops == NULL) {
+    delete_polar_decoder_fast_ssc_c(pp);
+    return NULL;
+  }
+
+  for (uint32_t i = 0; i < POLAR_FAST_SSC_CACHE_SIZE; i++) {
+    pp->cache[i].frozen_set = srsran_vec_u16_malloc(code_size);
+    if (pp->cache[i].frozen_set == NULL) {
+      delete_polar_decoder_fast_ssc_c(pp);
+      return NULL;
+    }
+  }
+
+  return pp;
+}
+
+void delete_polar_decoder_fast_ssc_c(void* p)
+{
+  struct pFastSSC_c* pp = p;
+
+  if (pp == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < POLAR_FAST_SSC_CACHE_SIZE; i++) {
+    if (pp->cache[i].frozen_set) {
+      free(pp->cache[i].frozen_set);
+    }
+    if (pp->cache[i].ops) {
+      free(pp->cache[i].ops);
+    }
+  }
+  if (pp->llr_buffer) {
+    free(pp->llr_buffer);
+  }
+  if (pp->est_bit) {
+    free(pp->est_bit);
+  }
+  if (pp->is_info) {
+    free(pp->is_info);
+  }
+  if (pp->nof_info) {
+    free(pp->nof_info);
+  }
+  if (pp->ops) {
+    free(pp->ops);
+  }
+  free(pp);
+}
+
+static inline uint16_t count_info(const struct pFastSSC_c* pp, uint16_t bit_pos, uint16_t size)
+{
+  return pp->nof_info[bit_pos + size] - pp->nof_info[bit_pos];
+}
+
+static inline bool is_rep(const struct pFastSSC_c* pp, uint16_t bit_pos, uint16_t size)
+{
+  return count_info(pp, bit_pos, size) == 1 && pp->is_info[bit_pos + size - 1];
+}
+
+static inline bool is_spc(const struct pFastSSC_c* pp, uint16_t bit_pos, uint16_t size)
+{
+  return size >= 4 && count_info(pp, bit_pos, size) == size - 1 && !pp->is_info[bit_pos];
+}
+
+static inline void emit(struct pFastSSC_c* pp, uint32_t* nof_ops, uint8_t type, uint8_t stage, uint16_t bit_pos)
+{
+  pp->ops[*nof_ops].type    = type;
+  pp->ops[*nof_ops].stage   = stage;
+  pp->ops[*nof_ops].bit_pos = bit_pos;
+  (*nof_ops)++;
+}
+
+/*!
+ * Appends the operations of the node at (stage, bit_pos) to the scratch schedule. Rate-0 nodes emit nothing: their
+ * codeword and message bits are the zeros set before decoding.
+ */
+static void compile_node(struct pFastSSC_c* pp, uint32_t* nof_ops, uint8_t stage, uint16_t bit_pos, bool is_root)
+{
+  uint16_t size     = (uint16_t)(1U << stage);
+  uint16_t nof_info = count_info(pp, bit_pos, size);
+
+  if (nof_info == 0) {
+    return;
+  }
+  if (nof_info == size) {
+    emit(pp, nof_ops, OP_RATE_1, stage, bit_pos);
+    return;
+  }
+  if (is_rep(pp, bit_pos, size)) {
+    emit(pp, nof_ops, OP_REP, stage, bit_pos);
+    return;
+  }
+  if (is_spc(pp, bit_pos, size)) {
+    emit(pp, nof_ops, OP_SPC, stage, bit_pos);
+    return;
+  }
+  if (size == 8 && is_rep(pp, bit_pos, 4) && is_spc(pp, bit_pos + 4, 4)) {
+    emit(pp, nof_ops, OP_REP_SPC, stage, bit_pos);
+    return;
+  }
+
+  uint16_t half       = size / 2;
+  uint16_t left_info  = count_info(pp, bit_pos, half);
+  uint16_t right_info = nof_info - left_info;
+
+  if (left_info > 0) {
+    emit(pp, nof_ops, OP_F, stage, bit_pos);
+    compile_node(pp, nof_ops, stage - 1, bit_pos, false);
+  }
+
+  if (right_info > 0) {
+    emit(pp, nof_ops, left_info > 0 ? OP_G : OP_G0, stage, bit_pos);
+    compile_node(pp, nof_ops, stage - 1, bit_pos + half, false);
+
+    // The root codeword is not needed, and a rate-0 right child leaves the left half unchanged
+    if (!is_root) {
+      emit(pp, nof_ops, OP_COMBINE, stage, bit_pos);
+    }
+  }
+}
+
+static inline bool schedule_matches(const fast_ssc_schedule_t* s,
+                                    const uint16_t*            frozen_set,
+                                    uint16_t                   frozen_set_size,
+                                    uint8_t                    code_size_log)
+{
+  return s != NULL && s->ops != NULL && s->code_size_log == code_size_log && s->frozen_set_size == frozen_set_size &&
+         memcmp(s->frozen_set, frozen_set, frozen_set_size * sizeof(uint16_t)) == 0;
+}
+
+static fast_ssc_schedule_t*
+get_schedule(struct pFastSSC_c* pp, const uint16_t* frozen_set, uint16_t frozen_set_size, uint8_t code_size_log)
+{
+  // The current schedule is the most likely hit
+  if (schedule_matches(pp->schedule, frozen_set, frozen_set_size, code_size_log)) {
+    return pp->schedule;
+  }
+  for (uint32_t i = 0; i < POLAR_FAST_SSC_CACHE_SIZE; i++) {
+    if (schedule_matches(&pp->cache[i], frozen_set, frozen_set_size, code_size_log)) {
+      return &pp->cache[i];
+    }
+  }
+
+  // Compile the tree of the new frozen set
+  uint16_t code_size = (uint16_t)(1U << code_size_log);
+  memset(pp->is_info, 1, code_size);
+  for (uint16_t i = 0; i < frozen_set_size; i++) {
+    if (frozen_set[i] >= code_size) {
+      return NULL;
+    }
+    pp->is_info[frozen_set[i]] = 0;
+  }
+  pp->nof_info[0] = 0;
+  for (uint16_t i = 0; i < code_size; i++) {
+    pp->nof_info[i + 1] = pp->nof_info[i] + pp->is_info[i];
+  }
+
+  uint32_t nof_ops = 0;
+  compile_node(pp, &nof_ops, code_size_log, 0, true);
+
+  // Replace the oldest entry
+  fast_ssc_schedule_t* s = &pp->cache[pp->cache_next];
+  pp->cache_next = (pp->cache_next + 1) % POLAR_FAST_SSC_CACHE_SIZE;
+
+  fast_ssc_op_t* ops = realloc(s->ops, SRSRAN_MAX(nof_ops, 1) * sizeof(fast_ssc_op_t));
+  if (ops == NULL) {
+    free(s->ops);
+    s->ops = NULL;
+    return NULL;
+  }
+  memcpy(ops, pp->ops, nof_ops * sizeof(fast_ssc_op_t));
+  memcpy(s->frozen_set, frozen_set, frozen_set_size * sizeof(uint16_t));
+  s->ops             = ops;
+  s->nof_ops         = nof_ops;
+  s->code_size_log   = code_size_log;
+  s->frozen_set_size = frozen_set_size;
+
+  return s;
+}
+
+int init_polar_decoder_fast_ssc_c(void*           p,
+                                  const int8_t*   input_llr,
+                                  uint8_t*        data_decoded,
+                                  const uint8_t   code_size_log,
+                                  const uint16_t* frozen_set,
+                                  const uint16_t  frozen_set_size)
+{
+  struct pFastSSC_c* pp = p;
+
+  if (p == NULL || code_size_log > pp->nMax) {
+    return -1;
+  }
+
+  pp->schedule = get_schedule(pp, frozen_set, frozen_set_size, code_size_log);
+  if (pp->schedule == NULL) {
+    return -1;
+  }
+
+  uint16_t code_size = (uint16_t)(1U << code_size_log);
+
+  // Rate-0 nodes rely on zeroed codeword and message bits
+  memset(data_decoded, 0, code_size);
+  memset(pp->est_bit, 0, code_size);
+
+  // The root LLRs are only read. The root stage changes with the code size, so the stages below it are pointed back to
+  // the LLR memory every time.
+  for (uint8_t s = 0; s < code_size_log; s++) {
+    pp->llr[s] = pp->llr_buffer + (1U << s) - 1;
+  }
+  pp->llr[code_size_log] = (int8_t*)input_llr;
+
+  return 0;
+}
+
+int polar_decoder_fast_ssc_c(void* p, uint8_t* message)
+{
+  struct pFastSSC_c* pp = p;
+
+  if (p == NULL || pp->schedule == NULL) {
+    return -1;
+  }
+
+  const fast_ssc_schedule_t* schedule = pp->schedule;
+  for (uint32_t i = 0; i < schedule->nof_ops; i++) {
+    const fast_ssc_op_t* op      = &schedule->ops[i];
+    uint8_t              stage   = op->stage;
+    uint16_t             bit_pos = op->bit_pos;
+    uint16_t             size    = (uint16_t)(1U << stage);
+    uint16_t             half    = size / 2;
+    int8_t*              llr     = pp->llr[stage];
+    uint8_t*             x       = pp->est_bit + bit_pos;
+
+    switch (op->type) {
+      case OP_F:
+        f_kernel(llr, llr + half, pp->llr[stage - 1], half);
+        break;
+      case OP_G:
+        g_kernel(x, llr, llr + half, pp->llr[stage - 1], half);
+        break;
+      case OP_G0:
+        g0_kernel(llr, llr + half, pp->llr[stage - 1], half);
+        break;
+      case OP_COMBINE:
+        for (uint16_t j = 0; j < half; j++) {
+          x[j] ^= x[j + half];
+        }
+        break;
+      case OP_RATE_1:
+        hard_bit_kernel(llr, x, size);
+        transform(x, message + bit_pos, size);
+        break;
+      case OP_REP:
+        rep_kernel(llr, x, message + bit_pos, size);
+        break;
+      case OP_SPC:
+        spc_kernel(llr, x, message + bit_pos, size);
+        break;
+      case OP_REP_SPC:
+        rep_spc_kernel(llr, x, message + bit_pos);
+        break;
+      default:
+        return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*!
+ * \file polar_decoder_fast_ssc_c.h
+ * \brief Declaration of the Fast-SSC polar decoder working with 8-bit integer-valued LLRs.
+ *
+ * \copyright Software Radio Systems Limited
+ *
+ */
+
+#ifndef POLAR_DECODER_FAST_SSC_C_H
+#define POLAR_DECODER_FAST_SSC_C_H
+
+#include <stdint.h>
+
+/*!
+ * \brief Number of decoding schedules (frozen sets) kept by a Fast-SSC decoder.
+ *
+ * PDCCH blind search alternates between a handful of (K, E) pairs per aggregation level and DCI size, all of them
+ * should stay in the cache.
+ */
+#define POLAR_FAST_SSC_CACHE_SIZE 16
+
+/*!
+ * Creates a Fast-SSC polar decoder structure and allocates memory for the decoding buffers and the schedule cache.
+ *
+ * \param[in] nMax \f$log_2\f$ of the maximum number of bits in the codeword.
+ * \return A pointer to the decoder if the function executes correctly, NULL otherwise.
+ */
+void* create_polar_decoder_fast_ssc_c(uint8_t nMax);
+
+/*!
+ * The (8-bit) Fast-SSC polar decoder "destructor": it frees all the resources allocated to the decoder.
+ *
+ * \param[in, out] p A pointer to the dismantled decoder.
+ */
+void delete_polar_decoder_fast_ssc_c(void* p);
+
+/*!
+ * Initializes an (8-bit) Fast-SSC polar decoder before processing a new codeword. The decoding schedule of the frozen
+ * set is taken from the cache, or compiled and cached if it is not there.
+ *
+ * \param[in, out] p A pointer to the decoder.
+ * \param[in] llr LLRs for the new codeword, they must remain valid until polar_decoder_fast_ssc_c() returns.
+ * \param[out] data_decoded Pointer to the decoded message.
+ * \param[in] code_size_log \f$log_2\f$ of the number of bits in the codeword.
+ * \param[in] frozen_set The position of the frozen bits in increasing order.
+ * \param[in] frozen_set_size The size of the frozen_set.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int init_polar_decoder_fast_ssc_c(void*           p,
+                                  const int8_t*   llr,
+                                  uint8_t*        data_decoded,
+                                  const uint8_t   code_size_log,
+                                  const uint16_t* frozen_set,
+                                  const uint16_t  frozen_set_size);
+
+/*!
+ * Decodes a data message from a 8 bit resolution codeword by running the schedule selected by
+ * init_polar_decoder_fast_ssc_c().
+ *
+ * \param[in] p A pointer to the decoder.
+ * \param[out] data The decoded message.
+ * \return An integer: 0 if the function executes correctly, -1 otherwise.
+ */
+int polar_decoder_fast_ssc_c(void* p, uint8_t* data);
+
+#endif // POLAR_DECODER_FAST_SSC_C_H
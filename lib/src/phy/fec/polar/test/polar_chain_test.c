@@ -44,6 +44,7 @@
  *  - <b>-s \<number\></b>  SNR [dB, Default 3.00 dB] -- Use 100 for scan, and 101 for noiseless.
  *  - <b>-o \<number\></b>  Print output results [Default 0] -- Use 0 for detailed, Use 1 for 1 line, Use 2 for vector
  * form.
+ *  - <b>-x</b> Only check that a single Fast-SSC decoder matches SSC when the code size changes between codewords.
  *
  * Example 1: BCH - ./polar_chain_test -n9 -k56 -e864 -i0 -s101 -o1
  *
@@ -102,13 +103,14 @@ static uint8_t  nMax         = 9;   /*!< \brief Maximum \f$log_2(N)\f$, where \f
 static uint8_t  bil          = 0;   /*!< \brief If bil = 0 channel interleaver disabled. */
 static double   snr_db       = 3;   /*!< \brief SNR in dB (101 for no noise, 100 for scan). */
 static int      print_output = 0;   /*!< \brief print output form (0 for detailed, 1 for one line, 2 for vector). */
+static int      size_switch  = 0;   /*!< \brief Run the Fast-SSC code size switch test only. */
 
 /*!
  * \brief Prints test help when a wrong parameter is passed as input.
  */
 void usage(char* prog)
 {
-  printf("Usage: %s [-nX] [-kX] [-eX] [-iX] [-sX] [-oX]\n", prog);
+  printf("Usage: %s [-nX] [-kX] [-eX] [-iX] [-sX] [-oX] [-x]\n", prog);
   printf("\t-n nMax [Default %d]\n", nMax);
   printf("\t-k Message size [Default %d]\n", K);
   printf("\t-e Rate matching size [Default %d]\n", E);
@@ -116,6 +118,7 @@ void usage(char* prog)
   printf("\t-s SNR [dB, Default %.2f dB] -- Use 100 for scan, and 101 for noiseless\n", snr_db);
   printf("\t-o Print output results [Default %d] -- Use 0 for detailed, Use 1 for 1 line, Use 2 for vector form\n",
          print_output);
+  printf("\t-x Only run the Fast-SSC code size switch test\n");
 }
 
 /*!
@@ -124,7 +127,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt = 0;
-  while ((opt = getopt(argc, argv, "n:k:e:i:s:o:")) != -1) {
+  while ((opt = getopt(argc, argv, "n:k:e:i:s:o:x")) != -1) {
     //  printf("opt : %d\n", opt);
     switch (opt) {
       case 'e':
@@ -145,6 +148,9 @@ void parse_args(int argc, char** argv)
       case 'o':
         print_output = (int)strtol(optarg, NULL, 10);
         break;
+      case 'x':
+        size_switch = 1;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -152,6 +158,108 @@ void parse_args(int argc, char** argv)
   }
 }
 
+/*!
+ * \brief Decodes noiseless codewords of alternating sizes with a single Fast-SSC decoder and checks that every
+ * decoded vector matches the SSC decoder. Switching from N = 512 to N = 128 and back exercises the schedule cache and
+ * the reuse of the decoder buffers sized for the larger code.
+ */
+static int test_fast_ssc_size_switch(void)
+{
+  const uint16_t list_K[] = {56, 40, 56, 36};
+  const uint16_t list_E[] = {864, 108, 864, 64};
+  const uint16_t list_N[] = {512, 128, 512, 64};
+  const uint8_t  n_max    = 9;
+  int            ret      = SRSRAN_ERROR;
+
+  srsran_polar_code_t    code;
+  srsran_polar_encoder_t enc;
+  srsran_polar_decoder_t dec_c;
+  srsran_polar_decoder_t dec_c_fast;
+  srsran_polar_rm_t      rm_tx;
+  srsran_polar_rm_t      rm_rx_c;
+
+  srsran_polar_code_init(&code);
+  srsran_polar_encoder_init(&enc, SRSRAN_POLAR_ENCODER_PIPELINED, n_max);
+  srsran_polar_rm_tx_init(&rm_tx);
+  srsran_polar_rm_rx_init_c(&rm_rx_c);
+  srsran_polar_decoder_init(&dec_c, SRSRAN_POLAR_DECODER_SSC_C, n_max);
+  srsran_polar_decoder_init(&dec_c_fast, SRSRAN_POLAR_DECODER_FAST_SSC_C, n_max);
+  srsran_random_t random_gen = srsran_random_init(0);
+
+  uint8_t* data        = srsran_vec_u8_malloc(NMAX);
+  uint8_t* data_rx     = srsran_vec_u8_malloc(NMAX);
+  uint8_t* input_enc   = srsran_vec_u8_malloc(NMAX);
+  uint8_t* output_enc  = srsran_vec_u8_malloc(NMAX);
+  uint8_t* rm_codeword = srsran_vec_u8_malloc(8192);
+  float*   rm_llr      = srsran_vec_f_malloc(8192);
+  int8_t*  rm_llr_c    = srsran_vec_i8_malloc(8192);
+  int8_t*  llr_c       = srsran_vec_i8_malloc(NMAX);
+  uint8_t* output_dec  = srsran_vec_u8_malloc(NMAX);
+  uint8_t* output_fast = srsran_vec_u8_malloc(NMAX);
+  if (!data || !data_rx || !input_enc || !output_enc || !rm_codeword || !rm_llr || !rm_llr_c || !llr_c ||
+      !output_dec || !output_fast) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  for (uint32_t c = 0; c < sizeof(list_K) / sizeof(list_K[0]); c++) {
+    uint16_t k = list_K[c];
+    uint16_t e = list_E[c];
+    if (srsran_polar_code_get(&code, k, e, n_max) == SRSRAN_ERROR || code.N != list_N[c]) {
+      ERROR("Unexpected polar code for K=%d, E=%d", k, e);
+      goto clean_exit;
+    }
+
+    for (uint32_t b = 0; b < BATCH_SIZE; b++) {
+      for (uint32_t i = 0; i < k; i++) {
+        data[i] = srsran_random_uniform_int_dist(random_gen, 0, 1);
+      }
+      srsran_polar_chanalloc_tx(data, input_enc, code.N, code.K, code.nPC, code.K_set, code.PC_set);
+      srsran_polar_encoder_encode(&enc, input_enc, output_enc, code.n);
+      srsran_polar_rm_tx(&rm_tx, output_enc, rm_codeword, code.n, e, k, 0);
+      for (uint32_t i = 0; i < e; i++) {
+        rm_llr[i] = rm_codeword[i] ? -1 : 1;
+      }
+      srsran_vec_quant_fc(rm_llr, rm_llr_c, 32, 0, 127, e);
+      srsran_polar_rm_rx_c(&rm_rx_c, rm_llr_c, llr_c, e, code.n, k, 0);
+
+      srsran_polar_decoder_decode_c(&dec_c, llr_c, output_dec, code.n, code.F_set, code.F_set_size);
+      srsran_polar_decoder_decode_c(&dec_c_fast, llr_c, output_fast, code.n, code.F_set, code.F_set_size);
+      if (memcmp(output_dec, output_fast, code.N) != 0) {
+        ERROR("Fast-SSC and SSC differ for K=%d, E=%d, N=%d after a code size change", k, e, code.N);
+        goto clean_exit;
+      }
+
+      srsran_polar_chanalloc_rx(output_fast, data_rx, code.K, code.nPC, code.K_set, code.PC_set);
+      if (srsran_bit_diff(data, data_rx, k) != 0) {
+        ERROR("Fast-SSC decoding error for K=%d, E=%d, N=%d after a code size change", k, e, code.N);
+        goto clean_exit;
+      }
+    }
+  }
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  free(data);
+  free(data_rx);
+  free(input_enc);
+  free(output_enc);
+  free(rm_codeword);
+  free(rm_llr);
+  free(rm_llr_c);
+  free(llr_c);
+  free(output_dec);
+  free(output_fast);
+  srsran_random_free(random_gen);
+  srsran_polar_decoder_free(&dec_c);
+  srsran_polar_decoder_free(&dec_c_fast);
+  srsran_polar_encoder_free(&enc);
+  srsran_polar_rm_tx_free(&rm_tx);
+  srsran_polar_rm_rx_free_c(&rm_rx_c);
+  srsran_polar_code_free(&code);
+  return ret;
+}
+
 /*!
  * \brief Main function.
  */
@@ -162,6 +270,7 @@ int main(int argc, char** argv)
   uint8_t* data_rx_s      = NULL;
   uint8_t* data_rx_c      = NULL;
   uint8_t* data_rx_c_avx2 = NULL;
+  uint8_t* data_rx_c_fast = NULL;
 
   uint8_t* input_enc       = NULL; // input encoder
   uint8_t* output_enc      = NULL; // output encoder
@@ -183,6 +292,7 @@ int main(int argc, char** argv)
   uint8_t* output_dec_s      = NULL; // output decoder
   uint8_t* output_dec_c      = NULL; // output decoder
   uint8_t* output_dec_c_avx2 = NULL; // output decoder
+  uint8_t* output_dec_c_fast = NULL; // output decoder
 
   double var[SNR_POINTS + 1];
 
@@ -193,9 +303,10 @@ int main(int argc, char** argv)
   int j          = 0;
   int snr_points = 0;
 
-  int errors_symb   = 0;
-  int errors_symb_s = 0;
-  int errors_symb_c = 0;
+  int errors_symb        = 0;
+  int errors_symb_s      = 0;
+  int errors_symb_c      = 0;
+  int errors_symb_c_fast = 0;
 #ifdef LV_HAVE_AVX2
   int errors_symb_c_avx2 = 0;
 #endif
@@ -204,6 +315,7 @@ int main(int argc, char** argv)
   int n_error_words_s[SNR_POINTS + 1];
   int n_error_words_c[SNR_POINTS + 1];
   int n_error_words_c_avx2[SNR_POINTS + 1];
+  int n_error_words_c_fast[SNR_POINTS + 1];
 
   int last_i_batch[SNR_POINTS + 1];
 
@@ -212,6 +324,7 @@ int main(int argc, char** argv)
   double         elapsed_time_dec_s[SNR_POINTS + 1];
   double         elapsed_time_dec_c[SNR_POINTS + 1];
   double         elapsed_time_dec_c_avx2[SNR_POINTS + 1];
+  double         elapsed_time_dec_c_fast[SNR_POINTS + 1];
 
   double elapsed_time_enc[SNR_POINTS + 1];
   double elapsed_time_enc_avx2[SNR_POINTS + 1];
@@ -228,8 +341,9 @@ int main(int argc, char** argv)
   srsran_polar_code_t    code;
   srsran_polar_encoder_t enc;
   srsran_polar_decoder_t dec;
-  srsran_polar_decoder_t dec_s; // 16-bit
-  srsran_polar_decoder_t dec_c; // 8-bit
+  srsran_polar_decoder_t dec_s;      // 16-bit
+  srsran_polar_decoder_t dec_c;      // 8-bit
+  srsran_polar_decoder_t dec_c_fast; // 8-bit Fast-SSC
   srsran_polar_rm_t      rm_tx;
   srsran_polar_rm_t      rm_rx_f;
   srsran_polar_rm_t      rm_rx_s;
@@ -242,6 +356,12 @@ int main(int argc, char** argv)
 
   parse_args(argc, argv);
 
+  if (size_switch) {
+    int ret = test_fast_ssc_size_switch();
+    printf("Fast-SSC code size switch test %s\n", ret == SRSRAN_SUCCESS ? "OK" : "FAILED");
+    exit(ret == SRSRAN_SUCCESS ? 0 : -1);
+  }
+
   // uinitialize polar code
   srsran_polar_code_init(&code);
 
@@ -269,6 +389,9 @@ int main(int argc, char** argv)
   // initialize a POLAR decoder (8 bit)
   srsran_polar_decoder_init(&dec_c, SRSRAN_POLAR_DECODER_SSC_C, nMax);
 
+  // initialize a POLAR decoder (8 bit, Fast-SSC)
+  srsran_polar_decoder_init(&dec_c_fast, SRSRAN_POLAR_DECODER_FAST_SSC_C, nMax);
+
 #ifdef LV_HAVE_AVX2
 
   // initialize encoder  avx2
@@ -288,6 +411,7 @@ int main(int argc, char** argv)
   data_rx_s      = srsran_vec_u8_malloc(K * BATCH_SIZE);
   data_rx_c      = srsran_vec_u8_malloc(K * BATCH_SIZE);
   data_rx_c_avx2 = srsran_vec_u8_malloc(K * BATCH_SIZE);
+  data_rx_c_fast = srsran_vec_u8_malloc(K * BATCH_SIZE);
 
   input_enc       = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_enc      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
@@ -309,10 +433,12 @@ int main(int argc, char** argv)
   output_dec_s      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_dec_c      = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
   output_dec_c_avx2 = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
+  output_dec_c_fast = srsran_vec_u8_malloc(NMAX * BATCH_SIZE);
 
   if (!data_tx || !data_rx || !data_rx_s || !data_rx_c || !data_rx_c_avx2 || !input_enc || !output_enc ||
       !output_enc_avx2 || !rm_codeword || !rm_llr || !rm_llr_s || !rm_llr_c || !rm_llr_c_avx2 || !llr || !llr_s ||
-      !llr_c || !llr_c_avx2 || !output_dec || !output_dec_s || !output_dec_c || !output_dec_c_avx2) {
+      !llr_c || !llr_c_avx2 || !output_dec || !output_dec_s || !output_dec_c || !output_dec_c_avx2 || !data_rx_c_fast ||
+      !output_dec_c_fast) {
     perror("malloc");
     exit(-1);
   }
@@ -359,11 +485,13 @@ int main(int argc, char** argv)
     elapsed_time_dec_s[i_snr]      = 0;
     elapsed_time_dec_c[i_snr]      = 0;
     elapsed_time_dec_c_avx2[i_snr] = 0;
+    elapsed_time_dec_c_fast[i_snr] = 0;
 
     n_error_words[i_snr]        = 0;
     n_error_words_s[i_snr]      = 0;
     n_error_words_c[i_snr]      = 0;
     n_error_words_c_avx2[i_snr] = 0;
+    n_error_words_c_fast[i_snr] = 0;
 
     int i_batch = 0;
     printf("\nBatch:\n  ");
@@ -472,7 +600,7 @@ int main(int argc, char** argv)
         srsran_ch_awgn_f(rm_llr, rm_llr, var[i_snr], BATCH_SIZE * E);
 
         // Convert symbols into LLRs
-        for (j = 0; j < BATCH_SIZE * code.N; j++) {
+        for (j = 0; j < BATCH_SIZE * E; j++) {
           rm_llr[j] *= 2 / (var[i_snr] * var[i_snr]);
         }
       }
@@ -591,6 +719,31 @@ int main(int argc, char** argv)
         }
       }
 
+      // 8-bit Fast-SSC decoding, same input as the 8-bit SSC decoder
+      gettimeofday(&t[1], NULL);
+      for (j = 0; j < BATCH_SIZE; j++) {
+        srsran_polar_decoder_decode_c(
+            &dec_c_fast, llr_c + j * code.N, output_dec_c_fast + j * code.N, code.n, code.F_set, code.F_set_size);
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      elapsed_time_dec_c_fast[i_snr] += t[0].tv_sec + 1e-6 * t[0].tv_usec;
+
+      // extract message bits
+      for (j = 0; j < BATCH_SIZE; j++) {
+        srsran_polar_chanalloc_rx(
+            output_dec_c_fast + j * code.N, data_rx_c_fast + j * K, code.K, code.nPC, code.K_set, code.PC_set);
+      }
+
+      // check errors 8-bits Fast-SSC decoder
+      for (int i = 0; i < BATCH_SIZE; i++) {
+        errors_symb_c_fast = srsran_bit_diff(data_tx + i * K, data_rx_c_fast + i * K, K);
+
+        if (errors_symb_c_fast != 0) {
+          n_error_words_c_fast[i_snr]++;
+        }
+      }
+
 #ifdef LV_HAVE_AVX2
       // 8-bit avx2 decoding
       // 8-bit quantization
@@ -663,6 +816,12 @@ int main(int argc, char** argv)
       }
       printf("];\n");
 
+      printf("WER_8_FAST=[");
+      for (int i_snr = 0; i_snr < snr_points; i_snr++) {
+        printf("%e ", (float)n_error_words_c_fast[i_snr] / last_i_batch[i_snr] / BATCH_SIZE);
+      }
+      printf("];\n");
+
 #ifdef LV_HAVE_AVX2
       printf("WER_8_AVX2=[");
       for (int i_snr = 0; i_snr < snr_points; i_snr++) {
@@ -697,6 +856,12 @@ int main(int argc, char** argv)
                n_error_words_c[i_snr],
                last_i_batch[i_snr] * BATCH_SIZE * code.N,
                last_i_batch[i_snr] * BATCH_SIZE * code.N / (1000000 * elapsed_time_dec_c[i_snr]));
+        printf("SNR: %3.1f\t INT8-FAST  WER: %.8f %d/%d \t dec_thrput(Mbps): %.2f\n",
+               snr_db_vec[i_snr],
+               (double)n_error_words_c_fast[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_c_fast[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N,
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / (1000000 * elapsed_time_dec_c_fast[i_snr]));
 #ifdef LV_HAVE_AVX2
         printf("SNR: %3.1f\t INT8-AVX2  WER: %.8f %d/%d \t dec_thrput(Mbps): %.2f\n",
                snr_db_vec[i_snr],
@@ -757,6 +922,16 @@ int main(int argc, char** argv)
                last_i_batch[i_snr] * BATCH_SIZE * K / elapsed_time_dec_c[i_snr],
                last_i_batch[i_snr] * BATCH_SIZE * code.N / elapsed_time_dec_c[i_snr]);
 
+        printf("\n**** FIXED POINT (8 bits, Fast-SSC) ****");
+        printf("\nEstimated word error rate:\n  %e (%d errors)\n",
+               (double)n_error_words_c_fast[i_snr] / last_i_batch[i_snr] / BATCH_SIZE,
+               n_error_words_c_fast[i_snr]);
+
+        printf("Estimated throughput decoder:\n  %e word/s\n  %e bit/s (information)\n  %e bit/s (encoded)\n",
+               last_i_batch[i_snr] * BATCH_SIZE / elapsed_time_dec_c_fast[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * K / elapsed_time_dec_c_fast[i_snr],
+               last_i_batch[i_snr] * BATCH_SIZE * code.N / elapsed_time_dec_c_fast[i_snr]);
+
 #ifdef LV_HAVE_AVX2
         printf("\n**** FIXED POINT (8 bits, AVX2) ****");
         printf("\nEstimated word error rate:\n  %e (%d errors)\n",
@@ -801,6 +976,8 @@ int main(int argc, char** argv)
   free(output_dec_c_avx2);
   free(output_enc_avx2);
   free(data_rx_c_avx2);
+  free(output_dec_c_fast);
+  free(data_rx_c_fast);
 
 #ifdef DATA_ALL_ONES
 #else
@@ -812,6 +989,7 @@ int main(int argc, char** argv)
   srsran_polar_decoder_free(&dec);
   srsran_polar_decoder_free(&dec_s);
   srsran_polar_decoder_free(&dec_c);
+  srsran_polar_decoder_free(&dec_c_fast);
   srsran_polar_rm_rx_free_f(&rm_rx_f);
   srsran_polar_rm_rx_free_s(&rm_rx_s);
   srsran_polar_rm_rx_free_c(&rm_rx_c);
@@ -845,6 +1023,13 @@ int main(int argc, char** argv)
     }
     printf("\r");
 
+    if (n_error_words_c_fast[0] > expected_errors) {
+      printf("\n(8 bit, Fast-SSC) Test failed!\n\n");
+    } else {
+      printf("\n(8 bit, Fast-SSC) Test completed successfully!\n\n");
+    }
+    printf("\r");
+
 #ifdef LV_HAVE_AVX2
     if (n_error_words_c_avx2[0] > expected_errors) {
       printf("\n(8 bit, avx2) Test failed!\n\n");
@@ -855,7 +1040,7 @@ int main(int argc, char** argv)
     printf("\r");
 
     exit((n_error_words[0] > expected_errors) || (n_error_words_s[0] > expected_errors) ||
-         (n_error_words_c[0] > expected_errors)
+         (n_error_words_c[0] > expected_errors) || (n_error_words_c_fast[0] > expected_errors)
 #ifdef LV_HAVE_AVX2
          || (n_error_words_c_avx2[0] > expected_errors)
 #endif // LV_HAVE_AVX2
@@ -871,6 +1056,10 @@ int main(int argc, char** argv)
         perror("8-bit performance at SNR = %d too low!");
         exit(-1);
       }
+      if (n_error_words_c_fast[i_snr] > 10 * n_error_words[i_snr]) {
+        perror("8-bit Fast-SSC performance at SNR = %d too low!");
+        exit(-1);
+      }
 #ifdef LV_HAVE_AVX2
       if (n_error_words_c_avx2[i_snr] > 10 * n_error_words[i_snr]) {
         perror("8-bit avx2 performance at SNR = %d too low!");
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -33,6 +34,7 @@
 int      num_bits = 5001, crc_length = 24;
 uint32_t crc_poly = 0x1864CFB;
 uint32_t seed     = 1;
+int      nof_reps = 0;
 
 void usage(char* prog)
 {
@@ -41,13 +43,14 @@ void usage(char* prog)
   printf("\t-l crc_length [Default %d]\n", crc_length);
   printf("\t-p crc_poly (Hex) [Default 0x%x]\n", crc_poly);
   printf("\t-s seed [Default 0=time]\n");
+  printf("\t-t benchmark repetitions [Default %d, 0 skips the benchmark]\n", nof_reps);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "nlpsv")) != -1) {
+  while ((opt = getopt(argc, argv, "nlpstv")) != -1) {
     switch (opt) {
       case 'n':
         num_bits = (int)strtol(argv[optind], NULL, 10);
@@ -61,6 +64,9 @@ void parse_args(int argc, char** argv)
       case 's':
         seed = (uint32_t)strtoul(argv[optind], NULL, 0);
         break;
+      case 't':
+        nof_reps = (int)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -71,6 +77,95 @@ void parse_args(int argc, char** argv)
   }
 }
 
+// Bit at a time, independent of the tables
+static uint32_t crc_checksum_bitwise(uint32_t poly, int order, const uint8_t* data, int len)
+{
+  uint64_t highbit = (uint64_t)1 << (order - 1);
+  uint64_t mask    = (highbit << 1) - 1;
+  uint64_t crc     = 0;
+  for (int i = 0; i < len; i++) {
+    bool feedback = ((crc & highbit) != 0) ^ (data[i] != 0);
+    crc           = (crc << 1) & mask;
+    if (feedback) {
+      crc ^= poly & mask;
+    }
+  }
+  return (uint32_t)crc;
+}
+
+// Byte at a time through the public single table with scalar packing, as before the sliced engine
+static uint32_t crc_checksum_bytewise(srsran_crc_t* h, uint8_t* data, int len)
+{
+  srsran_crc_set_init(h, 0);
+  uint8_t* ptr = data;
+  for (int i = 0; i < len / 8; i++) {
+    srsran_crc_checksum_put_byte(h, (uint8_t)srsran_bit_pack(&ptr, 8));
+  }
+  return (uint32_t)srsran_crc_checksum_get(h);
+}
+
+// Every length up to num_bits must match the bitwise reference, with every engine the CPU has
+static int check_lengths(srsran_crc_t* h, uint8_t* data)
+{
+  bool has_pclmul = h->use_pclmul;
+  for (int engine = 0; engine < (has_pclmul ? 2 : 1); engine++) {
+    h->use_pclmul = engine == 1;
+    for (int len = 0; len <= num_bits; len++) {
+      uint32_t word = srsran_crc_checksum(h, data, len);
+      if (word != crc_checksum_bitwise(crc_poly, crc_length, data, len)) {
+        ERROR("CRC mismatch for %d bits (%s)", len, h->use_pclmul ? "pclmul" : "slice-by-8");
+        h->use_pclmul = has_pclmul;
+        return SRSRAN_ERROR;
+      }
+    }
+  }
+  h->use_pclmul = has_pclmul;
+  return SRSRAN_SUCCESS;
+}
+
+static double get_mbps(struct timeval t[3])
+{
+  get_time_interval(t);
+  return (double)num_bits * nof_reps / (t[0].tv_sec * 1e6 + t[0].tv_usec);
+}
+
+static void benchmark(srsran_crc_t* h, uint8_t* data)
+{
+  struct timeval    t[3];
+  volatile uint32_t sink       = 0;
+  bool              has_pclmul = h->use_pclmul;
+
+  // Only whole bytes, the byte-wise reference does not take partial ones
+  int len = num_bits - num_bits % 8;
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < nof_reps; i++) {
+    sink ^= crc_checksum_bytewise(h, data, len);
+  }
+  gettimeofday(&t[2], NULL);
+  printf("byte-wise:  %.1f Mbps\n", get_mbps(t));
+
+  h->use_pclmul = false;
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < nof_reps; i++) {
+    sink ^= srsran_crc_checksum(h, data, len);
+  }
+  gettimeofday(&t[2], NULL);
+  printf("slice-by-8: %.1f Mbps\n", get_mbps(t));
+
+  if (has_pclmul) {
+    h->use_pclmul = true;
+    gettimeofday(&t[1], NULL);
+    for (int i = 0; i < nof_reps; i++) {
+      sink ^= srsran_crc_checksum(h, data, len);
+    }
+    gettimeofday(&t[2], NULL);
+    printf("pclmul:     %.1f Mbps\n", get_mbps(t));
+  }
+  h->use_pclmul = has_pclmul;
+  (void)sink;
+}
+
 int main(int argc, char** argv)
 {
   int          i;
@@ -106,11 +201,26 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
-  // generate CRC word
-  crc_word = srsran_crc_checksum(&crc_p, data, num_bits);
+  // generate CRC word, the CRC object is left as it was
+  uint64_t crcinit = crc_p.crcinit;
+  crc_word         = srsran_crc_checksum(&crc_p, data, num_bits);
+  if (crc_p.crcinit != crcinit) {
+    ERROR("The checksum modified the CRC init value");
+    free(data);
+    exit(-1);
+  }
 
   INFO("checksum=%x", crc_word);
 
+  if (check_lengths(&crc_p, data) < SRSRAN_SUCCESS) {
+    free(data);
+    exit(-1);
+  }
+
+  if (nof_reps > 0) {
+    benchmark(&crc_p, data);
+  }
+
   free(data);
 
   // check if generated word is as expected
@@ -113,13 +113,15 @@ static int pbch_nr_init_decoder(srsran_pbch_nr_t* q, const srsran_pbch_nr_args_t
     return SRSRAN_SUCCESS;
   }
 
-  srsran_polar_decoder_type_t decoder_type = SRSRAN_POLAR_DECODER_SSC_C;
-
+  srsran_polar_decoder_type_t decoder_type = SRSRAN_POLAR_DECODER_FAST_SSC_C;
+  if (args->disable_fast_ssc) {
+    decoder_type = SRSRAN_POLAR_DECODER_SSC_C;
 #ifdef LV_HAVE_AVX2
-  if (!args->disable_simd) {
-    decoder_type = SRSRAN_POLAR_DECODER_SSC_C_AVX2;
-  }
+    if (!args->disable_simd) {
+      decoder_type = SRSRAN_POLAR_DECODER_SSC_C_AVX2;
+    }
 #endif /* LV_HAVE_AVX2 */
+  }
 
   if (srsran_polar_decoder_init(&q->polar_decoder, decoder_type, PBCH_NR_POLAR_N_MAX) < SRSRAN_SUCCESS) {
     ERROR("Error initiating polar decoder");
@@ -226,13 +226,16 @@ int srsran_pdcch_nr_init_rx(srsran_pdcch_nr_t* q, const srsran_pdcch_nr_args_t*
     return SRSRAN_ERROR;
   }
 
-  srsran_polar_decoder_type_t decoder_type = SRSRAN_POLAR_DECODER_SSC_C;
-
+  // Fast-SSC outruns the AVX2 SSC decoder on DCI sized codes, blind search runs it for every candidate
+  srsran_polar_decoder_type_t decoder_type = SRSRAN_POLAR_DECODER_FAST_SSC_C;
+  if (args->disable_fast_ssc) {
+    decoder_type = SRSRAN_POLAR_DECODER_SSC_C;
 #ifdef LV_HAVE_AVX2
-  if (!args->disable_simd) {
-    decoder_type = SRSRAN_POLAR_DECODER_SSC_C_AVX2;
-  }
+    if (!args->disable_simd) {
+      decoder_type = SRSRAN_POLAR_DECODER_SSC_C_AVX2;
+    }
 #endif // LV_HAVE_AVX2
+  }
 
   if (srsran_polar_decoder_init(&q->decoder, decoder_type, NMAX_LOG) < SRSRAN_SUCCESS) {
     return SRSRAN_ERROR;
@@ -500,9 +503,9 @@ int srsran_pdcch_nr_encode(srsran_pdcch_nr_t* q, const srsran_dci_msg_nr_t* dci_
   srsran_vec_u8_copy(c, dci_msg->payload, dci_msg->nof_bits);
 
   // Append CRC
-  srsran_crc_attach(&q->crc24c, q->c, q->K);
+  uint32_t checksum = srsran_crc_attach(&q->crc24c, q->c, q->K);
 
-  PDCCH_INFO_TX("Append CRC %06x", (uint32_t)srsran_crc_checksum_get(&q->crc24c));
+  PDCCH_INFO_TX("Append CRC %06x", checksum);
 
   // Unpack RNTI
   uint8_t  unpacked_rnti[16] = {};
@@ -21,6 +21,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
 #include <string.h>
 
 #include "srsran/phy/common/phy_common.h"
@@ -433,21 +434,33 @@ void print(void* d, uint32_t size, uint32_t len, char* file_str)
   fclose(f);
 }
 
-/// Calculates the FFT of the specified sequence index if not previously done and returns a pointer to the result.
-static cf_t* get_precoded_dft(srsran_prach_t* p, uint32_t idx)
-{
-  assert(idx < 64 && "Invalid idx value");
-  // Generate FFT for this sequence if it does not exist yet.
-  uint64_t gen_mask = (uint64_t)1 << idx;
-  if (!(p->dft_gen_bitmap & gen_mask)) {
-    srsran_dft_run(&p->zc_fft, p->seqs[idx], p->dft_seqs[idx]);
-    p->dft_gen_bitmap |= gen_mask;
-  }
-
-  return p->dft_seqs[idx];
-}
-
-int srsran_prach_gen_seqs(srsran_prach_t* p)
+struct srsran_prach_seq_table_s {
+  // Key
+  uint32_t N_zc;
+  uint32_t rsi;
+  uint32_t N_cs;
+  bool     hs;
+
+  uint32_t refcount;
+  struct srsran_prach_seq_table_s* next;
+
+  // Preamble i is root sequence u[i] cyclically shifted by C_v[i]
+  uint32_t u[N_SEQS];
+  uint32_t C_v[N_SEQS];
+  uint32_t root_seqs_idx[N_SEQS];
+  uint32_t N_roots;
+
+  // Generated on first use, guarded by mutex
+  pthread_mutex_t mutex;
+  cf_t*           seqs[N_SEQS];
+  cf_t*           dft_seqs[N_SEQS];
+};
+
+static pthread_mutex_t           prach_seq_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+static srsran_prach_seq_table_t* prach_seq_tables       = NULL;
+
+/// Finds the root sequence and cyclic shift of the 64 preambles, TS 36.211 Section 5.7.2
+static void prach_seq_table_gen_shifts(srsran_prach_seq_table_t* t)
 {
   uint32_t u           = 0;
   uint32_t v           = 1;
@@ -459,50 +472,45 @@ int srsran_prach_gen_seqs(srsran_prach_t* p)
   int      N_neg_shift = 0;
   uint32_t N_group     = 0;
   uint32_t C_v         = 0;
-  cf_t     root[839];
 
-  // Generate our 64 preamble sequences
   for (int i = 0; i < N_SEQS; i++) {
     if (v > v_max) {
       // Get a new root sequence
-      if (4 == p->f) {
-        u = prach_zc_roots_format4[(p->rsi + p->N_roots) % 138];
+      if (SRSRAN_PRACH_N_ZC_SHORT == t->N_zc) {
+        u = prach_zc_roots_format4[(t->rsi + t->N_roots) % 138];
       } else {
-        u = prach_zc_roots[(p->rsi + p->N_roots) % 838];
+        u = prach_zc_roots[(t->rsi + t->N_roots) % 838];
       }
 
-      // Generate actual sequence
-      prach_cexp(p->N_zc, u, root);
-
-      p->root_seqs_idx[p->N_roots++] = i;
+      t->root_seqs_idx[t->N_roots++] = i;
 
       // Determine v_max
-      if (p->hs) {
+      if (t->hs) {
         // High-speed cell
-        for (p_ = 1; p_ <= p->N_zc; p_++) {
-          if (((p_ * u) % p->N_zc) == 1)
+        for (p_ = 1; p_ <= t->N_zc; p_++) {
+          if (((p_ * u) % t->N_zc) == 1)
             break;
         }
-        if (p_ < p->N_zc / 2) {
+        if (p_ < t->N_zc / 2) {
           d_u = p_;
         } else {
-          d_u = p->N_zc - p_;
+          d_u = t->N_zc - p_;
         }
-        if (d_u >= p->N_cs && d_u < p->N_zc / 3) {
-          N_shift = d_u / p->N_cs;
-          d_start = 2 * d_u + N_shift * p->N_cs;
-          N_group = p->N_zc / d_start;
-          if (p->N_zc > 2 * d_u + N_group * d_start) {
-            N_neg_shift = (p->N_zc - 2 * d_u - N_group * d_start) / p->N_cs;
+        if (d_u >= t->N_cs && d_u < t->N_zc / 3) {
+          N_shift = d_u / t->N_cs;
+          d_start = 2 * d_u + N_shift * t->N_cs;
+          N_group = t->N_zc / d_start;
+          if (t->N_zc > 2 * d_u + N_group * d_start) {
+            N_neg_shift = (t->N_zc - 2 * d_u - N_group * d_start) / t->N_cs;
           } else {
             N_neg_shift = 0;
           }
-        } else if (p->N_zc / 3 <= d_u && d_u <= (p->N_zc - p->N_cs) / 2) {
-          N_shift = (p->N_zc - 2 * d_u) / p->N_cs;
-          d_start = p->N_zc - 2 * d_u + N_shift * p->N_cs;
+        } else if (t->N_zc / 3 <= d_u && d_u <= (t->N_zc - t->N_cs) / 2) {
+          N_shift = (t->N_zc - 2 * d_u) / t->N_cs;
+          d_start = t->N_zc - 2 * d_u + N_shift * t->N_cs;
           N_group = d_u / d_start;
           if (d_u > N_group * d_start) {
-            N_neg_shift = (d_u - N_group * d_start) / p->N_cs;
+            N_neg_shift = (d_u - N_group * d_start) / t->N_cs;
           } else {
             N_neg_shift = 0;
           }
@@ -517,36 +525,158 @@ int srsran_prach_gen_seqs(srsran_prach_t* p)
         }
       } else {
         // Normal cell
-        if (0 == p->N_cs) {
+        if (0 == t->N_cs) {
           v_max = 0;
         } else {
-          v_max = (p->N_zc / p->N_cs) - 1;
+          v_max = (t->N_zc / t->N_cs) - 1;
         }
       }
 
       v = 0;
     }
 
-    // Shift root and add to set
-    if (p->hs) {
+    // Shift of the root
+    if (t->hs) {
       if (N_shift == 0) {
         C_v = 0;
       } else {
-        C_v = d_start * floor(v / N_shift) + (v % N_shift) * p->N_cs;
+        C_v = d_start * floor(v / N_shift) + (v % N_shift) * t->N_cs;
       }
     } else {
-      C_v = v * p->N_cs;
+      C_v = v * t->N_cs;
+    }
+
+    t->u[i]   = u;
+    t->C_v[i] = C_v;
+
+    v++;
+  }
+}
+
+/// Takes a reference to the table of the current configuration of p, creating it if no other object uses it
+static srsran_prach_seq_table_t* prach_seq_table_get(const srsran_prach_t* p)
+{
+  pthread_mutex_lock(&prach_seq_tables_mutex);
+
+  srsran_prach_seq_table_t* t = prach_seq_tables;
+  while (t != NULL && !(t->N_zc == p->N_zc && t->rsi == p->rsi && t->N_cs == p->N_cs && t->hs == p->hs)) {
+    t = t->next;
+  }
+
+  if (t == NULL) {
+    t = calloc(1, sizeof(srsran_prach_seq_table_t));
+    if (t == NULL) {
+      pthread_mutex_unlock(&prach_seq_tables_mutex);
+      return NULL;
+    }
+    t->N_zc = p->N_zc;
+    t->rsi  = p->rsi;
+    t->N_cs = p->N_cs;
+    t->hs   = p->hs;
+    pthread_mutex_init(&t->mutex, NULL);
+    prach_seq_table_gen_shifts(t);
+
+    t->next          = prach_seq_tables;
+    prach_seq_tables = t;
+  }
+  t->refcount++;
+
+  pthread_mutex_unlock(&prach_seq_tables_mutex);
+  return t;
+}
+
+/// Releases a reference, the last one frees the table
+static void prach_seq_table_put(srsran_prach_seq_table_t* t)
+{
+  if (t == NULL) {
+    return;
+  }
+
+  pthread_mutex_lock(&prach_seq_tables_mutex);
+  if (--t->refcount > 0) {
+    pthread_mutex_unlock(&prach_seq_tables_mutex);
+    return;
+  }
+
+  srsran_prach_seq_table_t** prev = &prach_seq_tables;
+  while (*prev != t) {
+    prev = &(*prev)->next;
+  }
+  *prev = t->next;
+  pthread_mutex_unlock(&prach_seq_tables_mutex);
+
+  for (uint32_t i = 0; i < N_SEQS; i++) {
+    free(t->seqs[i]);
+    free(t->dft_seqs[i]);
+  }
+  pthread_mutex_destroy(&t->mutex);
+  free(t);
+}
+
+/// Generates sequence idx if not previously done, the table mutex must be held
+static cf_t* prach_seq_table_seq(srsran_prach_seq_table_t* t, uint32_t idx)
+{
+  if (t->seqs[idx] == NULL) {
+    cf_t* seq = srsran_vec_cf_malloc(t->N_zc);
+    if (seq == NULL) {
+      return NULL;
     }
 
     // Copy shifted sequence, equivalent to:
-    // for (int j = 0; j < p->N_zc; j++) {
-    //      p->seqs[i][j] = root[(j + C_v) % p->N_zc];
+    // for (int j = 0; j < N_zc; j++) {
+    //      seq[j] = root[(j + C_v) % N_zc];
     // }
-    srsran_vec_cf_copy(p->seqs[i], &root[C_v], p->N_zc - C_v);
-    srsran_vec_cf_copy(&p->seqs[i][p->N_zc - C_v], root, C_v);
+    cf_t     root[SRSRAN_PRACH_N_ZC_LONG];
+    uint32_t C_v = t->C_v[idx];
+    prach_cexp(t->N_zc, t->u[idx], root);
+    srsran_vec_cf_copy(seq, &root[C_v], t->N_zc - C_v);
+    srsran_vec_cf_copy(&seq[t->N_zc - C_v], root, C_v);
+    t->seqs[idx] = seq;
+  }
+  return t->seqs[idx];
+}
 
-    v++;
+/// Calculates the FFT of the specified sequence index if not previously done and returns a pointer to the result.
+static cf_t* get_precoded_dft(srsran_prach_t* p, uint32_t idx)
+{
+  assert(idx < 64 && "Invalid idx value");
+  if (p->dft_seqs[idx] != NULL) {
+    return p->dft_seqs[idx];
+  }
+  srsran_prach_seq_table_t* t = p->seq_table;
+
+  // Generate FFT for this sequence if it does not exist yet.
+  pthread_mutex_lock(&t->mutex);
+  if (t->dft_seqs[idx] == NULL) {
+    cf_t* seq     = prach_seq_table_seq(t, idx);
+    cf_t* dft_seq = srsran_vec_cf_malloc(t->N_zc);
+    if (seq != NULL && dft_seq != NULL) {
+      srsran_dft_run(&p->zc_fft, seq, dft_seq);
+      t->dft_seqs[idx] = dft_seq;
+    } else {
+      free(dft_seq);
+    }
   }
+  pthread_mutex_unlock(&t->mutex);
+
+  assert(t->dft_seqs[idx] != NULL && "Error allocating PRACH sequence");
+  p->dft_seqs[idx] = t->dft_seqs[idx];
+  return p->dft_seqs[idx];
+}
+
+int srsran_prach_gen_seqs(srsran_prach_t* p)
+{
+  srsran_prach_seq_table_t* t = prach_seq_table_get(p);
+  if (t == NULL) {
+    ERROR("Error allocating PRACH sequence table");
+    return SRSRAN_ERROR;
+  }
+  prach_seq_table_put(p->seq_table);
+  p->seq_table = t;
+  memset(p->dft_seqs, 0, sizeof(p->dft_seqs));
+
+  memcpy(p->root_seqs_idx, t->root_seqs_idx, sizeof(p->root_seqs_idx));
+  p->N_roots = t->N_roots;
   return 0;
 }
 
@@ -640,7 +770,6 @@ int srsran_prach_set_cell_(srsran_prach_t*      p,
     p->detect_factor           = PRACH_DETECT_FACTOR;
     p->num_ra_preambles        = cfg->num_ra_preambles;
     p->successive_cancellation = cfg->enable_successive_cancellation;
-    p->dft_gen_bitmap          = 0;
     if (p->successive_cancellation && cfg->zero_corr_zone != 0) {
       printf("successive cancellation only currently supported with zero_correlation_zone_config of 0 - disabling\n");
       p->successive_cancellation = false;
@@ -688,9 +817,10 @@ int srsran_prach_set_cell_(srsran_prach_t*      p,
       }
     }
 
-    // Generate our 64 sequences
-    p->N_roots = 0;
-    srsran_prach_gen_seqs(p);
+    // Look up our 64 sequences, they are generated as they are used
+    if (srsran_prach_gen_seqs(p)) {
+      return SRSRAN_ERROR;
+    }
     // Ensure num_ra_preambles is valid, if not assign default value
     if (p->num_ra_preambles < 4 || p->num_ra_preambles > p->N_roots) {
       p->num_ra_preambles = p->N_roots;
@@ -792,6 +922,116 @@ int srsran_prach_gen(srsran_prach_t* p, uint32_t seq_index, uint32_t freq_offset
   return ret;
 }
 
+/// (Re)plans the batched IFFT for the current N_ifft_prach
+static int prach_gen_batch_plan(srsran_prach_t* p)
+{
+  if (p->ifft_batch_size == p->N_ifft_prach) {
+    return SRSRAN_SUCCESS;
+  }
+
+  srsran_dft_plan_free(&p->ifft_batch);
+  free(p->ifft_batch_in);
+  free(p->ifft_batch_out);
+  p->ifft_batch_size = 0;
+
+  p->ifft_batch_in  = srsran_vec_cf_malloc(p->N_ifft_prach * SRSRAN_PRACH_GEN_BATCH_MAX);
+  p->ifft_batch_out = srsran_vec_cf_malloc(p->N_ifft_prach * SRSRAN_PRACH_GEN_BATCH_MAX);
+  if (p->ifft_batch_in == NULL || p->ifft_batch_out == NULL) {
+    ERROR("Error allocating memory");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_dft_plan_guru_c(&p->ifft_batch,
+                             (int)p->N_ifft_prach,
+                             SRSRAN_DFT_BACKWARD,
+                             p->ifft_batch_in,
+                             p->ifft_batch_out,
+                             1,
+                             1,
+                             SRSRAN_PRACH_GEN_BATCH_MAX,
+                             (int)p->N_ifft_prach,
+                             (int)p->N_ifft_prach) < SRSRAN_SUCCESS) {
+    ERROR("Error creating DFT plan");
+    return SRSRAN_ERROR;
+  }
+
+  p->ifft_batch_size = p->N_ifft_prach;
+  return SRSRAN_SUCCESS;
+}
+
+int srsran_prach_gen_batch(srsran_prach_t*  p,
+                           const uint32_t* seq_indices,
+                           uint32_t        nof_seqs,
+                           uint32_t        freq_offset,
+                           cf_t**          signals)
+{
+  if (p == NULL || seq_indices == NULL || signals == NULL) {
+    return SRSRAN_ERROR;
+  }
+
+  // Calculate parameters, same as srsran_prach_gen()
+  uint32_t N_rb_ul = srsran_nof_prb(p->N_ifft_ul);
+  uint32_t k_0     = freq_offset * N_RB_SC - N_rb_ul * N_RB_SC / 2 + p->N_ifft_ul / 2;
+  uint32_t K       = DELTA_F / DELTA_F_RA;
+  uint32_t begin   = PHI + (K * k_0) + (p->is_nr ? 0 : (K / 2));
+
+  if (6 + freq_offset > N_rb_ul) {
+    ERROR("Error no space for PRACH: frequency offset=%d, N_rb_ul=%d", freq_offset, N_rb_ul);
+    return SRSRAN_ERROR;
+  }
+
+  if (prach_gen_batch_plan(p) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t N    = p->N_ifft_prach;
+  uint32_t len  = p->N_cp + p->N_seq;
+  float    norm = 1.0 / sqrtf(N);
+
+  // The plan does not mirror, so the sequence is mapped straight into the swapped bins: bin k goes to k - N/2 modulo N
+  uint32_t hlen  = N / 2;
+  uint32_t start = (begin + N - hlen) % N;
+  uint32_t n_lo  = SRSRAN_MIN(p->N_zc, N - start);
+
+  for (uint32_t b = 0; b < nof_seqs; b += SRSRAN_PRACH_GEN_BATCH_MAX) {
+    uint32_t nof_batch = SRSRAN_MIN(nof_seqs - b, SRSRAN_PRACH_GEN_BATCH_MAX);
+
+    for (uint32_t i = 0; i < nof_batch; i++) {
+      if (seq_indices[b + i] >= N_SEQS || signals[b + i] == NULL) {
+        ERROR("Invalid preamble index %d or output buffer", seq_indices[b + i]);
+        return SRSRAN_ERROR;
+      }
+      cf_t* in  = &p->ifft_batch_in[N * i];
+      cf_t* seq = get_precoded_dft(p, seq_indices[b + i]);
+      srsran_vec_cf_zero(in, N);
+      srsran_vec_cf_copy(&in[start], seq, n_lo);
+      srsran_vec_cf_copy(in, &seq[n_lo], p->N_zc - n_lo);
+    }
+
+    srsran_dft_run_guru_c(&p->ifft_batch);
+
+    for (uint32_t i = 0; i < nof_batch; i++) {
+      const cf_t* out    = &p->ifft_batch_out[N * i];
+      cf_t*       signal = signals[b + i];
+
+      // CP and periodic extension in one pass, sample j of the preamble is IFFT output (j - N_cp) modulo N
+      uint32_t idx = (N - p->N_cp % N) % N;
+      for (uint32_t j = 0; j < len;) {
+        uint32_t n = SRSRAN_MIN(N - idx, len - j);
+        srsran_vec_sc_prod_cfc(&out[idx], norm, &signal[j], n);
+        j += n;
+        idx = 0;
+      }
+
+      if (p->td_signals[seq_indices[b + i]]) {
+        srsran_vec_cf_copy(p->td_signals[seq_indices[b + i]], signal, len);
+      }
+    }
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 void srsran_prach_set_detect_factor(srsran_prach_t* p, float ratio)
 {
   p->detect_factor = ratio;
@@ -867,6 +1107,44 @@ void srsran_prach_calculate_correction_array(srsran_prach_t* p, cf_t* corr_freq)
 }
 
 // This function carries out the main processing on the incomming PRACH signal
+static int prach_detect_batch_plan(srsran_prach_t* p)
+{
+  if (p->zc_batch_size == p->N_zc) {
+    return SRSRAN_SUCCESS;
+  }
+
+  srsran_dft_plan_free(&p->zc_ifft_batch);
+  p->zc_batch_size = 0;
+
+  // Buffers fit the long sequence, only the plan depends on N_zc
+  if (p->zc_batch_in == NULL) {
+    p->zc_batch_in   = srsran_vec_cf_malloc(SRSRAN_PRACH_N_ZC_LONG * SRSRAN_PRACH_DETECT_BATCH_MAX);
+    p->zc_batch_out  = srsran_vec_cf_malloc(SRSRAN_PRACH_N_ZC_LONG * SRSRAN_PRACH_DETECT_BATCH_MAX);
+    p->zc_batch_corr = srsran_vec_f_malloc(SRSRAN_PRACH_N_ZC_LONG * SRSRAN_PRACH_DETECT_BATCH_MAX);
+    if (p->zc_batch_in == NULL || p->zc_batch_out == NULL || p->zc_batch_corr == NULL) {
+      ERROR("Error allocating memory");
+      return SRSRAN_ERROR;
+    }
+  }
+
+  if (srsran_dft_plan_guru_c(&p->zc_ifft_batch,
+                             (int)p->N_zc,
+                             SRSRAN_DFT_BACKWARD,
+                             p->zc_batch_in,
+                             p->zc_batch_out,
+                             1,
+                             1,
+                             SRSRAN_PRACH_DETECT_BATCH_MAX,
+                             (int)p->N_zc,
+                             (int)p->N_zc) < SRSRAN_SUCCESS) {
+    ERROR("Error creating DFT plan");
+    return SRSRAN_ERROR;
+  }
+
+  p->zc_batch_size = p->N_zc;
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_prach_process(srsran_prach_t* p,
                          cf_t*           signal,
                          uint32_t*       indices,
@@ -879,55 +1157,70 @@ int srsran_prach_process(srsran_prach_t* p,
 {
   float max_to_cancel = 0;
   cancellation_idx    = -1;
-  int max_idx         = 0;
+
+  if (prach_detect_batch_plan(p)) {
+    return SRSRAN_ERROR;
+  }
+
+  uint32_t winsize = 0;
+  if (p->N_cs != 0) {
+    winsize = p->N_cs;
+  } else {
+    winsize = p->N_zc;
+  }
+  uint32_t n_wins = p->N_zc / winsize;
+
   srsran_vec_cf_zero(p->cross, p->N_zc);
   srsran_vec_cf_zero(p->corr_freq, p->N_zc);
-  for (int i = 0; i < p->num_ra_preambles; i++) {
-    cf_t* root_spec = get_precoded_dft(p, p->root_seqs_idx[i]);
-
-    srsran_vec_prod_conj_ccc(p->prach_bins, root_spec, p->corr_spec, p->N_zc);
+  for (uint32_t batch = 0; batch < p->num_ra_preambles; batch += SRSRAN_PRACH_DETECT_BATCH_MAX) {
+    uint32_t nof_roots = SRSRAN_MIN(SRSRAN_PRACH_DETECT_BATCH_MAX, p->num_ra_preambles - batch);
 
-    srsran_vec_prod_conj_ccc(p->corr_spec, &p->corr_spec[1], p->cross, p->N_zc - 1);
-    if (p->successive_cancellation) {
-      srsran_vec_cf_copy(p->corr_freq, p->corr_spec, p->N_zc);
+    // Correlate all root sequences of the batch in a single IFFT run
+    for (uint32_t b = 0; b < nof_roots; b++) {
+      cf_t* root_spec = get_precoded_dft(p, p->root_seqs_idx[batch + b]);
+      srsran_vec_prod_conj_ccc(p->prach_bins, root_spec, &p->zc_batch_in[b * p->N_zc], p->N_zc);
     }
-    srsran_dft_run(&p->zc_ifft, p->corr_spec, p->corr_spec);
+    srsran_dft_run_guru_c(&p->zc_ifft_batch);
+    srsran_vec_abs_square_cf(p->zc_batch_out, p->zc_batch_corr, nof_roots * p->N_zc);
 
-    srsran_vec_abs_square_cf(p->corr_spec, p->corr, p->N_zc);
+    for (uint32_t b = 0; b < nof_roots; b++) {
+      uint32_t i         = batch + b;
+      cf_t*    corr_spec = &p->zc_batch_in[b * p->N_zc];
+      float*   corr      = &p->zc_batch_corr[b * p->N_zc];
 
-    float corr_ave = srsran_vec_acc_ff(p->corr, p->N_zc) / p->N_zc;
+      float corr_ave  = srsran_vec_acc_ff(corr, p->N_zc) / p->N_zc;
+      float threshold = p->detect_factor * corr_ave;
 
-    uint32_t winsize = 0;
-    if (p->N_cs != 0) {
-      winsize = p->N_cs;
-    } else {
-      winsize = p->N_zc;
-    }
-    uint32_t n_wins = p->N_zc / winsize;
-
-    float max_peak = 0;
-    for (int j = 0; j < n_wins; j++) {
-      uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
-      uint32_t end   = start + winsize;
-      if (end > p->deadzone) {
-        end -= p->deadzone;
-      }
-      start += p->deadzone;
-      p->peak_values[j] = 0;
-      for (int k = start; k < end; k++) {
-        if (p->corr[k] > p->peak_values[j]) {
-          p->peak_values[j]  = p->corr[k];
-          p->peak_offsets[j] = k - start;
-          if (p->peak_values[j] > max_peak) {
-            max_peak = p->peak_values[j];
-            max_idx  = k;
-          }
+      float max_peak = 0;
+      for (int j = 0; j < n_wins; j++) {
+        uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
+        uint32_t end   = start + winsize;
+        if (end > p->deadzone) {
+          end -= p->deadzone;
         }
+        start += p->deadzone;
+        p->peak_values[j] = 0;
+        if (end > start) {
+          uint32_t k         = srsran_vec_max_fi(&corr[start], end - start);
+          p->peak_values[j]  = corr[start + k];
+          p->peak_offsets[j] = k;
+        }
+        max_peak = SRSRAN_MAX(max_peak, p->peak_values[j]);
       }
-    }
-    if (max_peak > (p->detect_factor * corr_ave)) {
+      if (max_peak <= threshold) {
+        continue;
+      }
+
+      // Only needed for detected roots, both are taken from the spectrum before the IFFT
+      if (t_offsets && p->freq_domain_offset_calc) {
+        srsran_vec_prod_conj_ccc(corr_spec, &corr_spec[1], p->cross, p->N_zc - 1);
+      }
+      if (p->successive_cancellation) {
+        srsran_vec_cf_copy(p->corr_freq, corr_spec, p->N_zc);
+      }
+
       for (int j = 0; j < n_wins; j++) {
-        if (p->peak_values[j] > p->detect_factor * corr_ave) {
+        if (p->peak_values[j] > threshold) {
           if (indices) {
             if (p->successive_cancellation) {
               if (max_peak > max_to_cancel) {
@@ -1024,6 +1317,14 @@ int srsran_prach_free(srsran_prach_t* p)
   srsran_dft_plan_free(&p->fft);
   srsran_dft_plan_free(&p->zc_fft);
   srsran_dft_plan_free(&p->zc_ifft);
+  srsran_dft_plan_free(&p->ifft_batch);
+  free(p->ifft_batch_in);
+  free(p->ifft_batch_out);
+  srsran_dft_plan_free(&p->zc_ifft_batch);
+  free(p->zc_batch_in);
+  free(p->zc_batch_out);
+  free(p->zc_batch_corr);
+  prach_seq_table_put(p->seq_table);
 
   if (p->signal_fft) {
     free(p->signal_fft);
@@ -1040,12 +1341,17 @@ int srsran_prach_free(srsran_prach_t* p)
 
 int srsran_prach_print_seqs(srsran_prach_t* p)
 {
+  srsran_prach_seq_table_t* t = p->seq_table;
+  for (int i = 0; i < N_SEQS; i++) {
+    get_precoded_dft(p, i);
+  }
+
   for (int i = 0; i < N_SEQS; i++) {
     FILE* f;
     char  str[32];
     sprintf(str, "prach_seq_%d.bin", i);
     f = fopen(str, "wb");
-    fwrite(p->seqs[i], sizeof(cf_t), p->N_zc, f);
+    fwrite(t->seqs[i], sizeof(cf_t), p->N_zc, f);
     fclose(f);
   }
   for (int i = 0; i < N_SEQS; i++) {
@@ -1053,7 +1359,7 @@ int srsran_prach_print_seqs(srsran_prach_t* p)
     char  str[32];
     sprintf(str, "prach_dft_seq_%d.bin", i);
     f = fopen(str, "wb");
-    fwrite(p->dft_seqs[i], sizeof(cf_t), p->N_zc, f);
+    fwrite(t->dft_seqs[i], sizeof(cf_t), p->N_zc, f);
     fclose(f);
   }
   for (int i = 0; i < p->N_roots; i++) {
@@ -1061,7 +1367,7 @@ int srsran_prach_print_seqs(srsran_prach_t* p)
     char  str[32];
     sprintf(str, "prach_root_seq_%d.bin", i);
     f = fopen(str, "wb");
-    fwrite(p->seqs[p->root_seqs_idx[i]], sizeof(cf_t), p->N_zc, f);
+    fwrite(t->seqs[p->root_seqs_idx[i]], sizeof(cf_t), p->N_zc, f);
     fclose(f);
   }
   return 0;
@@ -28,10 +28,53 @@
 #include "srsran/phy/utils/bit.h"
 #include "srsran/phy/utils/debug.h"
 #include "srsran/phy/utils/vector.h"
+#include <pthread.h>
+#include <semaphore.h>
 
 #define SCH_INFO_TX(...) INFO("SCH Tx: " __VA_ARGS__)
 #define SCH_INFO_RX(...) INFO("SCH Rx: " __VA_ARGS__)
 
+/**
+ * @brief Decoding job of a single code block, the inputs are set before the job is handed out and the outputs are
+ * written by whichever thread claims it
+ */
+typedef struct {
+  uint32_t      r;      ///< Code block index
+  uint32_t      E;      ///< Number of rate matched bits
+  const int8_t* input;  ///< Rate matched LLR
+  int           ret;    ///< Decoder return, 0 if the CRC did not match
+  uint32_t      n_iter; ///< Number of LDPC iterations
+} sch_nr_cb_job_t;
+
+/**
+ * @brief Code blocks of one transport block, claimed one at a time by the caller and the coworkers
+ */
+typedef struct {
+  const srsran_sch_nr_tb_info_t* cfg;
+  const srsran_sch_tb_t*         tb;
+  sch_nr_cb_job_t*               jobs;
+  uint32_t                       nof_jobs;
+  uint32_t                       next_job;
+} sch_nr_cb_batch_t;
+
+/**
+ * @brief Decoding thread, it owns a receive-only SCH object so that decoders, rate matching and CRC state are never
+ * shared with the caller
+ */
+typedef struct {
+  srsran_sch_nr_t    sch;
+  pthread_t          pthread;
+  sem_t              start;
+  sem_t              finish;
+  bool               quit;
+  sch_nr_cb_batch_t* batch;
+} sch_nr_coworker_t;
+
+typedef struct {
+  sch_nr_coworker_t* coworkers;
+  uint32_t           nof_coworkers;
+} sch_nr_coworkers_t;
+
 srsran_basegraph_t srsran_sch_nr_select_basegraph(uint32_t tbs, double R)
 {
   // if A ≤ 292 , or if A ≤ 3824 and R ≤ 0.67 , or if R ≤ 0 . 25 , LDPC base graph 2 is used;
@@ -280,6 +323,97 @@ int srsran_sch_nr_init_tx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
   return SRSRAN_SUCCESS;
 }
 
+static void sch_nr_run_jobs(srsran_sch_nr_t* q, sch_nr_cb_batch_t* batch);
+
+static void* sch_nr_coworker_thread(void* arg)
+{
+  sch_nr_coworker_t* h = (sch_nr_coworker_t*)arg;
+
+  sem_wait(&h->start);
+  while (!h->quit) {
+    sch_nr_run_jobs(&h->sch, h->batch);
+
+    sem_post(&h->finish);
+    sem_wait(&h->start);
+  }
+
+  return NULL;
+}
+
+static void sch_nr_disable_coworkers(srsran_sch_nr_t* q)
+{
+  sch_nr_coworkers_t* h = (sch_nr_coworkers_t*)q->coworkers_ptr;
+  if (!h) {
+    return;
+  }
+
+  // Only the coworkers counted in nof_coworkers have a running thread
+  for (uint32_t i = 0; i < h->nof_coworkers; i++) {
+    sch_nr_coworker_t* w = &h->coworkers[i];
+    w->quit              = true;
+    sem_post(&w->start);
+    pthread_join(w->pthread, NULL);
+
+    sem_destroy(&w->start);
+    sem_destroy(&w->finish);
+    srsran_sch_nr_free(&w->sch);
+  }
+
+  free(h->coworkers);
+  free(h);
+  q->coworkers_ptr = NULL;
+}
+
+static int sch_nr_enable_coworkers(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
+{
+  sch_nr_coworkers_t* h = SRSRAN_MEM_ALLOC(sch_nr_coworkers_t, 1);
+  if (!h) {
+    ERROR("Error: calloc");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(h, sch_nr_coworkers_t, 1);
+  q->coworkers_ptr = h;
+
+  h->coworkers = SRSRAN_MEM_ALLOC(sch_nr_coworker_t, args->nof_coworkers);
+  if (!h->coworkers) {
+    ERROR("Error: calloc");
+    return SRSRAN_ERROR;
+  }
+  SRSRAN_MEM_ZERO(h->coworkers, sch_nr_coworker_t, args->nof_coworkers);
+
+  // Coworkers decode with the same arguments but never spawn threads of their own
+  srsran_sch_nr_args_t coworker_args = *args;
+  coworker_args.nof_coworkers        = 0;
+
+  for (uint32_t i = 0; i < args->nof_coworkers; i++) {
+    sch_nr_coworker_t* w = &h->coworkers[i];
+
+    if (srsran_sch_nr_init_rx(&w->sch, &coworker_args) < SRSRAN_SUCCESS) {
+      ERROR("Error: initialising SCH coworker %d", i);
+      srsran_sch_nr_free(&w->sch);
+      return SRSRAN_ERROR;
+    }
+
+    if (sem_init(&w->start, 0, 0) || sem_init(&w->finish, 0, 0)) {
+      ERROR("Error: creating SCH coworker semaphores");
+      srsran_sch_nr_free(&w->sch);
+      return SRSRAN_ERROR;
+    }
+
+    if (pthread_create(&w->pthread, NULL, sch_nr_coworker_thread, w)) {
+      ERROR("Error: creating SCH coworker thread");
+      sem_destroy(&w->start);
+      sem_destroy(&w->finish);
+      srsran_sch_nr_free(&w->sch);
+      return SRSRAN_ERROR;
+    }
+
+    h->nof_coworkers++;
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
 {
   int ret = sch_nr_init_common(q);
@@ -356,6 +490,10 @@ int srsran_sch_nr_init_rx(srsran_sch_nr_t* q, const srsran_sch_nr_args_t* args)
     return SRSRAN_ERROR;
   }
 
+  if (args->nof_coworkers > 0 && sch_nr_enable_coworkers(q, args) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
   return SRSRAN_SUCCESS;
 }
 
@@ -377,6 +515,8 @@ void srsran_sch_nr_free(srsran_sch_nr_t* q)
     return;
   }
 
+  sch_nr_disable_coworkers(q);
+
   if (q->temp_cb) {
     free(q->temp_cb);
   }
@@ -507,8 +647,8 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
 
       // Attach code block CRC if required
       if (cfg.L_cb) {
-        srsran_crc_attach(&q->crc_cb, q->temp_cb, (int)(cfg.Kp - cfg.L_cb));
-        SCH_INFO_TX("CB %d: CRC=%06x", r, (uint32_t)srsran_crc_checksum_get(&q->crc_cb));
+        uint32_t checksum = srsran_crc_attach(&q->crc_cb, q->temp_cb, (int)(cfg.Kp - cfg.L_cb));
+        SCH_INFO_TX("CB %d: CRC=%06x", r, checksum);
       }
 
       // Insert filler bits
@@ -551,6 +691,67 @@ static inline int sch_nr_encode(srsran_sch_nr_t*        q,
   return SRSRAN_SUCCESS;
 }
 
+static int sch_nr_decode_cb(srsran_sch_nr_t*               q,
+                            const srsran_sch_nr_tb_info_t* cfg,
+                            const srsran_sch_tb_t*         tb,
+                            sch_nr_cb_job_t*               job)
+{
+  srsran_ldpc_decoder_t* decoder   = (cfg->bg == BG1) ? q->decoder_bg1[cfg->Z] : q->decoder_bg2[cfg->Z];
+  int8_t*                rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[job->r];
+
+  // LDPC Rate matching
+  int n_llr = srsran_ldpc_rm_rx_c(
+      &q->rx_rm, job->input, rm_buffer, job->E, cfg->F, cfg->bg, cfg->Z, tb->rv, tb->mod, cfg->Nref);
+  if (n_llr < SRSRAN_SUCCESS) {
+    ERROR("Error in LDPC rate mateching");
+    return SRSRAN_ERROR;
+  }
+
+  // Select CB or TB early stop CRC
+  srsran_crc_t* crc = (cfg->L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
+  if (cfg->L_cb) {
+    crc = &q->crc_cb;
+  }
+
+  // Decode. if CRC=KO, then ret=0
+  int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
+  if (ret < SRSRAN_SUCCESS) {
+    ERROR("Error decoding CB");
+    return SRSRAN_ERROR;
+  }
+
+  // Compute number of iterations
+  job->n_iter = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
+
+  // Check if CB is all zeros
+  uint32_t cb_len = cfg->Kp - cfg->L_cb;
+
+  tb->softbuffer.rx->cb_crc[job->r] = (ret != 0);
+
+  // CB Debug trace
+  if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
+    DEBUG("CB %d/%d:", job->r, cfg->C);
+    srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+  }
+
+  // Pack only if CRC is match
+  if (tb->softbuffer.rx->cb_crc[job->r]) {
+    srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[job->r], cb_len);
+  }
+
+  return ret;
+}
+
+static void sch_nr_run_jobs(srsran_sch_nr_t* q, sch_nr_cb_batch_t* batch)
+{
+  // The semaphores that hand the batch over order these accesses, the counter itself only needs to be atomic
+  uint32_t i = __atomic_fetch_add(&batch->next_job, 1, __ATOMIC_RELAXED);
+  while (i < batch->nof_jobs) {
+    batch->jobs[i].ret = sch_nr_decode_cb(q, batch->cfg, batch->tb, &batch->jobs[i]);
+    i                  = __atomic_fetch_add(&batch->next_job, 1, __ATOMIC_RELAXED);
+  }
+}
+
 static int sch_nr_decode(srsran_sch_nr_t*        q,
                          const srsran_sch_cfg_t* sch_cfg,
                          const srsran_sch_tb_t*  tb,
@@ -607,8 +808,10 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
   uint32_t cb_ok = 0;
   res->crc       = false;
 
-  // For each code block...
-  uint32_t j = 0;
+  // Lay out the code blocks that need decoding and their rate matched input
+  sch_nr_cb_job_t jobs[SRSRAN_SCH_NR_MAX_NOF_CB_LDPC];
+  uint32_t        nof_jobs = 0;
+  uint32_t        j        = 0;
   for (uint32_t r = 0; r < cfg.C; r++) {
     bool    decoded   = tb->softbuffer.rx->cb_crc[r];
     int8_t* rm_buffer = (int8_t*)tb->softbuffer.tx->buffer_b[r];
@@ -637,7 +840,6 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
       continue;
     }
 
-    // LDPC Rate matching
     SCH_INFO_RX("RM CB %d: E=%d; F=%d; BG=%d; Z=%d; RV=%d; Qm=%d; Nref=%d;",
                 r,
                 E,
@@ -647,50 +849,46 @@ static int sch_nr_decode(srsran_sch_nr_t*        q,
                 tb->rv,
                 cfg.Qm,
                 cfg.Nref);
-    int n_llr =
-        srsran_ldpc_rm_rx_c(&q->rx_rm, input_ptr, rm_buffer, E, cfg.F, cfg.bg, cfg.Z, tb->rv, tb->mod, cfg.Nref);
-    if (n_llr < SRSRAN_SUCCESS) {
-      ERROR("Error in LDPC rate mateching");
-      return SRSRAN_ERROR;
-    }
-
-    // Select CB or TB early stop CRC
-    srsran_crc_t* crc = (cfg.L_tb == 16) ? &q->crc_tb_16 : &q->crc_tb_24;
-    if (cfg.L_cb) {
-      crc = &q->crc_cb;
-    }
-
-    // Decode. if CRC=KO, then ret=0
-    int ret = srsran_ldpc_decoder_decode_crc_c(decoder, rm_buffer, q->temp_cb, n_llr, crc);
-    if (ret < SRSRAN_SUCCESS) {
-      ERROR("Error decoding CB");
-      return SRSRAN_ERROR;
-    }
 
-    // Compute number of iterations
-    uint32_t n_iter_cb = (ret == 0) ? decoder->max_nof_iter : (uint32_t)ret;
-    nof_iter_sum += n_iter_cb;
+    jobs[nof_jobs].r     = r;
+    jobs[nof_jobs].E     = E;
+    jobs[nof_jobs].input = input_ptr;
+    nof_jobs++;
 
-    // Check if CB is all zeros
-    uint32_t cb_len = cfg.Kp - cfg.L_cb;
+    input_ptr += E;
+  }
 
-    tb->softbuffer.rx->cb_crc[r] = (ret != 0);
-    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg.C, n_iter_cb, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
+  // Decode, handing code blocks to the coworkers when there is more than one
+  sch_nr_cb_batch_t   batch         = {&cfg, tb, jobs, nof_jobs, 0};
+  sch_nr_coworkers_t* h             = (sch_nr_coworkers_t*)q->coworkers_ptr;
+  uint32_t            nof_coworkers = 0;
+  if (h && nof_jobs > 1) {
+    nof_coworkers = SRSRAN_MIN(h->nof_coworkers, nof_jobs - 1);
+  }
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    h->coworkers[i].batch = &batch;
+    sem_post(&h->coworkers[i].start);
+  }
+  sch_nr_run_jobs(q, &batch);
+  for (uint32_t i = 0; i < nof_coworkers; i++) {
+    sem_wait(&h->coworkers[i].finish);
+  }
 
-    // CB Debug trace
-    if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_DEBUG && !is_handler_registered()) {
-      DEBUG("CB %d/%d:", r, cfg.C);
-      srsran_vec_fprint_hex(stdout, q->temp_cb, cb_len);
+  // Gather the results in code block order
+  for (uint32_t i = 0; i < nof_jobs; i++) {
+    if (jobs[i].ret < SRSRAN_SUCCESS) {
+      return SRSRAN_ERROR;
     }
 
-    // Pack and count CRC OK only if CRC is match
+    uint32_t r = jobs[i].r;
+    nof_iter_sum += jobs[i].n_iter;
+    SCH_INFO_RX("CB %d/%d iter=%d CRC=%s", r, cfg.C, jobs[i].n_iter, tb->softbuffer.rx->cb_crc[r] ? "OK" : "KO");
+
     if (tb->softbuffer.rx->cb_crc[r]) {
-      srsran_bit_pack_vector(q->temp_cb, tb->softbuffer.rx->data[r], cb_len);
       cb_ok++;
     }
-
-    input_ptr += E;
   }
+
   // Set average number of iterations
   res->avg_iter = (float)nof_iter_sum / (float)cfg.C;
 
@@ -130,6 +130,97 @@ int main(int argc, char** argv)
       return -1;
   }
 
+  // The batched correlation IFFT of the detector must match the per root IFFT, using the bins of the last preamble
+  cf_t* corr_ref = srsran_vec_cf_malloc(prach.N_zc);
+  if (corr_ref == NULL) {
+    return -1;
+  }
+  for (uint32_t batch = 0; batch < prach.num_ra_preambles; batch += SRSRAN_PRACH_DETECT_BATCH_MAX) {
+    uint32_t nof_roots = SRSRAN_MIN(SRSRAN_PRACH_DETECT_BATCH_MAX, prach.num_ra_preambles - batch);
+    for (uint32_t b = 0; b < nof_roots; b++) {
+      cf_t* root_spec = prach.dft_seqs[prach.root_seqs_idx[batch + b]];
+      srsran_vec_prod_conj_ccc(prach.prach_bins, root_spec, &prach.zc_batch_in[b * prach.N_zc], prach.N_zc);
+    }
+    srsran_dft_run_guru_c(&prach.zc_ifft_batch);
+
+    for (uint32_t b = 0; b < nof_roots; b++) {
+      srsran_dft_run(&prach.zc_ifft, &prach.zc_batch_in[b * prach.N_zc], corr_ref);
+      float ref_power = srsran_vec_avg_power_cf(corr_ref, prach.N_zc);
+      srsran_vec_sub_ccc(corr_ref, &prach.zc_batch_out[b * prach.N_zc], corr_ref, prach.N_zc);
+      float err = srsran_vec_avg_power_cf(corr_ref, prach.N_zc);
+      if (err > 1e-10f * ref_power) {
+        ERROR("Batched correlation of preamble %d mismatch, relative error power %e", batch + b, err / ref_power);
+        return -1;
+      }
+    }
+  }
+  free(corr_ref);
+
+  // The batched generator must match the one by one generator
+  uint32_t prach_len = prach.N_cp + prach.N_seq;
+  uint32_t seq_indices[64];
+  cf_t*    batch[64];
+  cf_t*    arena = srsran_vec_cf_malloc(64 * prach_len);
+  if (arena == NULL) {
+    return -1;
+  }
+  for (seq_index = 0; seq_index < 64; seq_index++) {
+    seq_indices[seq_index] = seq_index;
+    batch[seq_index]       = &arena[seq_index * prach_len];
+  }
+
+  gettimeofday(&t[1], NULL);
+  if (srsran_prach_gen_batch(&prach, seq_indices, 64, 0, batch)) {
+    ERROR("Error generating PRACH batch");
+    return -1;
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("It took %ld microseconds to generate 64 preambles in batch\n", t[0].tv_usec + t[0].tv_sec * 1000000UL);
+
+  gettimeofday(&t[1], NULL);
+  for (seq_index = 0; seq_index < 64; seq_index++) {
+    srsran_prach_gen(&prach, seq_index, 0, preamble);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  printf("It took %ld microseconds to generate 64 preambles one by one\n", t[0].tv_usec + t[0].tv_sec * 1000000UL);
+
+  for (seq_index = 0; seq_index < 64; seq_index++) {
+    srsran_prach_gen(&prach, seq_index, 0, preamble);
+    srsran_vec_sub_ccc(preamble, batch[seq_index], preamble, prach_len);
+    float err = srsran_vec_avg_power_cf(preamble, prach_len);
+    if (err > 1e-10f) {
+      ERROR("Batch preamble %d mismatch, error power %e", seq_index, err);
+      return -1;
+    }
+  }
+  free(arena);
+
+  // A second object with the same configuration shares the sequence table
+  srsran_prach_t prach2;
+  if (srsran_prach_init(&prach2, srsran_symbol_sz(nof_prb))) {
+    return -1;
+  }
+  if (srsran_prach_set_cfg(&prach2, &prach_cfg, nof_prb)) {
+    ERROR("Error initiating PRACH object");
+    return -1;
+  }
+  if (prach2.seq_table != prach.seq_table) {
+    ERROR("PRACH sequence table is not shared");
+    return -1;
+  }
+  cf_t preamble2[MAX_LEN];
+  for (seq_index = 0; seq_index < 64; seq_index++) {
+    srsran_prach_gen(&prach, seq_index, 0, preamble);
+    srsran_prach_gen(&prach2, seq_index, 0, preamble2);
+    if (memcmp(preamble, preamble2, sizeof(cf_t) * prach_len) != 0) {
+      ERROR("Preamble %d differs between PRACH objects", seq_index);
+      return -1;
+    }
+  }
+  srsran_prach_free(&prach2);
+
   srsran_prach_free(&prach);
 
   printf("Done\n");
@@ -26,13 +26,17 @@
 #include "srsran/phy/utils/vector.h"
 #include <getopt.h>
 #include <srsran/phy/utils/random.h>
+#include <sys/time.h>
 
 static srsran_carrier_nr_t carrier = SRSRAN_DEFAULT_CARRIER_NR;
 
-static uint32_t            n_prb     = 0;  // Set to 0 for steering
-static uint32_t            mcs       = 30; // Set to 30 for steering
-static uint32_t            rv        = 4;  // Set to 30 for steering
-static srsran_sch_cfg_nr_t pdsch_cfg = {};
+static uint32_t            n_prb             = 0;  // Set to 0 for steering
+static uint32_t            mcs               = 30; // Set to 30 for steering
+static uint32_t            rv                = 4;  // Set to 30 for steering
+static uint32_t            nof_coworkers     = 0;
+static uint32_t            bench_nof_threads = 0; // Set to 0 to skip the benchmark
+static uint32_t            bench_nof_tb      = 100;
+static srsran_sch_cfg_nr_t pdsch_cfg         = {};
 
 static void usage(char* prog)
 {
@@ -44,13 +48,17 @@ static void usage(char* prog)
   printf("\t-T Provide MCS table (64qam, 256qam, 64qamLowSE) [Default %s]\n",
          srsran_mcs_table_to_str(pdsch_cfg.sch_cfg.mcs_table));
   printf("\t-L Provide number of layers [Default %d]\n", carrier.max_mimo_layers);
+  printf("\t-t Number of decoder coworker threads [Default %d]\n", nof_coworkers);
+  printf("\t-B Benchmark decoding the last grant with 1 up to this many threads, 0 to skip [Default %d]\n",
+         bench_nof_threads);
+  printf("\t-N Number of TB decoded per benchmark point [Default %d]\n", bench_nof_tb);
   printf("\t-v [set srsran_verbose to debug, default none]\n");
 }
 
 int parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "PpmTLvr")) != -1) {
+  while ((opt = getopt(argc, argv, "PpmTLvrtBN")) != -1) {
     switch (opt) {
       case 'P':
         carrier.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -70,6 +78,15 @@ int parse_args(int argc, char** argv)
       case 'L':
         carrier.max_mimo_layers = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 't':
+        nof_coworkers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'B':
+        bench_nof_threads = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'N':
+        bench_nof_tb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         increase_srsran_verbose_level();
         break;
@@ -82,6 +99,58 @@ int parse_args(int argc, char** argv)
   return SRSRAN_SUCCESS;
 }
 
+// Decodes the same TB with an increasing number of threads and prints the throughput of each
+static int benchmark(const srsran_sch_nr_args_t* args,
+                     srsran_sch_tb_t*            tb,
+                     int8_t*                     llr,
+                     uint8_t*                    data_rx,
+                     srsran_softbuffer_rx_t*     softbuffer_rx)
+{
+  double base_us = 0.0;
+
+  for (uint32_t nof_threads = 1; nof_threads <= bench_nof_threads; nof_threads++) {
+    srsran_sch_nr_t      sch_nr     = {};
+    srsran_sch_nr_args_t bench_args = *args;
+    bench_args.nof_coworkers        = nof_threads - 1;
+    if (srsran_sch_nr_init_rx(&sch_nr, &bench_args) < SRSRAN_SUCCESS || srsran_sch_nr_set_carrier(&sch_nr, &carrier)) {
+      ERROR("Error initiating SCH NR for benchmark");
+      srsran_sch_nr_free(&sch_nr);
+      return SRSRAN_ERROR;
+    }
+
+    tb->softbuffer.rx = softbuffer_rx;
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+    for (uint32_t i = 0; i < bench_nof_tb; i++) {
+      srsran_softbuffer_rx_reset(softbuffer_rx);
+
+      srsran_sch_tb_res_nr_t res = {};
+      res.payload                = data_rx;
+      if (srsran_dlsch_nr_decode(&sch_nr, &pdsch_cfg.sch_cfg, tb, llr, &res) < SRSRAN_SUCCESS) {
+        ERROR("Error decoding in benchmark");
+        srsran_sch_nr_free(&sch_nr);
+        return SRSRAN_ERROR;
+      }
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    srsran_sch_nr_free(&sch_nr);
+
+    double tb_us = (double)(t[0].tv_sec * 1000000 + t[0].tv_usec) / (double)SRSRAN_MAX(bench_nof_tb, 1);
+    if (nof_threads == 1) {
+      base_us = tb_us;
+    }
+    printf("threads=%d; TBS=%d; %.1f us/TB; %.1f Mbps; speedup=%.2f\n",
+           nof_threads,
+           tb->tbs,
+           tb_us,
+           (double)tb->tbs / tb_us,
+           base_us / tb_us);
+  }
+
+  return SRSRAN_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   int             ret       = SRSRAN_ERROR;
@@ -115,7 +184,9 @@ int main(int argc, char** argv)
     goto clean_exit;
   }
 
-  if (srsran_sch_nr_init_rx(&sch_nr_rx, &args) < SRSRAN_SUCCESS) {
+  srsran_sch_nr_args_t rx_args = args;
+  rx_args.nof_coworkers        = nof_coworkers;
+  if (srsran_sch_nr_init_rx(&sch_nr_rx, &rx_args) < SRSRAN_SUCCESS) {
     ERROR("Error initiating SCH NR for Rx");
     goto clean_exit;
   }
@@ -173,6 +244,8 @@ int main(int argc, char** argv)
     mcs_end   = SRSRAN_MIN(mcs + 1, mcs_end);
   }
 
+  // The last grant is kept, with its LLR, for the benchmark
+  srsran_sch_tb_t tb = {};
   for (n_prb = n_prb_start; n_prb < n_prb_end; n_prb++) {
     for (mcs = mcs_start; mcs < mcs_end; mcs++) {
       for (rv = rv_start; rv < rv_end; rv++) {
@@ -181,8 +254,8 @@ int main(int argc, char** argv)
         }
         pdsch_cfg.grant.nof_dmrs_cdm_groups_without_data = 1; // No need for MIMO
 
-        srsran_sch_tb_t tb = {};
-        tb.rv              = rv;
+        tb    = (srsran_sch_tb_t){};
+        tb.rv = rv;
         if (srsran_ra_nr_fill_tb(&pdsch_cfg, &pdsch_cfg.grant, mcs, &tb) < SRSRAN_SUCCESS) {
           ERROR("Error filing tb");
           goto clean_exit;
@@ -234,6 +307,10 @@ int main(int argc, char** argv)
     }
   }
 
+  if (bench_nof_threads > 0 && benchmark(&args, &tb, llr, data_rx, &softbuffer_rx) < SRSRAN_SUCCESS) {
+    goto clean_exit;
+  }
+
   ret = SRSRAN_SUCCESS;
 
 clean_exit:
@@ -719,8 +719,8 @@ uci_nr_encode_11_1706_bit(srsran_uci_nr_t* q, const srsran_uci_cfg_nr_t* cfg, ui
     }
 
     // Attach CRC
-    srsran_crc_attach(crc, q->c, A_prime / C);
-    UCI_NR_INFO_TX("Attaching %d/%d CRC%d=%" PRIx64, r, C, L, srsran_crc_checksum_get(crc));
+    uint32_t checksum = srsran_crc_attach(crc, q->c, A_prime / C);
+    UCI_NR_INFO_TX("Attaching %d/%d CRC%d=%" PRIx32, r, C, L, checksum);
 
     if (SRSRAN_DEBUG_ENABLED && get_srsran_verbose_level() >= SRSRAN_VERBOSE_INFO && !is_handler_registered()) {
       UCI_NR_INFO_TX("Polar cb %d/%d c=", r, C);
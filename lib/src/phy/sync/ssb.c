@@ -43,6 +43,12 @@
  */
 #define SSB_CORR_SZ(SYMB_SZ) SRSRAN_MIN(1U << (uint32_t)ceil(log2((double)(SYMB_SZ)) + 3.0), 1U << 13U)
 
+/*
+ * Maximum number of coarse frequency shifts tried by the PSS search, with the shift increment being half the shift
+ * range (at least 1) there are never more than 7
+ */
+#define SSB_PSS_SEARCH_MAX_SHIFTS 7
+
 /*
  * Default NR-PBCH DMRS normalised correlation (RSRP/EPRE) threshold
  */
@@ -59,12 +65,19 @@ static int ssb_init_corr(srsran_ssb_t* q)
   for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
     // Allocate sequences
     q->pss_seq[N_id_2] = srsran_vec_cf_malloc(q->max_corr_sz);
-    if (q->pss_seq[N_id_2] == NULL) {
+    q->pss_pwr[N_id_2] = srsran_vec_f_malloc(q->max_corr_sz);
+    if (q->pss_seq[N_id_2] == NULL || q->pss_pwr[N_id_2] == NULL) {
       ERROR("Malloc");
       return SRSRAN_ERROR;
     }
   }
 
+  q->tmp_pwr = srsran_vec_f_malloc(q->max_corr_sz);
+  if (q->tmp_pwr == NULL) {
+    ERROR("Malloc");
+    return SRSRAN_ERROR;
+  }
+
   q->sf_buffer = srsran_vec_cf_malloc(q->max_ssb_sz + q->max_sf_sz);
   if (q->sf_buffer == NULL) {
     ERROR("Malloc");
@@ -159,6 +172,21 @@ void srsran_ssb_free(srsran_ssb_t* q)
     if (q->pss_seq[N_id_2] != NULL) {
       free(q->pss_seq[N_id_2]);
     }
+    if (q->pss_pwr[N_id_2] != NULL) {
+      free(q->pss_pwr[N_id_2]);
+    }
+  }
+
+  if (q->tmp_pwr != NULL) {
+    free(q->tmp_pwr);
+  }
+
+  if (q->hyp_corr != NULL) {
+    free(q->hyp_corr);
+  }
+
+  if (q->hyp_time != NULL) {
+    free(q->hyp_time);
   }
 
   if (q->sf_buffer != NULL) {
@@ -169,6 +197,7 @@ void srsran_ssb_free(srsran_ssb_t* q)
   srsran_dft_plan_free(&q->fft);
   srsran_dft_plan_free(&q->fft_corr);
   srsran_dft_plan_free(&q->ifft_corr);
+  srsran_dft_plan_free(&q->ifft_hyp);
   srsran_pbch_nr_free(&q->pbch);
 
   SRSRAN_MEM_ZERO(q, srsran_ssb_t, 1);
@@ -399,6 +428,9 @@ static int ssb_setup_corr(srsran_ssb_t* q)
 
     // Copy frequency domain sequence
     srsran_vec_cf_copy(q->pss_seq[N_id_2], q->tmp_freq, q->corr_sz);
+
+    // Its power normalises the search correlation
+    srsran_vec_abs_square_cf(q->pss_seq[N_id_2], q->pss_pwr[N_id_2], q->corr_sz);
   }
 
   return SRSRAN_SUCCESS;
@@ -850,6 +882,90 @@ static void ssb_vec_prod_conj_circ_shift(const cf_t* a, const cf_t* b, cf_t* c,
   srsran_vec_prod_conj_ccc(a, b, c, n);
 }
 
+/*
+ * Same as summing the power of ssb_vec_prod_conj_circ_shift() output given the power of both inputs
+ */
+static float ssb_vec_dot_circ_shift(const float* a, const float* b, uint32_t n, int shift)
+{
+  uint32_t offset = (uint32_t)abs(shift);
+
+  // Avoid negative number of samples
+  if (offset > n) {
+    return 0.0f;
+  }
+
+  // Shift is negative
+  if (shift < 0) {
+    return srsran_vec_dot_prod_fff(&a[offset], &b[0], n - offset) +
+           srsran_vec_dot_prod_fff(&a[0], &b[n - offset], offset);
+  }
+
+  // Shift is positive
+  if (shift > 0) {
+    return srsran_vec_dot_prod_fff(&a[0], &b[offset], n - offset) +
+           srsran_vec_dot_prod_fff(&a[n - offset], &b[0], offset);
+  }
+
+  // Shift is zero
+  return srsran_vec_dot_prod_fff(a, b, n);
+}
+
+/*
+ * Plans a single IFFT for every PSS search hypothesis, skipped if the plan is already valid
+ */
+static int ssb_pss_search_plan(srsran_ssb_t* q, uint32_t nof_hyp)
+{
+  if (q->hyp_corr_sz == q->corr_sz && q->nof_hyp == nof_hyp) {
+    return SRSRAN_SUCCESS;
+  }
+
+  srsran_dft_plan_free(&q->ifft_hyp);
+  if (q->hyp_corr != NULL) {
+    free(q->hyp_corr);
+  }
+  if (q->hyp_time != NULL) {
+    free(q->hyp_time);
+  }
+  q->nof_hyp     = 0;
+  q->hyp_corr_sz = 0;
+
+  q->hyp_corr = srsran_vec_cf_malloc(nof_hyp * q->corr_sz);
+  q->hyp_time = srsran_vec_cf_malloc(nof_hyp * q->corr_sz);
+  if (q->hyp_corr == NULL || q->hyp_time == NULL) {
+    ERROR("Malloc");
+    return SRSRAN_ERROR;
+  }
+
+  if (srsran_dft_plan_guru_c(&q->ifft_hyp,
+                             (int)q->corr_sz,
+                             SRSRAN_DFT_BACKWARD,
+                             q->hyp_corr,
+                             q->hyp_time,
+                             1,
+                             1,
+                             (int)nof_hyp,
+                             (int)q->corr_sz,
+                             (int)q->corr_sz) < SRSRAN_SUCCESS) {
+    ERROR("Error planning correlation DFT");
+    return SRSRAN_ERROR;
+  }
+
+  q->nof_hyp     = nof_hyp;
+  q->hyp_corr_sz = q->corr_sz;
+  return SRSRAN_SUCCESS;
+}
+
+/*
+ * Minimum average power of a correlation window for the PSS search to correlate it, 0 if pruning is disabled
+ */
+static float ssb_pss_prune_pwr(const srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples)
+{
+  if (!isnormal(q->args.pss_prune_thr) || q->args.pss_prune_thr < 0.0f) {
+    return 0.0f;
+  }
+  return q->args.pss_prune_thr * srsran_vec_avg_power_cf(in, nof_samples);
+}
+
 static int ssb_pss_search(srsran_ssb_t* q,
                           const cf_t*   in,
                           uint32_t      nof_samples,
@@ -869,7 +985,22 @@ static int ssb_pss_search(srsran_ssb_t* q,
   int shift_range = (int)ceil(SRSRAN_SUBC_SPACING_NR(q->cfg.scs) / coarse_cfo_ref_hz);
 
   // Calculate the coarse shift increment for half of the subcarrier spacing
-  int shift_coarse_inc = shift_range / 2;
+  int shift_coarse_inc = SRSRAN_MAX(shift_range / 2, 1);
+
+  // Hypotheses are every N_id_2 sequence, each steered to every coarse frequency offset
+  int      shifts[SSB_PSS_SEARCH_MAX_SHIFTS];
+  uint32_t nof_shifts = 0;
+  for (int shift = -shift_range; shift <= shift_range && nof_shifts < SSB_PSS_SEARCH_MAX_SHIFTS;
+       shift += shift_coarse_inc) {
+    shifts[nof_shifts++] = shift;
+  }
+  uint32_t nof_hyp = SRSRAN_NOF_NID_2_NR * nof_shifts;
+  if (ssb_pss_search_plan(q, nof_hyp) < SRSRAN_SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  // Windows with less power than this cannot hold the SSB
+  float prune_pwr = ssb_pss_prune_pwr(q, in, nof_samples);
 
   // Correlation best sequence
   float    best_corr   = 0;
@@ -879,7 +1010,7 @@ static int ssb_pss_search(srsran_ssb_t* q,
 
   // Delay in correlation window
   uint32_t t_offset = 0;
-  while ((t_offset + q->symbol_sz) < nof_samples) {
+  for (; (t_offset + q->symbol_sz) < nof_samples; t_offset += q->corr_window) {
     // Number of samples taken in this iteration
     uint32_t n = q->corr_sz;
 
@@ -888,6 +1019,11 @@ static int ssb_pss_search(srsran_ssb_t* q,
       n = nof_samples - t_offset;
     }
 
+    // Cheap time domain pre-detection
+    if (prune_pwr > 0.0f && srsran_vec_avg_power_cf(&in[t_offset], n) < prune_pwr) {
+      continue;
+    }
+
     // Copy the amount of samples
     srsran_vec_cf_copy(q->tmp_time, &in[t_offset], n);
 
@@ -899,41 +1035,41 @@ static int ssb_pss_search(srsran_ssb_t* q,
     // Convert to frequency domain
     srsran_dft_run_guru_c(&q->fft_corr);
 
-    // Try each N_id_2 sequence
-    for (uint32_t N_id_2 = 0; N_id_2 < SRSRAN_NOF_NID_2_NR; N_id_2++) {
-      // Steer coarse frequency offset
-      for (int shift = -shift_range; shift <= shift_range; shift += shift_coarse_inc) {
-        // Actual correlation in frequency domain
-        ssb_vec_prod_conj_circ_shift(q->tmp_freq, q->pss_seq[N_id_2], q->tmp_corr, q->corr_sz, shift);
-
-        // Convert to time domain
-        srsran_dft_run_guru_c(&q->ifft_corr);
-
-        // Find maximum
-        uint32_t peak_idx = srsran_vec_max_abs_ci(q->tmp_time, q->corr_window);
-
-        // Average power, take total power of the frequency domain signal after filtering, skip correlation window if
-        // value is invalid (0.0, nan or inf)
-        float avg_pwr_corr = srsran_vec_avg_power_cf(q->tmp_corr, q->corr_sz);
-        if (!isnormal(avg_pwr_corr)) {
-          continue;
-        }
-
-        // Normalise correlation
-        float corr = SRSRAN_CSQABS(q->tmp_time[peak_idx]) / avg_pwr_corr / sqrtf(SRSRAN_PSS_NR_LEN);
-
-        // Update if the correlation is better than the current best
-        if (best_corr < corr) {
-          best_corr   = corr;
-          best_delay  = peak_idx + t_offset;
-          best_N_id_2 = N_id_2;
-          best_shift  = shift;
-        }
-      }
+    // Power of the window, the filtered power of every hypothesis derives from it
+    srsran_vec_abs_square_cf(q->tmp_freq, q->tmp_pwr, q->corr_sz);
+
+    // Correlate every hypothesis in frequency domain and convert all of them to time domain at once
+    float avg_pwr_corr[SRSRAN_NOF_NID_2_NR * SSB_PSS_SEARCH_MAX_SHIFTS];
+    for (uint32_t h = 0; h < nof_hyp; h++) {
+      uint32_t N_id_2 = h / nof_shifts;
+      int      shift  = shifts[h % nof_shifts];
+      ssb_vec_prod_conj_circ_shift(
+          q->tmp_freq, q->pss_seq[N_id_2], &q->hyp_corr[h * q->corr_sz], q->corr_sz, shift);
+      avg_pwr_corr[h] = ssb_vec_dot_circ_shift(q->tmp_pwr, q->pss_pwr[N_id_2], q->corr_sz, shift) / q->corr_sz;
     }
+    srsran_dft_run_guru_c(&q->ifft_hyp);
 
-    // Advance time
-    t_offset += q->corr_window;
+    for (uint32_t h = 0; h < nof_hyp; h++) {
+      // Skip hypothesis if the average power is invalid (0.0, nan or inf)
+      if (!isnormal(avg_pwr_corr[h])) {
+        continue;
+      }
+
+      // Find maximum
+      const cf_t* corr_time = &q->hyp_time[h * q->corr_sz];
+      uint32_t    peak_idx  = srsran_vec_max_abs_ci(corr_time, q->corr_window);
+
+      // Normalise correlation
+      float corr = SRSRAN_CSQABS(corr_time[peak_idx]) / avg_pwr_corr[h] / sqrtf(SRSRAN_PSS_NR_LEN);
+
+      // Update if the correlation is better than the current best
+      if (best_corr < corr) {
+        best_corr   = corr;
+        best_delay  = peak_idx + t_offset;
+        best_N_id_2 = h / nof_shifts;
+        best_shift  = shifts[h % nof_shifts];
+      }
+    }
   }
 
   // From the best sequence correlate in frequency domain
@@ -1373,6 +1509,9 @@ static int ssb_pss_find(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, u
     return SRSRAN_ERROR;
   }
 
+  // Windows with less power than this cannot hold the SSB
+  float prune_pwr = ssb_pss_prune_pwr(q, in, nof_samples);
+
   // Correlation best sequence
   float    best_corr  = 0;
   uint32_t best_delay = 0;
@@ -1388,6 +1527,12 @@ static int ssb_pss_find(srsran_ssb_t* q, const cf_t* in, uint32_t nof_samples, u
       n = nof_samples - t_offset;
     }
 
+    // Cheap time domain pre-detection
+    if (prune_pwr > 0.0f && srsran_vec_avg_power_cf(&in[t_offset], n) < prune_pwr) {
+      t_offset += q->corr_window;
+      continue;
+    }
+
     // Copy the amount of samples
     srsran_vec_cf_copy(q->tmp_time, &in[t_offset], n);
 
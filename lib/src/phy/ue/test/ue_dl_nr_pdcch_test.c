@@ -0,0 +1,285 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/common/test_common.h"
+#include "srsran/phy/ch_estimation/dmrs_pdcch.h"
+#include "srsran/phy/channel/ch_awgn.h"
+#include "srsran/phy/phch/pdcch_nr.h"
+#include "srsran/phy/ue/ue_dl_nr.h"
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/random.h"
+#include "srsran/phy/utils/vector.h"
+#include <getopt.h>
+#include <stdlib.h>
+
+// Test parameters
+static srsran_carrier_nr_t carrier   = SRSRAN_DEFAULT_CARRIER_NR;
+static uint16_t            rnti      = 0x1234;
+static uint32_t            nof_slots = 20;     // Number of slots to test
+static float               n0_dB     = -20.0f; // Noise floor in dB relative to full-scale
+static float               ul_gain   = 0.5f;   // Amplitude of the UL PDCCH relative to the DL PDCCH
+
+static void usage(char* prog)
+{
+  printf("Usage: %s [nNv]\n", prog);
+  printf("\t-n Number of slots to test [Default %d]\n", nof_slots);
+  printf("\t-N Noise floor in dB relative to full-scale [Default %.1f]\n", n0_dB);
+  printf("\t-v [set srsran_verbose to debug, default none]\n");
+}
+
+static void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "n:N:v")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_slots = (uint32_t)strtol(optarg, NULL, 10);
+        break;
+      case 'N':
+        n0_dB = strtof(optarg, NULL);
+        break;
+      case 'v':
+        increase_srsran_verbose_level();
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+static void put_dci(srsran_pdcch_nr_t*         pdcch,
+                    const srsran_coreset_t*    coreset,
+                    const srsran_slot_cfg_t*   slot_cfg,
+                    const srsran_dci_msg_nr_t* msg,
+                    cf_t*                      grid)
+{
+  srsran_pdcch_nr_encode(pdcch, msg, grid);
+  srsran_dmrs_pdcch_put(&carrier, coreset, slot_cfg, &msg->ctx.location, grid);
+}
+
+/*
+ * A DL DCI 1_0 and a weaker UL DCI 0_0 share the DCI size of a common search space. The DL PDCCH is ranked first and
+ * the lower aggregation level candidates nested in it are decoded too. Asking for a single DL DCI must return the DL
+ * PDCCH at its own aggregation level and still leave the UL DCI pending.
+ */
+static int test_slot(srsran_ue_dl_nr_t*           ue_dl,
+                     srsran_pdcch_nr_t*           pdcch,
+                     const srsran_coreset_t*      coreset,
+                     const srsran_search_space_t* search_space,
+                     srsran_dci_nr_t*             dci,
+                     srsran_channel_awgn_t*       awgn,
+                     srsran_random_t              random_gen,
+                     cf_t*                        ul_grid,
+                     uint32_t                     slot_idx)
+{
+  srsran_slot_cfg_t slot_cfg = {.idx = slot_idx};
+  uint32_t          nof_re   = SRSRAN_SLOT_LEN_RE_NR(carrier.nof_prb);
+  cf_t*             grid     = ue_dl->sf_symbols[0];
+
+  // Candidates of 4 and 2 CCE
+  uint32_t dl_ncce[SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR] = {};
+  uint32_t ul_ncce[SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR] = {};
+  int      nof_dl_ncce = srsran_pdcch_nr_locations_coreset(coreset, search_space, rnti, 2, slot_idx, dl_ncce);
+  int      nof_ul_ncce = srsran_pdcch_nr_locations_coreset(coreset, search_space, rnti, 1, slot_idx, ul_ncce);
+  TESTASSERT(nof_dl_ncce > 1 && nof_ul_ncce > 1);
+
+  // Place the DL PDCCH in one L=2 candidate and the UL PDCCH in a L=1 candidate outside of it
+  srsran_dci_location_t dl_location = {.L = 2, .ncce = dl_ncce[slot_idx % nof_dl_ncce]};
+  srsran_dci_location_t ul_location = {};
+  for (int i = 0; i < nof_ul_ncce; i++) {
+    if (ul_ncce[i] + 2 <= dl_location.ncce || ul_ncce[i] >= dl_location.ncce + 4) {
+      ul_location.L    = 1;
+      ul_location.ncce = ul_ncce[i];
+      break;
+    }
+  }
+  TESTASSERT(ul_location.L == 1);
+
+  srsran_dci_msg_nr_t dl_msg = {};
+  dl_msg.ctx.location        = dl_location;
+  dl_msg.ctx.ss_type         = search_space->type;
+  dl_msg.ctx.coreset_id      = coreset->id;
+  dl_msg.ctx.rnti_type       = srsran_rnti_type_c;
+  dl_msg.ctx.rnti            = rnti;
+  dl_msg.ctx.format          = srsran_dci_format_nr_1_0;
+  dl_msg.nof_bits            = srsran_dci_nr_size(dci, search_space->type, srsran_dci_format_nr_1_0);
+  for (uint32_t i = 0; i < dl_msg.nof_bits; i++) {
+    dl_msg.payload[i] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+  }
+
+  srsran_dci_msg_nr_t ul_msg = dl_msg;
+  ul_msg.ctx.location        = ul_location;
+  ul_msg.ctx.format          = srsran_dci_format_nr_0_0;
+  for (uint32_t i = 0; i < ul_msg.nof_bits; i++) {
+    ul_msg.payload[i] = (uint8_t)srsran_random_uniform_int_dist(random_gen, 0, 1);
+  }
+
+  // The identifier for DCI formats is the first bit of the payload, one for DL
+  dl_msg.payload[0] = 1;
+  ul_msg.payload[0] = 0;
+
+  // Generate the resource grid
+  srsran_vec_cf_zero(grid, nof_re);
+  srsran_vec_cf_zero(ul_grid, nof_re);
+  put_dci(pdcch, coreset, &slot_cfg, &dl_msg, grid);
+  put_dci(pdcch, coreset, &slot_cfg, &ul_msg, ul_grid);
+  srsran_vec_sc_prod_cfc(ul_grid, ul_gain, ul_grid, nof_re);
+  srsran_vec_sum_ccc(grid, ul_grid, grid, nof_re);
+  srsran_channel_awgn_run_c(awgn, grid, grid, nof_re);
+
+  // Estimate the CORESET channel and search a single DL DCI
+  TESTASSERT(srsran_dmrs_pdcch_estimate(&ue_dl->dmrs_pdcch[coreset->id], &slot_cfg, grid) == SRSRAN_SUCCESS);
+  srsran_dci_dl_nr_t dci_dl = {};
+  TESTASSERT(srsran_ue_dl_nr_find_dl_dci(ue_dl, &slot_cfg, rnti, srsran_rnti_type_c, &dci_dl, 1) == 1);
+  TESTASSERT(ue_dl->dl_dci_msg[0].ctx.location.L == dl_location.L);
+  TESTASSERT(ue_dl->dl_dci_msg[0].ctx.location.ncce == dl_location.ncce);
+  TESTASSERT(memcmp(ue_dl->dl_dci_msg[0].payload, dl_msg.payload, dl_msg.nof_bits) == 0);
+
+  // The UL DCI of the same DCI size must have been found during the same search
+  TESTASSERT(ue_dl->ul_dci_count == 1);
+  TESTASSERT(ue_dl->ul_dci_msg[0].ctx.location.ncce == ul_location.ncce);
+  TESTASSERT(memcmp(ue_dl->ul_dci_msg[0].payload, ul_msg.payload, ul_msg.nof_bits) == 0);
+  srsran_dci_ul_nr_t dci_ul = {};
+  TESTASSERT(srsran_ue_dl_nr_find_ul_dci(ue_dl, &slot_cfg, rnti, srsran_rnti_type_c, &dci_ul, 1) == 1);
+
+  return SRSRAN_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  int                   ret                      = SRSRAN_ERROR;
+  srsran_ue_dl_nr_t     ue_dl                    = {};
+  srsran_pdcch_nr_t     pdcch                    = {};
+  srsran_channel_awgn_t awgn                     = {};
+  srsran_random_t       random_gen               = srsran_random_init(1234);
+  cf_t*                 buffer[SRSRAN_MAX_PORTS] = {};
+  cf_t*                 ul_grid                  = NULL;
+
+  parse_args(argc, argv);
+
+  carrier.nof_prb = 52;
+
+  // CORESET of 16 CCE, the candidates of 1 and 2 CCE of the common search space are nested in the ones of 4 CCE
+  srsran_coreset_t coreset = {};
+  coreset.id               = 1;
+  coreset.duration         = 2;
+  for (uint32_t i = 0; i < 8; i++) {
+    coreset.freq_resources[i] = true;
+  }
+
+  srsran_pdcch_cfg_nr_t pdcch_cfg   = {};
+  pdcch_cfg.coreset_present[1]      = true;
+  pdcch_cfg.coreset[1]              = coreset;
+  pdcch_cfg.search_space_present[0] = true;
+  srsran_search_space_t* ss         = &pdcch_cfg.search_space[0];
+  ss->id                            = 0;
+  ss->coreset_id                    = coreset.id;
+  ss->type                          = srsran_search_space_type_common_3;
+  ss->formats[0]                    = srsran_dci_format_nr_0_0;
+  ss->formats[1]                    = srsran_dci_format_nr_1_0;
+  ss->nof_formats                   = 2;
+  for (uint32_t L = 0; L < SRSRAN_SEARCH_SPACE_NOF_AGGREGATION_LEVELS_NR; L++) {
+    ss->nof_candidates[L] = SRSRAN_MIN(srsran_pdcch_nr_max_candidates_coreset(&coreset, L), 4);
+  }
+
+  srsran_dci_cfg_nr_t dci_cfg = {};
+  dci_cfg.bwp_dl_initial_bw   = carrier.nof_prb;
+  dci_cfg.bwp_ul_initial_bw   = carrier.nof_prb;
+  dci_cfg.bwp_dl_active_bw    = carrier.nof_prb;
+  dci_cfg.bwp_ul_active_bw    = carrier.nof_prb;
+  dci_cfg.monitor_common_0_0  = true;
+  dci_cfg.monitor_0_0_and_1_0 = true;
+  dci_cfg.coreset0_bw         = 48;
+
+  srsran_dci_nr_t dci = {};
+  if (srsran_dci_nr_set_cfg(&dci, &dci_cfg) < SRSRAN_SUCCESS) {
+    ERROR("Error setting DCI configuration");
+    goto clean_exit;
+  }
+
+  buffer[0] = srsran_vec_cf_malloc(SRSRAN_SF_LEN_PRB_NR(carrier.nof_prb));
+  ul_grid   = srsran_vec_cf_malloc(SRSRAN_SLOT_LEN_RE_NR(carrier.nof_prb));
+  if (buffer[0] == NULL || ul_grid == NULL) {
+    ERROR("Error malloc");
+    goto clean_exit;
+  }
+
+  srsran_ue_dl_nr_args_t ue_dl_args = {};
+  ue_dl_args.nof_rx_antennas        = 1;
+  ue_dl_args.nof_max_prb            = carrier.nof_prb;
+  ue_dl_args.pdsch.max_layers       = 1;
+  ue_dl_args.pdsch.max_prb          = carrier.nof_prb;
+  ue_dl_args.pdsch.sch.max_nof_iter = 10;
+  if (srsran_ue_dl_nr_init(&ue_dl, buffer, &ue_dl_args) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating UE DL");
+    goto clean_exit;
+  }
+  if (srsran_ue_dl_nr_set_carrier(&ue_dl, &carrier) < SRSRAN_SUCCESS) {
+    ERROR("Error setting UE DL carrier");
+    goto clean_exit;
+  }
+  if (srsran_ue_dl_nr_set_pdcch_config(&ue_dl, &pdcch_cfg, &dci_cfg) < SRSRAN_SUCCESS) {
+    ERROR("Error setting UE DL PDCCH configuration");
+    goto clean_exit;
+  }
+
+  srsran_pdcch_nr_args_t pdcch_args = {};
+  if (srsran_pdcch_nr_init_tx(&pdcch, &pdcch_args) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating PDCCH");
+    goto clean_exit;
+  }
+  if (srsran_pdcch_nr_set_carrier(&pdcch, &carrier, &coreset) < SRSRAN_SUCCESS) {
+    ERROR("Error setting PDCCH carrier");
+    goto clean_exit;
+  }
+
+  if (srsran_channel_awgn_init(&awgn, 1234) < SRSRAN_SUCCESS ||
+      srsran_channel_awgn_set_n0(&awgn, n0_dB) < SRSRAN_SUCCESS) {
+    ERROR("Error initiating AWGN");
+    goto clean_exit;
+  }
+
+  for (uint32_t slot_idx = 0; slot_idx < nof_slots; slot_idx++) {
+    if (test_slot(&ue_dl, &pdcch, &coreset, ss, &dci, &awgn, random_gen, ul_grid, slot_idx) < SRSRAN_SUCCESS) {
+      ERROR("Test failed in slot %d", slot_idx);
+      goto clean_exit;
+    }
+  }
+
+  ret = SRSRAN_SUCCESS;
+
+clean_exit:
+  srsran_random_free(random_gen);
+  srsran_ue_dl_nr_free(&ue_dl);
+  srsran_pdcch_nr_free(&pdcch);
+  srsran_channel_awgn_free(&awgn);
+  if (buffer[0]) {
+    free(buffer[0]);
+  }
+  if (ul_grid) {
+    free(ul_grid);
+  }
+
+  printf("Ok = %s\n", ret == SRSRAN_SUCCESS ? "yes" : "no");
+
+  return ret;
+}
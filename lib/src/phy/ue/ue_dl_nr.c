@@ -236,14 +236,63 @@ void srsran_ue_dl_nr_estimate_fft(srsran_ue_dl_nr_t* q, const srsran_slot_cfg_t*
   }
 }
 
-static int ue_dl_nr_find_dci_ncce(srsran_ue_dl_nr_t*     q,
-                                  srsran_dci_msg_nr_t*   dci_msg,
-                                  srsran_pdcch_nr_res_t* pdcch_res,
-                                  uint32_t               coreset_id)
+/**
+ * @brief PDCCH candidate that passed the DMRS measurement stage of the blind search
+ */
+typedef struct {
+  srsran_dci_location_t location;
+  uint32_t              info_idx; ///< Index of the candidate blind-search information in pdcch_info
+} ue_dl_nr_pdcch_candidate_t;
+
+/**
+ * @brief DCI size searched in a search space and the grant directions it is expected to carry
+ */
+typedef struct {
+  uint32_t               nof_bits;
+  srsran_dci_format_nr_t format; ///< First format of the search space with this size
+  bool                   expect_dl;
+  bool                   expect_ul;
+  bool                   found_dl;
+  bool                   found_ul;
+} ue_dl_nr_dci_size_t;
+
+static bool ue_dl_nr_dci_size_done(const ue_dl_nr_dci_size_t* size)
+{
+  return (!size->expect_dl || size->found_dl) && (!size->expect_ul || size->found_ul);
+}
+
+static bool ue_dl_nr_dci_size_ul_pending(const ue_dl_nr_dci_size_t* size)
+{
+  return size->expect_ul && !size->found_ul;
+}
+
+static bool ue_dl_nr_format_is_ul(srsran_dci_format_nr_t format)
+{
+  return format == srsran_dci_format_nr_0_0 || format == srsran_dci_format_nr_0_1;
+}
+
+static bool ue_dl_nr_location_overlap(const srsran_dci_location_t* a, const srsran_dci_location_t* b)
+{
+  return a->ncce < b->ncce + (1U << b->L) && b->ncce < a->ncce + (1U << a->L);
+}
+
+static bool ue_dl_nr_location_contains(const srsran_dci_location_t* outer, const srsran_dci_location_t* inner)
+{
+  return outer->L > inner->L && outer->ncce <= inner->ncce &&
+         inner->ncce + (1U << inner->L) <= outer->ncce + (1U << outer->L);
+}
+
+static int ue_dl_nr_measure_ncce(srsran_ue_dl_nr_t*      q,
+                                 const srsran_dci_ctx_t* ctx,
+                                 uint32_t*               info_idx,
+                                 bool*                   valid)
 {
+  *valid = false;
+
   // Select debug information
   srsran_ue_dl_nr_pdcch_info_t* pdcch_info = NULL;
   if (q->pdcch_info_count < SRSRAN_MAX_NOF_CANDIDATES_SLOT_NR) {
+    *info_idx  = q->pdcch_info_count;
     pdcch_info = &q->pdcch_info[q->pdcch_info_count];
     q->pdcch_info_count++;
   } else {
@@ -251,13 +300,12 @@ static int ue_dl_nr_find_dci_ncce(srsran_ue_dl_nr_t*     q,
     return SRSRAN_ERROR;
   }
   SRSRAN_MEM_ZERO(pdcch_info, srsran_ue_dl_nr_pdcch_info_t, 1);
-  pdcch_info->dci_ctx            = dci_msg->ctx;
-  pdcch_info->nof_bits           = dci_msg->nof_bits;
+  pdcch_info->dci_ctx            = *ctx;
   srsran_dmrs_pdcch_measure_t* m = &pdcch_info->measure;
 
   // Measures the PDCCH transmission DMRS
-  srsran_dci_location_t location = dci_msg->ctx.location;
-  if (srsran_dmrs_pdcch_get_measure(&q->dmrs_pdcch[coreset_id], &location, m) < SRSRAN_SUCCESS) {
+  srsran_dci_location_t location = ctx->location;
+  if (srsran_dmrs_pdcch_get_measure(&q->dmrs_pdcch[ctx->coreset_id], &location, m) < SRSRAN_SUCCESS) {
     ERROR("Error getting measure location L=%d, ncce=%d", location.L, location.ncce);
     return SRSRAN_ERROR;
   }
@@ -290,13 +338,16 @@ static int ue_dl_nr_find_dci_ncce(srsran_ue_dl_nr_t*     q,
     return SRSRAN_SUCCESS;
   }
 
-  // Extract PDCCH channel estimates
-  if (srsran_dmrs_pdcch_get_ce(&q->dmrs_pdcch[coreset_id], &location, q->pdcch_ce) < SRSRAN_SUCCESS) {
-    ERROR("Error extracting PDCCH DMRS");
-    return SRSRAN_ERROR;
-  }
+  *valid = true;
+  return SRSRAN_SUCCESS;
+}
 
-  // Decode PDCCH
+static int ue_dl_nr_find_dci_ncce(srsran_ue_dl_nr_t*     q,
+                                  srsran_dci_msg_nr_t*   dci_msg,
+                                  srsran_pdcch_nr_res_t* pdcch_res,
+                                  uint32_t               info_idx)
+{
+  // Decode PDCCH, the channel estimates of the location are already in pdcch_ce
   if (srsran_pdcch_nr_decode(&q->pdcch, q->sf_symbols[0], q->pdcch_ce, dci_msg, pdcch_res) < SRSRAN_SUCCESS) {
     ERROR("Error decoding PDCCH");
     return SRSRAN_ERROR;
@@ -313,7 +364,10 @@ static int ue_dl_nr_find_dci_ncce(srsran_ue_dl_nr_t*     q,
 #endif
 
   // Save information
-  pdcch_info->result = *pdcch_res;
+  srsran_ue_dl_nr_pdcch_info_t* pdcch_info = &q->pdcch_info[info_idx];
+  pdcch_info->dci_ctx                      = dci_msg->ctx;
+  pdcch_info->nof_bits                     = dci_msg->nof_bits;
+  pdcch_info->result                       = *pdcch_res;
 
   return SRSRAN_SUCCESS;
 }
@@ -334,14 +388,76 @@ static bool find_dci_msg(srsran_dci_msg_nr_t* dci_msg, uint32_t nof_dci_msg, srs
   return found;
 }
 
+/**
+ * @brief Stores a CRC-matched DCI message in the DL or UL list unless it is already there
+ * @return true if the message carries a valid grant direction, false otherwise
+ */
+static bool ue_dl_nr_save_dci(srsran_ue_dl_nr_t* q, srsran_dci_msg_nr_t* dci_msg)
+{
+  // Detect if the DCI is the right direction
+  if (!srsran_dci_nr_valid_direction(dci_msg)) {
+    // Change grant format direction
+    switch (dci_msg->ctx.format) {
+      case srsran_dci_format_nr_0_0:
+        dci_msg->ctx.format = srsran_dci_format_nr_1_0;
+        break;
+      case srsran_dci_format_nr_0_1:
+        dci_msg->ctx.format = srsran_dci_format_nr_1_1;
+        break;
+      case srsran_dci_format_nr_1_0:
+        dci_msg->ctx.format = srsran_dci_format_nr_0_0;
+        break;
+      case srsran_dci_format_nr_1_1:
+        dci_msg->ctx.format = srsran_dci_format_nr_0_1;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  // If UL grant, enqueue in UL list
+  if (ue_dl_nr_format_is_ul(dci_msg->ctx.format)) {
+    // Save the grant in the pending UL grant list unless it is full or has the dci message
+    if (q->ul_dci_count < SRSRAN_MAX_DCI_MSG_NR && !find_dci_msg(q->ul_dci_msg, q->ul_dci_count, dci_msg)) {
+      q->ul_dci_msg[q->ul_dci_count] = *dci_msg;
+      q->ul_dci_count++;
+    }
+    return true;
+  }
+
+  // Append DCI message into the list unless it is full or the same DCI is there already
+  if (q->dl_dci_msg_count < SRSRAN_MAX_DCI_MSG_NR && !find_dci_msg(q->dl_dci_msg, q->dl_dci_msg_count, dci_msg)) {
+    INFO("Found DCI in L=%d,ncce=%d", dci_msg->ctx.location.L, dci_msg->ctx.location.ncce);
+    q->dl_dci_msg[q->dl_dci_msg_count] = *dci_msg;
+    q->dl_dci_msg_count++;
+  }
+  return true;
+}
+
+/**
+ * @brief Blind search of a search space
+ *
+ * The search runs in stages:
+ * - Every candidate location of every aggregation level is measured once, candidates failing the DMRS EPRE or
+ *   correlation thresholds are discarded and the rest are ranked by DMRS correlation, highest first;
+ * - Candidates are decoded in rank order. The channel estimates of a location are extracted once and shared by all the
+ *   DCI sizes tried on it;
+ * - A CRC match at a location nested in a higher aggregation level candidate is retried on the enclosing candidates
+ *   and the highest aggregation level carrying the same payload is kept. Candidates overlapping the CCE of a found
+ *   PDCCH are skipped;
+ * - The search stops once every DCI size has produced the grant directions its formats can carry, or once the DL list
+ *   holds as many messages as the caller asked for and no DCI size is still expecting an UL grant. Only the sizes
+ *   expecting an UL grant are searched after the DL list is full.
+ */
 static int ue_dl_nr_find_dci_ss(srsran_ue_dl_nr_t*           q,
                                 const srsran_slot_cfg_t*     slot_cfg,
                                 const srsran_search_space_t* search_space,
                                 uint16_t                     rnti,
-                                srsran_rnti_type_t           rnti_type)
+                                srsran_rnti_type_t           rnti_type,
+                                uint32_t                     nof_dci_msg)
 {
-  uint32_t dci_sizes[SRSRAN_DCI_NR_MAX_NOF_SIZES] = {};
-  uint32_t dci_sizes_count                        = 0;
+  ue_dl_nr_dci_size_t dci_sizes[SRSRAN_DCI_NR_MAX_NOF_SIZES] = {};
+  uint32_t            dci_sizes_count                        = 0;
 
   // Select CORESET
   uint32_t coreset_id = search_space->coreset_id;
@@ -357,7 +473,7 @@ static int ue_dl_nr_find_dci_ss(srsran_ue_dl_nr_t*           q,
     return SRSRAN_ERROR;
   }
 
-  // Iterate all possible formats
+  // Iterate all possible formats and collect the different DCI sizes
   for (uint32_t format_idx = 0; format_idx < SRSRAN_MIN(search_space->nof_formats, SRSRAN_DCI_FORMAT_NR_COUNT);
        format_idx++) {
     srsran_dci_format_nr_t dci_format = search_space->formats[format_idx];
@@ -369,113 +485,187 @@ static int ue_dl_nr_find_dci_ss(srsran_ue_dl_nr_t*           q,
       return SRSRAN_ERROR;
     }
 
-    // Skip DCI format if the size was already searched for the search space
-    bool skip = false;
-    for (uint32_t i = 0; i < dci_sizes_count && !skip; i++) {
-      if (dci_nof_bits == dci_sizes[i]) {
-        skip = true;
+    // Select the size if it was already listed for the search space, otherwise append it
+    ue_dl_nr_dci_size_t* size = NULL;
+    for (uint32_t i = 0; i < dci_sizes_count && size == NULL; i++) {
+      if (dci_nof_bits == dci_sizes[i].nof_bits) {
+        size = &dci_sizes[i];
       }
     }
-    if (skip) {
-      continue;
+    if (size == NULL) {
+      if (dci_sizes_count >= SRSRAN_DCI_NR_MAX_NOF_SIZES) {
+        ERROR("Exceed maximum number of DCI sizes");
+        return SRSRAN_ERROR;
+      }
+      size           = &dci_sizes[dci_sizes_count++];
+      size->nof_bits = dci_nof_bits;
+      size->format   = dci_format;
+    }
+
+    // Record the grant direction the format carries
+    if (ue_dl_nr_format_is_ul(dci_format)) {
+      size->expect_ul = true;
+    } else {
+      size->expect_dl = true;
     }
+  }
 
-    // Append size
-    if (dci_sizes_count >= SRSRAN_DCI_NR_MAX_NOF_SIZES) {
-      ERROR("Exceed maximum number of DCI sizes");
+  // Build DCI context common to all candidates
+  srsran_dci_ctx_t ctx = {};
+  ctx.ss_type          = search_space->type;
+  ctx.coreset_id       = search_space->coreset_id;
+  ctx.coreset_start_rb = srsran_coreset_start_rb(coreset);
+  ctx.rnti_type        = rnti_type;
+  ctx.rnti             = rnti;
+  ctx.format           = dci_sizes_count > 0 ? dci_sizes[0].format : srsran_dci_format_nr_1_0;
+
+  // Measure all candidate locations and rank the valid ones by DMRS correlation
+  ue_dl_nr_pdcch_candidate_t candidates[SRSRAN_SEARCH_SPACE_NOF_AGGREGATION_LEVELS_NR *
+                                        SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR];
+  uint32_t                   nof_candidates = 0;
+  for (uint32_t L = 0; L < SRSRAN_SEARCH_SPACE_NOF_AGGREGATION_LEVELS_NR && dci_sizes_count > 0; L++) {
+    // Calculate possible PDCCH DCI candidates
+    uint32_t ncce[SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR] = {};
+    int      nof_ncce                                        = srsran_pdcch_nr_locations_coreset(
+        coreset, search_space, rnti, L, SRSRAN_SLOT_NR_MOD(q->carrier.scs, slot_cfg->idx), ncce);
+    if (nof_ncce < SRSRAN_SUCCESS) {
+      ERROR("Error calculating DCI candidate location");
       return SRSRAN_ERROR;
     }
-    dci_sizes[dci_sizes_count++] = dci_nof_bits;
-
-    // Iterate all possible aggregation levels
-    for (uint32_t L = 0;
-         L < SRSRAN_SEARCH_SPACE_NOF_AGGREGATION_LEVELS_NR && q->dl_dci_msg_count < SRSRAN_MAX_DCI_MSG_NR;
-         L++) {
-      // Calculate possible PDCCH DCI candidates
-      uint32_t candidates[SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR] = {};
-      int      nof_candidates                                        = srsran_pdcch_nr_locations_coreset(
-                                                      coreset, search_space, rnti, L, SRSRAN_SLOT_NR_MOD(q->carrier.scs, slot_cfg->idx), candidates);
-      if (nof_candidates < SRSRAN_SUCCESS) {
-        ERROR("Error calculating DCI candidate location");
+
+    for (int ncce_idx = 0; ncce_idx < nof_ncce; ncce_idx++) {
+      ctx.location.L    = L;
+      ctx.location.ncce = ncce[ncce_idx];
+
+      uint32_t info_idx = 0;
+      bool     valid    = false;
+      if (ue_dl_nr_measure_ncce(q, &ctx, &info_idx, &valid) < SRSRAN_SUCCESS) {
         return SRSRAN_ERROR;
       }
+      if (!valid) {
+        continue;
+      }
 
-      // Iterate over the candidates
-      for (int ncce_idx = 0; ncce_idx < nof_candidates && q->dl_dci_msg_count < SRSRAN_MAX_DCI_MSG_NR; ncce_idx++) {
-        // Build DCI context
-        srsran_dci_ctx_t ctx = {};
-        ctx.location.L       = L;
-        ctx.location.ncce    = candidates[ncce_idx];
-        ctx.ss_type          = search_space->type;
-        ctx.coreset_id       = search_space->coreset_id;
-        ctx.coreset_start_rb = srsran_coreset_start_rb(&q->cfg.coreset[search_space->coreset_id]);
-        ctx.rnti_type        = rnti_type;
-        ctx.rnti             = rnti;
-        ctx.format           = dci_format;
-
-        // Build DCI message
-        srsran_dci_msg_nr_t dci_msg = {};
-        dci_msg.ctx                 = ctx;
-        dci_msg.nof_bits            = (uint32_t)dci_nof_bits;
-
-        // Find and decode PDCCH transmission in the given ncce
-        srsran_pdcch_nr_res_t res = {};
-        if (ue_dl_nr_find_dci_ncce(q, &dci_msg, &res, coreset_id) < SRSRAN_SUCCESS) {
-          return SRSRAN_ERROR;
+      // Insert by descending correlation, higher aggregation level first on ties
+      float    corr = q->pdcch_info[info_idx].measure.norm_corr;
+      uint32_t pos  = nof_candidates;
+      while (pos > 0) {
+        const ue_dl_nr_pdcch_candidate_t* prev      = &candidates[pos - 1];
+        float                             prev_corr = q->pdcch_info[prev->info_idx].measure.norm_corr;
+        if (prev_corr > corr || (prev_corr == corr && prev->location.L >= L)) {
+          break;
         }
+        candidates[pos] = *prev;
+        pos--;
+      }
+      candidates[pos].location = ctx.location;
+      candidates[pos].info_idx = info_idx;
+      nof_candidates++;
+    }
+  }
 
-        // If the CRC was not match, move to next candidate
-        if (!res.crc) {
+  // Locations of the PDCCH found in this search space
+  srsran_dci_location_t found[SRSRAN_SEARCH_SPACE_NOF_AGGREGATION_LEVELS_NR *
+                              SRSRAN_SEARCH_SPACE_MAX_NOF_CANDIDATES_NR];
+  uint32_t              nof_found = 0;
+
+  // Decode candidates in rank order until every DCI size is satisfied
+  bool done = false;
+  for (uint32_t i = 0; i < nof_candidates && !done; i++) {
+    const ue_dl_nr_pdcch_candidate_t* candidate = &candidates[i];
+    bool                              dl_full   = q->dl_dci_msg_count >= nof_dci_msg;
+
+    // A CCE carries a single PDCCH, skip candidates overlapping a found one
+    bool overlap = false;
+    for (uint32_t j = 0; j < nof_found && !overlap; j++) {
+      overlap = ue_dl_nr_location_overlap(&candidate->location, &found[j]);
+    }
+    if (overlap) {
+      continue;
+    }
+
+    // Extract PDCCH channel estimates once for all DCI sizes
+    if (srsran_dmrs_pdcch_get_ce(&q->dmrs_pdcch[coreset_id], &candidate->location, q->pdcch_ce) < SRSRAN_SUCCESS) {
+      ERROR("Error extracting PDCCH DMRS");
+      return SRSRAN_ERROR;
+    }
+
+    for (uint32_t s = 0; s < dci_sizes_count; s++) {
+      ue_dl_nr_dci_size_t* size = &dci_sizes[s];
+      if (ue_dl_nr_dci_size_done(size) || (dl_full && !ue_dl_nr_dci_size_ul_pending(size))) {
+        continue;
+      }
+
+      // Build DCI message
+      srsran_dci_msg_nr_t dci_msg = {};
+      dci_msg.ctx                 = ctx;
+      dci_msg.ctx.location        = candidate->location;
+      dci_msg.ctx.format          = size->format;
+      dci_msg.nof_bits            = size->nof_bits;
+
+      // Decode PDCCH transmission in the given ncce
+      srsran_pdcch_nr_res_t res = {};
+      if (ue_dl_nr_find_dci_ncce(q, &dci_msg, &res, candidate->info_idx) < SRSRAN_SUCCESS) {
+        return SRSRAN_ERROR;
+      }
+
+      // If the CRC was not match, move to next size
+      if (!res.crc) {
+        continue;
+      }
+
+      // Lower aggregation levels nested at the start of a PDCCH may match the same payload, keep the highest
+      bool outer_ce = false;
+      for (uint32_t j = i + 1; j < nof_candidates; j++) {
+        const ue_dl_nr_pdcch_candidate_t* outer = &candidates[j];
+        if (!ue_dl_nr_location_contains(&outer->location, &dci_msg.ctx.location)) {
           continue;
         }
 
-        // Detect if the DCI is the right direction
-        if (!srsran_dci_nr_valid_direction(&dci_msg)) {
-          // Change grant format direction
-          switch (dci_msg.ctx.format) {
-            case srsran_dci_format_nr_0_0:
-              dci_msg.ctx.format = srsran_dci_format_nr_1_0;
-              break;
-            case srsran_dci_format_nr_0_1:
-              dci_msg.ctx.format = srsran_dci_format_nr_1_1;
-              break;
-            case srsran_dci_format_nr_1_0:
-              dci_msg.ctx.format = srsran_dci_format_nr_0_0;
-              break;
-            case srsran_dci_format_nr_1_1:
-              dci_msg.ctx.format = srsran_dci_format_nr_0_1;
-              break;
-            default:
-              continue;
-          }
+        if (srsran_dmrs_pdcch_get_ce(&q->dmrs_pdcch[coreset_id], &outer->location, q->pdcch_ce) < SRSRAN_SUCCESS) {
+          ERROR("Error extracting PDCCH DMRS");
+          return SRSRAN_ERROR;
         }
+        outer_ce = true;
 
-        // If UL grant, enqueue in UL list
-        if (dci_msg.ctx.format == srsran_dci_format_nr_0_0 || dci_msg.ctx.format == srsran_dci_format_nr_0_1) {
-          // If the pending UL grant list is full or has the dci message, keep moving
-          if (q->ul_dci_count >= SRSRAN_MAX_DCI_MSG_NR || find_dci_msg(q->ul_dci_msg, q->ul_dci_count, &dci_msg)) {
-            continue;
-          }
+        srsran_dci_msg_nr_t outer_msg = dci_msg;
+        outer_msg.ctx.location        = outer->location;
+        outer_msg.ctx.format          = size->format;
 
-          // Save the grant in the pending UL grant list
-          q->ul_dci_msg[q->ul_dci_count] = dci_msg;
-          q->ul_dci_count++;
+        srsran_pdcch_nr_res_t outer_res = {};
+        if (ue_dl_nr_find_dci_ncce(q, &outer_msg, &outer_res, outer->info_idx) < SRSRAN_SUCCESS) {
+          return SRSRAN_ERROR;
+        }
 
-          // Move to next candidate
-          continue;
+        if (outer_res.crc && memcmp(outer_msg.payload, dci_msg.payload, dci_msg.nof_bits) == 0) {
+          dci_msg.ctx.location = outer->location;
         }
+      }
 
-        // Check if the grant exists already in the DL list
-        if (find_dci_msg(q->dl_dci_msg, q->dl_dci_msg_count, &dci_msg)) {
-          // The same DCI is in the list, keep moving
-          continue;
+      // Discard the message if the direction is invalid, the next DCI size needs the estimates of the candidate back
+      if (!ue_dl_nr_save_dci(q, &dci_msg)) {
+        if (outer_ce &&
+            srsran_dmrs_pdcch_get_ce(&q->dmrs_pdcch[coreset_id], &candidate->location, q->pdcch_ce) < SRSRAN_SUCCESS) {
+          ERROR("Error extracting PDCCH DMRS");
+          return SRSRAN_ERROR;
         }
+        continue;
+      }
 
-        INFO("Found DCI in L=%d,ncce=%d", dci_msg.ctx.location.L, dci_msg.ctx.location.ncce);
-        // Append DCI message into the list
-        q->dl_dci_msg[q->dl_dci_msg_count] = dci_msg;
-        q->dl_dci_msg_count++;
+      // Update the satisfied grant directions of the size
+      if (ue_dl_nr_format_is_ul(dci_msg.ctx.format)) {
+        size->found_ul = true;
+      } else {
+        size->found_dl = true;
       }
+      found[nof_found++] = dci_msg.ctx.location;
+      break;
+    }
+
+    // Stop the search if all sizes are satisfied
+    done = true;
+    for (uint32_t s = 0; s < dci_sizes_count && done; s++) {
+      done = ue_dl_nr_dci_size_done(&dci_sizes[s]);
     }
   }
 
@@ -504,7 +694,7 @@ int srsran_ue_dl_nr_find_dl_dci(srsran_ue_dl_nr_t*       q,
   // If the UE looks for a RAR and RA search space is provided, search for it
   if (q->cfg.ra_search_space_present && rnti_type == srsran_rnti_type_ra) {
     // Find DCIs in the RA search space
-    int ret = ue_dl_nr_find_dci_ss(q, slot_cfg, &q->cfg.ra_search_space, rnti, rnti_type);
+    int ret = ue_dl_nr_find_dci_ss(q, slot_cfg, &q->cfg.ra_search_space, rnti, rnti_type, nof_dci_msg);
     if (ret < SRSRAN_SUCCESS) {
       ERROR("Error searching RAR DCI");
       return SRSRAN_ERROR;
@@ -518,7 +708,7 @@ int srsran_ue_dl_nr_find_dl_dci(srsran_ue_dl_nr_t*       q,
       }
 
       // Find DCIs in the selected search space
-      int ret = ue_dl_nr_find_dci_ss(q, slot_cfg, &q->cfg.search_space[i], rnti, rnti_type);
+      int ret = ue_dl_nr_find_dci_ss(q, slot_cfg, &q->cfg.search_space[i], rnti, rnti_type, nof_dci_msg);
       if (ret < SRSRAN_SUCCESS) {
         ERROR("Error searching DCI");
         return SRSRAN_ERROR;
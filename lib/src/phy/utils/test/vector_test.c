@@ -891,6 +891,7 @@ int main(int argc, char** argv)
   if (argc > 1) {
     nof_repetitions = (uint32_t)strtol(argv[1], NULL, 10);
   }
+  printf("Vector ISA: %s\n", srsran_vec_get_isa());
 
   for (uint32_t block_size = 1; block_size <= 1024 * 32; block_size *= 2) {
     func_count = 0;
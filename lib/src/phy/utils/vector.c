@@ -30,6 +30,7 @@
 #include "srsran/phy/utils/simd.h"
 #include "srsran/phy/utils/vector.h"
 #include "srsran/phy/utils/vector_simd.h"
+#include "vector_simd_isa.h"
 
 void srsran_vec_xor_bbb(const uint8_t* x, const uint8_t* y, uint8_t* z, const uint32_t len)
 {
@@ -44,7 +45,7 @@ float srsran_vec_acc_ff(const float* x, const uint32_t len)
 
 cf_t srsran_vec_acc_cc(const cf_t* x, const uint32_t len)
 {
-  return srsran_vec_acc_cc_simd(x, len);
+  return SRSRAN_VEC_KERNEL(acc_cc)(x, len);
 }
 
 void srsran_vec_sub_fff(const float* x, const float* y, float* z, const uint32_t len)
@@ -99,7 +100,7 @@ void srsran_vec_sc_prod_fff(const float* x, const float h, float* z, const uint3
 // Used throughout
 void srsran_vec_sc_prod_cfc(const cf_t* x, const float h, cf_t* z, const uint32_t len)
 {
-  srsran_vec_sc_prod_cfc_simd(x, h, z, len);
+  SRSRAN_VEC_KERNEL(sc_prod_cfc)(x, h, z, len);
 }
 
 void srsran_vec_sc_prod_fcc(const float* x, const cf_t h, cf_t* z, const uint32_t len)
@@ -121,12 +122,12 @@ void srsran_vec_convert_if(const int16_t* x, const float scale, float* z, const
 
 void srsran_vec_convert_fi(const float* x, const float scale, int16_t* z, const uint32_t len)
 {
-  srsran_vec_convert_fi_simd(x, z, scale, len);
+  SRSRAN_VEC_KERNEL(convert_fi)(x, z, scale, len);
 }
 
 void srsran_vec_convert_conj_cs(const cf_t* x, const float scale, int16_t* z, const uint32_t len)
 {
-  srsran_vec_convert_conj_cs_simd(x, z, scale, len);
+  SRSRAN_VEC_KERNEL(convert_conj_cs)(x, z, scale, len);
 }
 
 void srsran_vec_convert_fb(const float* x, const float scale, int8_t* z, const uint32_t len)
@@ -526,7 +527,7 @@ void srsran_vec_prod_ccc_split(const float*   x_re,
 // PRACH, CHEST UL, etc.
 void srsran_vec_prod_conj_ccc(const cf_t* x, const cf_t* y, cf_t* z, const uint32_t len)
 {
-  srsran_vec_prod_conj_ccc_simd(x, y, z, len);
+  SRSRAN_VEC_KERNEL(prod_conj_ccc)(x, y, z, len);
 }
 
 //#define DIV_USE_VEC
@@ -568,7 +569,7 @@ cf_t srsran_vec_dot_prod_cfc(const cf_t* x, const float* y, const uint32_t len)
 // SYNC
 cf_t srsran_vec_dot_prod_conj_ccc(const cf_t* x, const cf_t* y, const uint32_t len)
 {
-  return srsran_vec_dot_prod_conj_ccc_simd(x, y, len);
+  return SRSRAN_VEC_KERNEL(dot_prod_conj_ccc)(x, y, len);
 }
 
 // PHICH
@@ -702,7 +703,7 @@ void srsran_vec_arg_deg_cf(const cf_t* x, float default_value, float* arg, const
 // PRACH
 void srsran_vec_abs_square_cf(const cf_t* x, float* abs_square, const uint32_t len)
 {
-  srsran_vec_abs_square_cf_simd(x, abs_square, len);
+  SRSRAN_VEC_KERNEL(abs_square_cf)(x, abs_square, len);
 }
 
 uint32_t srsran_vec_max_fi(const float* x, const uint32_t len)
@@ -718,7 +719,7 @@ uint32_t srsran_vec_max_abs_fi(const float* x, const uint32_t len)
 // CP autocorr
 uint32_t srsran_vec_max_abs_ci(const cf_t* x, const uint32_t len)
 {
-  return srsran_vec_max_ci_simd(x, len);
+  return SRSRAN_VEC_KERNEL(max_ci)(x, len);
 }
 
 void srsran_vec_quant_fs(const float*   in,
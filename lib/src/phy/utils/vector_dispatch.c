@@ -0,0 +1,118 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "srsran/phy/utils/debug.h"
+#include "srsran/phy/utils/vector.h"
+#include "vector_simd_isa.h"
+
+#ifdef SRSRAN_VEC_DISPATCH
+
+const srsran_vec_kernels_t* srsran_vec_kernels = &srsran_vec_kernels_baseline;
+
+// Widest first
+static const srsran_vec_kernels_t* const vec_isa_list[] = {&srsran_vec_kernels_avx512,
+                                                           &srsran_vec_kernels_avx2,
+                                                           &srsran_vec_kernels_baseline};
+
+#define VEC_NOF_ISA (sizeof(vec_isa_list) / sizeof(vec_isa_list[0]))
+
+static bool vec_isa_supported(const srsran_vec_kernels_t* kernels)
+{
+  if (kernels == &srsran_vec_kernels_avx512) {
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+           __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") &&
+           __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  if (kernels == &srsran_vec_kernels_avx2) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  return true;
+}
+
+// Runs before main, earlier constructors use the baseline kernels
+__attribute__((constructor)) static void srsran_vec_dispatch_init()
+{
+  __builtin_cpu_init();
+
+  const char* name = getenv("SRSRAN_VEC_ISA");
+  if (name != NULL && srsran_vec_set_isa(name) == SRSRAN_SUCCESS) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < VEC_NOF_ISA; i++) {
+    if (vec_isa_supported(vec_isa_list[i])) {
+      srsran_vec_kernels = vec_isa_list[i];
+      return;
+    }
+  }
+}
+
+const char* srsran_vec_get_isa(void)
+{
+  return srsran_vec_kernels->name;
+}
+
+int srsran_vec_set_isa(const char* name)
+{
+  if (name == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  for (uint32_t i = 0; i < VEC_NOF_ISA; i++) {
+    if (strcmp(vec_isa_list[i]->name, name) == 0) {
+      if (!vec_isa_supported(vec_isa_list[i])) {
+        ERROR("Vector ISA %s is not supported by this CPU", name);
+        return SRSRAN_ERROR;
+      }
+      srsran_vec_kernels = vec_isa_list[i];
+      return SRSRAN_SUCCESS;
+    }
+  }
+
+  ERROR("Unknown vector ISA %s", name);
+  return SRSRAN_ERROR;
+}
+
+#else /* SRSRAN_VEC_DISPATCH */
+
+const char* srsran_vec_get_isa(void)
+{
+  return srsran_vec_kernels_baseline.name;
+}
+
+int srsran_vec_set_isa(const char* name)
+{
+  if (name == NULL) {
+    return SRSRAN_ERROR_INVALID_INPUTS;
+  }
+
+  // Only the project-wide build is available
+  if (strcmp(name, srsran_vec_kernels_baseline.name) != 0) {
+    ERROR("Vector ISA %s is not built, enable ENABLE_VECTOR_DISPATCH", name);
+    return SRSRAN_ERROR;
+  }
+  return SRSRAN_SUCCESS;
+}
+
+#endif /* SRSRAN_VEC_DISPATCH */
@@ -433,92 +433,6 @@ void srsran_vec_convert_if_simd(const int16_t* x, float* z, const float scale, c
   }
 }
 
-void srsran_vec_convert_fi_simd(const float* x, int16_t* z, const float scale, const int len)
-{
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE
-  simd_f_t s = srsran_simd_f_set1(scale);
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
-      simd_f_t a = srsran_simd_f_load(&x[i]);
-      simd_f_t b = srsran_simd_f_load(&x[i + SRSRAN_SIMD_F_SIZE]);
-
-      simd_f_t sa = srsran_simd_f_mul(a, s);
-      simd_f_t sb = srsran_simd_f_mul(b, s);
-
-      simd_s_t i16 = srsran_simd_convert_2f_s(sa, sb);
-
-      srsran_simd_s_store(&z[i], i16);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
-      simd_f_t a = srsran_simd_f_loadu(&x[i]);
-      simd_f_t b = srsran_simd_f_loadu(&x[i + SRSRAN_SIMD_F_SIZE]);
-
-      simd_f_t sa = srsran_simd_f_mul(a, s);
-      simd_f_t sb = srsran_simd_f_mul(b, s);
-
-      simd_s_t i16 = srsran_simd_convert_2f_s(sa, sb);
-
-      srsran_simd_s_storeu(&z[i], i16);
-    }
-  }
-#endif /* SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE */
-
-  for (; i < len; i++) {
-    z[i] = (int16_t)(x[i] * scale);
-  }
-}
-
-void srsran_vec_convert_conj_cs_simd(const cf_t* x_, int16_t* z, const float scale, const int len_)
-{
-  int i = 0;
-
-  const float* x   = (float*)x_;
-  const int    len = len_ * 2;
-
-#if SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE
-  srsran_simd_aligned float scale_v[SRSRAN_SIMD_F_SIZE];
-  for (uint32_t j = 0; j < SRSRAN_SIMD_F_SIZE; j++) {
-    scale_v[j] = (j % 2 == 0) ? +scale : -scale;
-  }
-
-  simd_f_t s = srsran_simd_f_load(scale_v);
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
-      simd_f_t a = srsran_simd_f_load(&x[i]);
-      simd_f_t b = srsran_simd_f_load(&x[i + SRSRAN_SIMD_F_SIZE]);
-
-      simd_f_t sa = srsran_simd_f_mul(a, s);
-      simd_f_t sb = srsran_simd_f_mul(b, s);
-
-      simd_s_t i16 = srsran_simd_convert_2f_s(sa, sb);
-
-      srsran_simd_s_store(&z[i], i16);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_S_SIZE + 1; i += SRSRAN_SIMD_S_SIZE) {
-      simd_f_t a = srsran_simd_f_loadu(&x[i]);
-      simd_f_t b = srsran_simd_f_loadu(&x[i + SRSRAN_SIMD_F_SIZE]);
-
-      simd_f_t sa = srsran_simd_f_mul(a, s);
-      simd_f_t sb = srsran_simd_f_mul(b, s);
-
-      simd_s_t i16 = srsran_simd_convert_2f_s(sa, sb);
-
-      srsran_simd_s_storeu(&z[i], i16);
-    }
-  }
-#endif /* SRSRAN_SIMD_F_SIZE && SRSRAN_SIMD_S_SIZE */
-
-  for (; i < len; i++) {
-    z[i] = (int16_t)(x[i] * scale);
-    i++;
-    z[i] = (int16_t)(x[i] * -scale);
-  }
-}
-
 #define SRSRAN_IS_ALIGNED_SSE(PTR) (((size_t)(PTR)&0x0F) == 0)
 
 void srsran_vec_convert_fb_simd(const float* x, int8_t* z, const float scale, const int len)
@@ -624,41 +538,6 @@ float srsran_vec_acc_ff_simd(const float* x, const int len)
   return acc_sum;
 }
 
-cf_t srsran_vec_acc_cc_simd(const cf_t* x, const int len)
-{
-  int  i       = 0;
-  cf_t acc_sum = 0.0f;
-
-#if SRSRAN_SIMD_F_SIZE
-  simd_f_t simd_sum = srsran_simd_f_zero();
-
-  if (SRSRAN_IS_ALIGNED(x)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t a = srsran_simd_f_load((float*)&x[i]);
-
-      simd_sum = srsran_simd_f_add(simd_sum, a);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t a = srsran_simd_f_loadu((float*)&x[i]);
-
-      simd_sum = srsran_simd_f_add(simd_sum, a);
-    }
-  }
-
-  __attribute__((aligned(64))) cf_t sum[SRSRAN_SIMD_F_SIZE / 2];
-  srsran_simd_f_store((float*)&sum, simd_sum);
-  for (int k = 0; k < SRSRAN_SIMD_F_SIZE / 2; k++) {
-    acc_sum += sum[k];
-  }
-#endif
-
-  for (; i < len; i++) {
-    acc_sum += x[i];
-  }
-  return acc_sum;
-}
-
 void srsran_vec_add_fff_simd(const float* x, const float* y, float* z, const int len)
 {
   int i = 0;
@@ -827,51 +706,6 @@ c16_t srsran_vec_dot_prod_ccc_c16i_simd(const c16_t* x, const c16_t* y, const in
 }
 #endif /* ENABLE_C16 */
 
-cf_t srsran_vec_dot_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, const int len)
-{
-  int  i      = 0;
-  cf_t result = 0;
-
-#if SRSRAN_SIMD_CF_SIZE
-  if (len >= SRSRAN_SIMD_CF_SIZE) {
-    simd_cf_t avx_result = srsran_simd_cf_zero();
-    if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y)) {
-      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-        simd_cf_t xVal = srsran_simd_cfi_load(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_load(&y[i]);
-
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
-      }
-    } else {
-      for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-        simd_cf_t xVal = srsran_simd_cfi_loadu(&x[i]);
-        simd_cf_t yVal = srsran_simd_cfi_loadu(&y[i]);
-
-        avx_result = srsran_simd_cf_add(srsran_simd_cf_conjprod(xVal, yVal), avx_result);
-      }
-    }
-
-    __attribute__((aligned(64))) float simd_dotProdVector[SRSRAN_SIMD_CF_SIZE];
-    simd_f_t                           acc_re = srsran_simd_cf_re(avx_result);
-    simd_f_t                           acc_im = srsran_simd_cf_im(avx_result);
-
-    simd_f_t acc = srsran_simd_f_hadd(acc_re, acc_im);
-    for (int j = 2; j < SRSRAN_SIMD_F_SIZE; j *= 2) {
-      acc = srsran_simd_f_hadd(acc, acc);
-    }
-    srsran_simd_f_store(simd_dotProdVector, acc);
-    __real__ result = simd_dotProdVector[0];
-    __imag__ result = simd_dotProdVector[1];
-  }
-#endif
-
-  for (; i < len; i++) {
-    result += x[i] * conjf(y[i]);
-  }
-
-  return result;
-}
-
 void srsran_vec_prod_cfc_simd(const cf_t* x, const float* y, cf_t* z, const int len)
 {
   int i = 0;
@@ -1043,37 +877,6 @@ void srsran_vec_prod_ccc_c16_simd(const int16_t* a_re,
 }
 #endif /* ENABLE_C16 */
 
-void srsran_vec_prod_conj_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len)
-{
-  int i = 0;
-
-#if SRSRAN_SIMD_CF_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(y) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_load(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_load(&y[i]);
-
-      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
-
-      srsran_simd_cfi_store(&z[i], r);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_CF_SIZE + 1; i += SRSRAN_SIMD_CF_SIZE) {
-      simd_cf_t a = srsran_simd_cfi_loadu(&x[i]);
-      simd_cf_t b = srsran_simd_cfi_loadu(&y[i]);
-
-      simd_cf_t r = srsran_simd_cf_conjprod(a, b);
-
-      srsran_simd_cfi_storeu(&z[i], r);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = x[i] * conjf(y[i]);
-  }
-}
-
 void srsran_vec_div_ccc_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len)
 {
   int i = 0;
@@ -1301,74 +1104,6 @@ void srsran_vec_abs_cf_simd(const cf_t* x, float* z, const int len)
   }
 }
 
-void srsran_vec_abs_square_cf_simd(const cf_t* x, float* z, const int len)
-{
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t x1 = srsran_simd_f_load((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_load((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      srsran_simd_f_store(&z[i], z1);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE + 1; i += SRSRAN_SIMD_F_SIZE) {
-      simd_f_t x1 = srsran_simd_f_loadu((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_loadu((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      srsran_simd_f_storeu(&z[i], z1);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = __real__(x[i]) * __real__(x[i]) + __imag__(x[i]) * __imag__(x[i]);
-  }
-}
-
-void srsran_vec_sc_prod_cfc_simd(const cf_t* x, const float h, cf_t* z, const int len)
-{
-  int i = 0;
-
-#if SRSRAN_SIMD_F_SIZE
-  const simd_f_t tap = srsran_simd_f_set1(h);
-
-  if (SRSRAN_IS_ALIGNED(x) && SRSRAN_IS_ALIGNED(z)) {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t temp = srsran_simd_f_load((float*)&x[i]);
-
-      temp = srsran_simd_f_mul(tap, temp);
-
-      srsran_simd_f_store((float*)&z[i], temp);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_F_SIZE / 2 + 1; i += SRSRAN_SIMD_F_SIZE / 2) {
-      simd_f_t temp = srsran_simd_f_loadu((float*)&x[i]);
-
-      temp = srsran_simd_f_mul(tap, temp);
-
-      srsran_simd_f_storeu((float*)&z[i], temp);
-    }
-  }
-#endif
-
-  for (; i < len; i++) {
-    z[i] = x[i] * h;
-  }
-}
-
 void srsran_vec_sc_prod_fcc_simd(const float* x, const cf_t h, cf_t* z, const int len)
 {
   int i = 0;
@@ -1509,82 +1244,6 @@ uint32_t srsran_vec_max_abs_fi_simd(const float* x, const int len)
   return max_index;
 }
 
-uint32_t srsran_vec_max_ci_simd(const cf_t* x, const int len)
-{
-  int i = 0;
-
-  float    max_value = -INFINITY;
-  uint32_t max_index = 0;
-
-#if SRSRAN_SIMD_I_SIZE
-  srsran_simd_aligned int   indexes_buffer[SRSRAN_SIMD_I_SIZE] = {0};
-  srsran_simd_aligned float values_buffer[SRSRAN_SIMD_I_SIZE]  = {0};
-
-  for (int k = 0; k < SRSRAN_SIMD_I_SIZE; k++)
-    indexes_buffer[k] = k;
-  simd_i_t simd_inc         = srsran_simd_i_set1(SRSRAN_SIMD_I_SIZE);
-  simd_i_t simd_indexes     = srsran_simd_i_load(indexes_buffer);
-  simd_i_t simd_max_indexes = srsran_simd_i_set1(0);
-
-  simd_f_t simd_max_values = srsran_simd_f_set1(-INFINITY);
-
-  if (SRSRAN_IS_ALIGNED(x)) {
-    for (; i < len - SRSRAN_SIMD_I_SIZE + 1; i += SRSRAN_SIMD_I_SIZE) {
-      simd_f_t x1 = srsran_simd_f_load((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_load((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      simd_sel_t res = srsran_simd_f_max(z1, simd_max_values);
-
-      simd_max_indexes = srsran_simd_i_select(simd_max_indexes, simd_indexes, res);
-      simd_max_values  = srsran_simd_f_select(simd_max_values, z1, res);
-      simd_indexes     = srsran_simd_i_add(simd_indexes, simd_inc);
-    }
-  } else {
-    for (; i < len - SRSRAN_SIMD_I_SIZE + 1; i += SRSRAN_SIMD_I_SIZE) {
-      simd_f_t x1 = srsran_simd_f_loadu((float*)&x[i]);
-      simd_f_t x2 = srsran_simd_f_loadu((float*)&x[i + SRSRAN_SIMD_F_SIZE / 2]);
-
-      simd_f_t mul1 = srsran_simd_f_mul(x1, x1);
-      simd_f_t mul2 = srsran_simd_f_mul(x2, x2);
-
-      simd_f_t z1 = srsran_simd_f_hadd(mul1, mul2);
-
-      simd_sel_t res = srsran_simd_f_max(z1, simd_max_values);
-
-      simd_max_indexes = srsran_simd_i_select(simd_max_indexes, simd_indexes, res);
-      simd_max_values  = srsran_simd_f_select(simd_max_values, z1, res);
-      simd_indexes     = srsran_simd_i_add(simd_indexes, simd_inc);
-    }
-  }
-
-  srsran_simd_i_store(indexes_buffer, simd_max_indexes);
-  srsran_simd_f_store(values_buffer, simd_max_values);
-
-  for (int k = 0; k < SRSRAN_SIMD_I_SIZE; k++) {
-    if (values_buffer[k] > max_value) {
-      max_value = values_buffer[k];
-      max_index = (uint32_t)indexes_buffer[k];
-    }
-  }
-#endif /* SRSRAN_SIMD_I_SIZE */
-
-  for (; i < len; i++) {
-    cf_t  a    = x[i];
-    float abs2 = __real__ a * __real__ a + __imag__ a * __imag__ a;
-    if (abs2 > max_value) {
-      max_value = abs2;
-      max_index = (uint32_t)i;
-    }
-  }
-
-  return max_index;
-}
-
 void srsran_vec_interleave_simd(const cf_t* x, const cf_t* y, cf_t* z, const int len)
 {
   uint32_t i = 0, k = 0;
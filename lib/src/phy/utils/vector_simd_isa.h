@@ -0,0 +1,57 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSRAN_VECTOR_SIMD_ISA_H
+#define SRSRAN_VECTOR_SIMD_ISA_H
+
+#include "srsran/config.h"
+#include <stdint.h>
+
+/*
+ * Hot vector kernels built for one ISA, see vector_simd_isa.c. Signatures match the srsran_vec_*_simd functions.
+ */
+typedef struct {
+  const char* name;
+  void (*convert_fi)(const float* x, int16_t* z, const float scale, const int len);
+  void (*convert_conj_cs)(const cf_t* x, int16_t* z, const float scale, const int len);
+  cf_t (*acc_cc)(const cf_t* x, const int len);
+  cf_t (*dot_prod_conj_ccc)(const cf_t* x, const cf_t* y, const int len);
+  void (*prod_conj_ccc)(const cf_t* x, const cf_t* y, cf_t* z, const int len);
+  void (*abs_square_cf)(const cf_t* x, float* z, const int len);
+  void (*sc_prod_cfc)(const cf_t* x, const float h, cf_t* z, const int len);
+  uint32_t (*max_ci)(const cf_t* x, const int len);
+} srsran_vec_kernels_t;
+
+extern const srsran_vec_kernels_t srsran_vec_kernels_baseline;
+
+#ifdef SRSRAN_VEC_DISPATCH
+extern const srsran_vec_kernels_t srsran_vec_kernels_avx2;
+extern const srsran_vec_kernels_t srsran_vec_kernels_avx512;
+
+// Selected at load time by vector_dispatch.c
+extern const srsran_vec_kernels_t* srsran_vec_kernels;
+
+#define SRSRAN_VEC_KERNEL(NAME) (srsran_vec_kernels->NAME)
+#else
+#define SRSRAN_VEC_KERNEL(NAME) srsran_vec_##NAME##_simd
+#endif /* SRSRAN_VEC_DISPATCH */
+
+#endif // SRSRAN_VECTOR_SIMD_ISA_H
@@ -24,7 +24,7 @@
 
 #include "srsran/srslog/detail/log_entry.h"
 #include "srsran/srslog/detail/support/dyn_arg_store_pool.h"
-#include "srsran/srslog/detail/support/work_queue.h"
+#include "srsran/srslog/detail/support/mpsc_queue.h"
 #include "srsran/srslog/shared_types.h"
 #include <mutex>
 #include <thread>
@@ -36,7 +36,7 @@ namespace srslog {
 class backend_worker
 {
 public:
-  backend_worker(detail::work_queue<detail::log_entry>& queue, detail::dyn_arg_store_pool& arg_pool) :
+  backend_worker(detail::mpsc_queue<detail::log_entry>& queue, detail::dyn_arg_store_pool& arg_pool) :
     queue(queue), arg_pool(arg_pool), running_flag(false)
   {}
 
@@ -111,7 +111,7 @@ private:
   void set_thread_priority(backend_priority priority) const;
 
 private:
-  detail::work_queue<detail::log_entry>& queue;
+  detail::mpsc_queue<detail::log_entry>& queue;
   detail::dyn_arg_store_pool&            arg_pool;
   detail::shared_variable<bool>          running_flag;
   error_handler      err_handler = [](const std::string& error) { fmt::print(stderr, "srsLog error - {}\n", error); };
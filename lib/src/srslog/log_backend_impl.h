@@ -33,7 +33,18 @@ namespace srslog {
 class log_backend_impl : public detail::log_backend
 {
 public:
-  log_backend_impl() = default;
+  log_backend_impl()
+  {
+    // Entries evicted by the drop_oldest policy never reach the worker.
+    queue.set_discard_handler([this](detail::log_entry&& entry) {
+      if (entry.flush_cmd) {
+        // Release the flushing thread, the sinks get flushed by the next flush.
+        entry.flush_cmd->completion_flag = true;
+        return;
+      }
+      arg_pool.dealloc(entry.metadata.store);
+    });
+  }
 
   log_backend_impl(const log_backend_impl& other) = delete;
   log_backend_impl& operator=(const log_backend_impl& other) = delete;
@@ -60,8 +71,14 @@ public:
   /// Stops the backend worker thread.
   void stop() { worker.stop(); }
 
+  /// Selects what happens to new entries when the queue is full.
+  void set_overflow_policy(queue_overflow_policy policy) { queue.set_overflow_policy(policy); }
+
+  /// Number of entries discarded because the queue was full.
+  uint64_t get_nof_dropped() const { return queue.get_nof_dropped(); }
+
 private:
-  detail::work_queue<detail::log_entry> queue;
+  detail::mpsc_queue<detail::log_entry> queue;
   detail::dyn_arg_store_pool            arg_pool;
   backend_worker                        worker{queue, arg_pool};
 };
@@ -258,6 +258,16 @@ void srslog::set_error_handler(error_handler handler)
   srslog_instance::get().set_error_handler(std::move(handler));
 }
 
+void srslog::set_queue_overflow_policy(queue_overflow_policy policy)
+{
+  srslog_instance::get().set_queue_overflow_policy(policy);
+}
+
+uint64_t srslog::get_nof_dropped_entries()
+{
+  return srslog_instance::get().get_nof_dropped_entries();
+}
+
 ///
 /// Logger management function implementations.
 ///
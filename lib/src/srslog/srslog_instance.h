@@ -88,6 +88,12 @@ public:
   /// Installs the specified error handler into the backend.
   void set_error_handler(error_handler callback) { backend.set_error_handler(std::move(callback)); }
 
+  /// Selects the overflow policy of the backend queue.
+  void set_queue_overflow_policy(queue_overflow_policy policy) { backend.set_overflow_policy(policy); }
+
+  /// Number of log entries discarded by the backend queue.
+  uint64_t get_nof_dropped_entries() const { return backend.get_nof_dropped(); }
+
   /// Set the specified sink as the default one.
   void set_default_sink(sink& s) { default_sink = &s; }
 
@@ -0,0 +1,152 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srslog/detail/support/mpsc_queue.h"
+#include "srsran/srslog/detail/support/work_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/// Compares the lock free backend queue with the mutex protected one. Each
+/// producer pushes a fixed number of entries while a consumer drains the queue,
+/// the time spent inside every push gives the producer tail latency.
+
+using namespace srslog;
+
+namespace {
+
+/// Stands in for a log entry, large enough not to fit in a cache line.
+struct bench_entry {
+  uint64_t producer;
+  uint64_t seq;
+  char     payload[48];
+};
+
+struct bench_result {
+  double   mpushes_per_s;
+  double   p50_ns;
+  double   p99_ns;
+  double   p999_ns;
+  double   max_ns;
+  uint64_t nof_dropped;
+};
+
+} // namespace
+
+template <typename Queue>
+static bench_result run(Queue& q, unsigned nof_producers, unsigned nof_pushes)
+{
+  using clock = std::chrono::steady_clock;
+
+  std::vector<std::vector<uint32_t>> latencies(nof_producers);
+  std::vector<uint64_t>              dropped(nof_producers, 0);
+  std::atomic<unsigned>              nof_done{0};
+  std::atomic<bool>                  go{false};
+
+  std::thread consumer([&]() {
+    while (nof_done != nof_producers || q.try_pop().first) {
+    }
+  });
+
+  std::vector<std::thread> producers;
+  for (unsigned p = 0; p != nof_producers; ++p) {
+    producers.emplace_back([&, p]() {
+      latencies[p].reserve(nof_pushes);
+      bench_entry entry = {};
+      entry.producer    = p;
+      while (!go) {
+      }
+      for (unsigned i = 0; i != nof_pushes; ++i) {
+        entry.seq  = i;
+        auto start = clock::now();
+        bool ok    = q.push(entry);
+        auto end   = clock::now();
+        latencies[p].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        dropped[p] += ok ? 0 : 1;
+      }
+      ++nof_done;
+    });
+  }
+
+  auto start = clock::now();
+  go         = true;
+  for (auto& t : producers) {
+    t.join();
+  }
+  double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  consumer.join();
+
+  std::vector<uint32_t> all;
+  for (const auto& l : latencies) {
+    all.insert(all.end(), l.begin(), l.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto pct = [&all](double p) { return (double)all[std::min(all.size() - 1, (size_t)(p * all.size()))]; };
+
+  bench_result res;
+  res.mpushes_per_s = all.size() / elapsed / 1e6;
+  res.p50_ns        = pct(0.5);
+  res.p99_ns        = pct(0.99);
+  res.p999_ns       = pct(0.999);
+  res.max_ns        = all.back();
+  res.nof_dropped   = 0;
+  for (uint64_t d : dropped) {
+    res.nof_dropped += d;
+  }
+  return res;
+}
+
+static void print(const char* name, unsigned nof_producers, const bench_result& res)
+{
+  std::printf("%-6s producers=%-2u %7.2f Mpush/s  p50=%6.0f ns  p99=%7.0f ns  p99.9=%8.0f ns  max=%9.0f ns  "
+              "dropped=%lu\n",
+              name,
+              nof_producers,
+              res.mpushes_per_s,
+              res.p50_ns,
+              res.p99_ns,
+              res.p999_ns,
+              res.max_ns,
+              (unsigned long)res.nof_dropped);
+}
+
+int main(int argc, char** argv)
+{
+  // Pushes per producer.
+  unsigned nof_pushes = (argc > 1) ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 200000;
+
+  for (unsigned nof_producers : {1U, 4U, 16U}) {
+    {
+      detail::work_queue<bench_entry> q;
+      print("mutex", nof_producers, run(q, nof_producers, nof_pushes));
+    }
+    {
+      detail::mpsc_queue<bench_entry> q;
+      print("mpsc", nof_producers, run(q, nof_producers, nof_pushes));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * Copyright 2013-2023 Software Radio Systems Limited
+ *
+ * This file is part of srsRAN.
+ *
+ * srsRAN is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsRAN is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsran/srslog/detail/support/mpsc_queue.h"
+#include <atomic>
+#include <cstdio>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace srslog;
+
+#define TESTASSERT(cond)                                                                                               \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      std::fprintf(stderr, "[%s][Line %d] Fail at \"%s\"\n", __FUNCTION__, __LINE__, (#cond));                         \
+      return false;                                                                                                    \
+    }                                                                                                                  \
+  } while (0)
+
+static constexpr size_t test_capacity = 16;
+
+static bool when_queue_is_full_with_drop_newest_then_push_fails()
+{
+  detail::mpsc_queue<int, test_capacity> q;
+
+  for (int i = 0; i != (int)test_capacity; ++i) {
+    TESTASSERT(q.push(i));
+  }
+  TESTASSERT(q.is_almost_full());
+  TESTASSERT(!q.push(100));
+  TESTASSERT(q.get_nof_dropped() == 1);
+
+  // The queued elements are untouched.
+  for (int i = 0; i != (int)test_capacity; ++i) {
+    auto item = q.try_pop();
+    TESTASSERT(item.first);
+    TESTASSERT(item.second == i);
+  }
+  TESTASSERT(!q.try_pop().first);
+
+  return true;
+}
+
+static bool when_queue_is_full_with_drop_oldest_then_oldest_is_discarded()
+{
+  detail::mpsc_queue<int, test_capacity> q;
+  std::vector<int>                       discarded;
+  q.set_overflow_policy(queue_overflow_policy::drop_oldest);
+  q.set_discard_handler([&discarded](int&& i) { discarded.push_back(i); });
+
+  int total = test_capacity + 5;
+  for (int i = 0; i != total; ++i) {
+    TESTASSERT(q.push(i));
+  }
+  TESTASSERT(q.get_nof_dropped() == 5);
+  TESTASSERT(discarded == std::vector<int>({0, 1, 2, 3, 4}));
+
+  for (int i = 5; i != total; ++i) {
+    auto item = q.try_pop();
+    TESTASSERT(item.first);
+    TESTASSERT(item.second == i);
+  }
+  TESTASSERT(!q.try_pop().first);
+
+  return true;
+}
+
+static bool when_queue_is_full_with_block_then_push_waits_for_room()
+{
+  detail::mpsc_queue<int, test_capacity> q;
+  q.set_overflow_policy(queue_overflow_policy::block);
+
+  for (int i = 0; i != (int)test_capacity; ++i) {
+    TESTASSERT(q.push(i));
+  }
+
+  std::thread consumer([&q]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    q.try_pop();
+  });
+  bool pushed = q.push(100);
+  consumer.join();
+  TESTASSERT(pushed);
+  TESTASSERT(q.get_nof_dropped() == 0);
+
+  return true;
+}
+
+static bool when_many_producers_push_then_every_element_is_popped_once()
+{
+  static constexpr int nof_producers = 8;
+  static constexpr int nof_items     = 20000;
+
+  detail::mpsc_queue<int, test_capacity> q;
+  q.set_overflow_policy(queue_overflow_policy::block);
+
+  std::vector<std::thread> producers;
+  std::atomic<int>         nof_finished{0};
+  for (int p = 0; p != nof_producers; ++p) {
+    producers.emplace_back([&q, &nof_finished, p]() {
+      for (int i = 0; i != nof_items; ++i) {
+        q.push(p * nof_items + i);
+      }
+      ++nof_finished;
+    });
+  }
+
+  // Elements of one producer come out in the order it pushed them. The queue is drained until every producer is done,
+  // so that the threads can be joined before checking the results.
+  std::vector<int> last(nof_producers, -1);
+  std::set<int>    seen;
+  bool             in_order  = true;
+  bool             no_repeat = true;
+  while (true) {
+    bool finished = nof_finished == nof_producers;
+    auto item     = q.try_pop();
+    if (!item.first) {
+      if (finished) {
+        break;
+      }
+      continue;
+    }
+    int p = item.second / nof_items;
+    in_order &= item.second > last[p];
+    last[p] = item.second;
+    no_repeat &= seen.insert(item.second).second;
+  }
+  for (auto& t : producers) {
+    t.join();
+  }
+  TESTASSERT(in_order);
+  TESTASSERT(no_repeat);
+  TESTASSERT(seen.size() == (size_t)nof_producers * nof_items);
+
+  return true;
+}
+
+#define TEST_FUNCTION(func)                                                                                            \
+  do {                                                                                                                 \
+    if (!func()) {                                                                                                     \
+      std::fprintf(stderr, "Test \"%s\" failed\n", (#func));                                                           \
+      return -1;                                                                                                       \
+    }                                                                                                                  \
+  } while (0)
+
+int main()
+{
+  TEST_FUNCTION(when_queue_is_full_with_drop_newest_then_push_fails);
+  TEST_FUNCTION(when_queue_is_full_with_drop_oldest_then_oldest_is_discarded);
+  TEST_FUNCTION(when_queue_is_full_with_block_then_push_waits_for_room);
+  TEST_FUNCTION(when_many_producers_push_then_every_element_is_popped_once);
+
+  return 0;
+}
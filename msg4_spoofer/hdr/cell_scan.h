@@ -0,0 +1,69 @@
+#pragma once
+
+#include "config.h"
+#include "rf_base.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <srsran/phy/resampling/resampler.h>
+#include <srsran/phy/sync/ssb.h>
+#include <vector>
+
+/* One cell found by the scan */
+typedef struct cell_scan_result_s {
+  double frequency; // in Hz, SSB center frequency
+  uint32_t N_id;
+  float rsrp_dB;
+  float snr_dB;
+} cell_scan_result_t;
+
+/*
+ * Wideband cell search. A single capture of rf.srate around rf.rx_frequency
+ * is split into one sub-band per SSB raster point of the band that fits in
+ * it. Each sub-band is mixed down to DC, decimated to
+ * cell_scan.subband_srate with the FFT resampler and searched with
+ * srsran_ssb_search. Worker threads take raster points in turn, each with
+ * its own SSB object and resampler.
+ */
+class cell_scan {
+public:
+  cell_scan(const spoofer_config_t &config);
+  ~cell_scan();
+
+  cell_scan(const cell_scan &) = delete;
+  cell_scan &operator=(const cell_scan &) = delete;
+
+  // Captures from `rf` and returns the cells whose PBCH decoded, strongest
+  // first
+  spoofer_error_e run(RFBase &rf, std::vector<cell_scan_result_t> &results);
+
+  size_t get_nof_candidates() const { return candidates.size(); }
+
+private:
+  typedef struct worker_s {
+    srsran_ssb_t ssb;
+    srsran_resampler_fft_t resampler;
+    bool ssb_initialized;
+    bool resampler_initialized;
+    cf_t *mixed;   // capture shifted to the raster point
+    cf_t *subband; // decimated
+  } worker_t;
+
+  void init();
+  void release();
+  void work(uint32_t id);
+
+  spoofer_config_t config;
+  srsran_ssb_pattern_t pattern;
+  srsran_duplex_mode_t duplex_mode;
+  uint32_t ratio = 1;
+  uint32_t nof_samples = 0;
+  cf_t *capture = nullptr;
+
+  std::vector<double> candidates; // SSB center frequencies in Hz
+  std::atomic<size_t> next_candidate = 0;
+
+  std::vector<std::unique_ptr<worker_t>> workers;
+  std::mutex results_mutex;
+  std::vector<cell_scan_result_t> found;
+};
@@ -5,16 +5,34 @@
 #define GAIN_DEFAULT 50.0
 #define PRB_DEFAULT 106
 
+#define RF_MAX_CHANNELS 8
+
+#define METRICS_PERIOD_DEFAULT 10.0 // in seconds
+
+#define SSB_PERIODICITY_DEFAULT 20   // in millisecond
+#define SSB_SYNC_TIMEOUT_DEFAULT 5.0 // in seconds
+
 #define PRACH_CONFIG_IDX_DEFAULT 1
 #define PRACH_ROOT_SEQ_IDX_DEFUALT 1
 #define PRACH_ZERO_CORR_ZONE_DEFUALT 0
 #define PRACH_NUM_RA_PREAMBLES_DEFAULT 64
 #define PRACH_FREQ_OFFSET_DEFAULT 0
+#define PRACH_LEAD_TIME_DEFAULT 2.0 // in millisecond
+
+#define SWEEP_OCCASIONS_DEFAULT 100
+
+#define SCAN_THREADS_DEFAULT 0 // one per core
+
+#define CELL_SCAN_DURATION_DEFAULT 25.0      // in millisecond
+#define CELL_SCAN_SUBBAND_SRATE_DEFAULT 3.84e6 // fits a 15 kHz SSB
 
 #include "logging.h"
+#include "srsran/phy/phch/prach.h"
 #include "srsran/phy/sync/ssb.h"
 #include "toml.h"
 #include <cstring>
+#include <string>
+#include <vector>
 
 typedef enum spoofer_error_t {
   SUCCESS = 0,
@@ -26,6 +44,14 @@ typedef enum spoofer_error_t {
   SAMPLE_ERROR
 } spoofer_error_e;
 
+/* One TX channel, possibly on another motherboard of a multi-USRP setup */
+typedef struct channel_config_s {
+  double frequency;
+  float tx_gain;
+  // Preamble indices cycled on this channel, one per occasion
+  std::vector<uint32_t> preambles;
+} channel_config_t;
+
 typedef struct rf_config_s {
   uint32_t freq_offset;
   float rx_gain;
@@ -33,6 +59,7 @@ typedef struct rf_config_s {
   double srate;
 
   double frequency;
+  double rx_frequency;
   uint32_t nof_prb;
   uint32_t N_id;
   uint32_t ssb_numerology;
@@ -41,12 +68,28 @@ typedef struct rf_config_s {
   const char *device_args;
 
   std::string file_path;
+  bool file_index; // Write a burst index next to the capture
+
+  bool continuous_tx; // Keep one TX burst open and pad between preambles
+  double rate_limit;  // zmq only, in samples per second, 0 disables
+
+  // "internal" or a shared PPS reference ("external", "gpsdo") aligning the
+  // time of every motherboard
+  std::string time_source;
+  std::vector<channel_config_t> channels;
 } rf_config_t;
 
 typedef struct ssb_config_s {
   srsran_ssb_pattern_t ssb_pattern = SRSRAN_SSB_PATTERN_A;
   srsran_subcarrier_spacing_t ssb_scs = srsran_subcarrier_spacing_15kHz;
   srsran_duplex_mode_t duplex_mode = SRSRAN_DUPLEX_MODE_FDD;
+  bool enable_sync = false; // Lock PRACH timing to the cell SSB
+  double ssb_frequency;
+  uint32_t periodicity_ms = 20;
+  double sync_timeout; // in seconds
+  // Skip PSS correlation windows weaker than this factor of the average
+  // power, 0 correlates every window
+  float pss_prune_thr;
 } ssb_config_t;
 
 /* struct available in prach.h*/
@@ -58,20 +101,95 @@ typedef struct prach_config_s {
   uint32_t freq_offset;
   uint32_t num_ra_preambles;
   bool hs_flag;
-  uint64_t time_delay;
+  double lead_time; // in seconds, how far ahead of an occasion to send
+  std::string cache_dir; // On-disk waveform cache, empty disables it
   // srsran_tdd_config_t tdd_config; // leave these to default
   // bool enable_successive_cancellation;
   // bool enable_freq_domain_offset_calc;
 } prach_config_t;
 
+/*
+ * Sweep over every combination of the listed PRACH parameters, an empty list
+ * keeps the value of the [prach] section
+ */
+typedef struct sweep_config_s {
+  bool enable;
+  std::vector<uint32_t> config_idx;
+  std::vector<uint32_t> root_seq_idx;
+  std::vector<uint32_t> zero_corr_zone;
+  uint32_t occasions; // PRACH occasions spent on each configuration
+} sweep_config_t;
+
+/*
+ * Offline PRACH detection over a recorded capture instead of transmitting
+ */
+typedef struct scan_config_s {
+  bool enable;
+  std::string input;  // .fc32 capture, sample 0 at device time 0
+  std::string output; // CSV for a .csv path, binary records otherwise
+  double tti0_time;   // in seconds, device time at which TTI 0 starts
+  uint32_t threads;   // 0 uses one per core
+} scan_config_t;
+
+/*
+ * Look for cells on every SSB raster point inside one wideband capture
+ * instead of transmitting
+ */
+typedef struct cell_scan_config_s {
+  bool enable;
+  uint32_t band;        // 0 takes the band of rf.rx_frequency
+  double duration;      // in seconds, capture length
+  double subband_srate; // rate each raster point is decimated to
+  uint32_t threads;     // 0 uses one per core
+} cell_scan_config_t;
+
+/*
+ * FFTW wisdom. The wisdom file is read at start up and only written by the
+ * precompute run.
+ */
+typedef struct fft_config_s {
+  std::string wisdom_file; // empty keeps the library default
+  bool precompute; // plan the FFTs of this configuration, save them and exit
+} fft_config_t;
+
+typedef struct log_config_s {
+  double metrics_period; // in seconds, 0 disables the periodic TX report
+} log_config_t;
+
 typedef struct spoofer_config_s {
+  log_config_t log;
   rf_config_t rf;
   ssb_config_t ssb;
   prach_config_t prach;
+  sweep_config_t sweep;
+  scan_config_t scan;
+  cell_scan_config_t cell_scan;
+  fft_config_t fft;
 } spoofer_config_t;
 
+static void load_index_list(toml::node_view<toml::node> node,
+                            std::vector<uint32_t> &list) {
+  if (toml::array *arr = node.as_array()) {
+    for (toml::node &i : *arr) {
+      list.push_back(i.value_or(0));
+    }
+  }
+}
+
+static srsran_prach_cfg_t get_prach_cfg(const spoofer_config_t &conf) {
+  srsran_prach_cfg_t prach_cfg = {};
+  prach_cfg.is_nr = conf.prach.is_nr;
+  prach_cfg.config_idx = conf.prach.config_idx;
+  prach_cfg.hs_flag = conf.prach.hs_flag;
+  prach_cfg.freq_offset = conf.prach.freq_offset;
+  prach_cfg.root_seq_idx = conf.prach.root_seq_idx;
+  prach_cfg.zero_corr_zone = conf.prach.zero_corr_zone;
+  prach_cfg.num_ra_preambles = conf.prach.num_ra_preambles;
+  return prach_cfg;
+}
+
 static spoofer_config_t load(std::string config_path) {
-  printf("Loading config from path: %s\n", config_path.c_str());
+  LOG_INFO("Loading config from path: %s", config_path.c_str());
   toml::table toml = toml::parse_file(config_path);
   spoofer_config_t conf;
 
@@ -81,6 +199,8 @@ static spoofer_config_t load(std::string config_path) {
   conf.rf.srate = toml["rf"]["srate"].value_or(23.04e6);
 
   conf.rf.frequency = toml["rf"]["frequency"].value_or(1842.5e6);
+  conf.rf.rx_frequency =
+      toml["rf"]["rx_frequency"].value_or(conf.rf.frequency);
   conf.rf.nof_prb = toml["rf"]["nof_prb"].value_or(106);
   conf.rf.N_id = toml["rf"]["N_id"].value_or(1);
   conf.rf.ssb_numerology = toml["rf"]["ssb_numerology"].value_or(0);
@@ -88,12 +208,25 @@ static spoofer_config_t load(std::string config_path) {
   conf.rf.device_name = toml["rf"]["device_name"].value_or("uhd");
   conf.rf.device_args = toml["rf"]["device_args"].value_or("type=b200");
   conf.rf.file_path = toml["rf"]["file_path"].value_or("");
+  conf.rf.file_index = toml["rf"]["file_index"].value_or(false);
+  conf.rf.continuous_tx = toml["rf"]["continuous_tx"].value_or(false);
+  conf.rf.time_source = toml["rf"]["time_source"].value_or("internal");
+  conf.rf.rate_limit = toml["rf"]["rate_limit"].value_or(0.0);
 
   // Preconfigured right now
   conf.ssb.ssb_pattern = SRSRAN_SSB_PATTERN_A;
   conf.ssb.ssb_scs = srsran_subcarrier_spacing_15kHz;
   conf.ssb.duplex_mode = SRSRAN_DUPLEX_MODE_FDD;
 
+  conf.ssb.enable_sync = toml["ssb"]["enable_sync"].value_or(false);
+  conf.ssb.ssb_frequency =
+      toml["ssb"]["frequency"].value_or(conf.rf.rx_frequency);
+  conf.ssb.periodicity_ms =
+      toml["ssb"]["periodicity"].value_or(SSB_PERIODICITY_DEFAULT);
+  conf.ssb.sync_timeout =
+      toml["ssb"]["sync_timeout"].value_or(SSB_SYNC_TIMEOUT_DEFAULT);
+  conf.ssb.pss_prune_thr = toml["ssb"]["pss_prune_thr"].value_or(0.0);
+
   conf.prach.config_idx =
       toml["prach"]["config_idx"].value_or(PRACH_CONFIG_IDX_DEFAULT);
   conf.prach.is_nr = toml["prach"]["is_nr"].value_or(true);
@@ -104,18 +237,80 @@ static spoofer_config_t load(std::string config_path) {
       PRACH_ZERO_CORR_ZONE_DEFUALT);
   conf.prach.num_ra_preambles = toml["prach"]["num_ra_preambles"].value_or(
       PRACH_NUM_RA_PREAMBLES_DEFAULT);
-  conf.prach.time_delay = toml["prach"]["time_delay"].value_or(1);
+  conf.prach.freq_offset =
+      toml["prach"]["freq_offset"].value_or(PRACH_FREQ_OFFSET_DEFAULT);
+  conf.prach.lead_time =
+      toml["prach"]["lead_time"].value_or(PRACH_LEAD_TIME_DEFAULT) * 1e-3;
+  conf.prach.cache_dir = toml["prach"]["cache_dir"].value_or("");
+
+  conf.sweep.enable = toml["sweep"]["enable"].value_or(false);
+  load_index_list(toml["sweep"]["config_idx"], conf.sweep.config_idx);
+  load_index_list(toml["sweep"]["root_sequence_index"],
+                  conf.sweep.root_seq_idx);
+  load_index_list(toml["sweep"]["zero_correlation_zone"],
+                  conf.sweep.zero_corr_zone);
+  conf.sweep.occasions =
+      toml["sweep"]["occasions"].value_or(SWEEP_OCCASIONS_DEFAULT);
+
+  conf.scan.enable = toml["scan"]["enable"].value_or(false);
+  conf.scan.input = toml["scan"]["input"].value_or("");
+  conf.scan.output = toml["scan"]["output"].value_or("detections.csv");
+  conf.scan.tti0_time = toml["scan"]["tti0_time"].value_or(0.0);
+  conf.scan.threads =
+      toml["scan"]["threads"].value_or(SCAN_THREADS_DEFAULT);
+
+  conf.cell_scan.enable = toml["cell_scan"]["enable"].value_or(false);
+  conf.cell_scan.band = toml["cell_scan"]["band"].value_or(0);
+  conf.cell_scan.duration =
+      toml["cell_scan"]["duration"].value_or(CELL_SCAN_DURATION_DEFAULT) *
+      1e-3;
+  conf.cell_scan.subband_srate = toml["cell_scan"]["subband_srate"].value_or(
+      CELL_SCAN_SUBBAND_SRATE_DEFAULT);
+  conf.cell_scan.threads =
+      toml["cell_scan"]["threads"].value_or(SCAN_THREADS_DEFAULT);
+
+  conf.fft.wisdom_file = toml["fft"]["wisdom_file"].value_or("");
+  conf.fft.precompute = toml["fft"]["precompute"].value_or(false);
+
+  // Without [[rf.channels]] tables a single channel transmits every preamble
+  // at rf.frequency
+  if (toml::array *channels = toml["rf"]["channels"].as_array()) {
+    for (toml::node &node : *channels) {
+      toml::table *tbl = node.as_table();
+      if (tbl == nullptr) {
+        continue;
+      }
+      channel_config_t ch = {};
+      ch.frequency = (*tbl)["frequency"].value_or(conf.rf.frequency);
+      ch.tx_gain = (*tbl)["tx_gain"].value_or(conf.rf.tx_gain);
+      load_index_list((*tbl)["preambles"], ch.preambles);
+      conf.rf.channels.push_back(ch);
+    }
+  }
+  if (conf.rf.channels.empty()) {
+    conf.rf.channels.push_back({conf.rf.frequency, conf.rf.tx_gain, {}});
+  }
+  for (channel_config_t &ch : conf.rf.channels) {
+    if (ch.preambles.empty()) {
+      for (uint32_t i = 0; i < conf.prach.num_ra_preambles; i++) {
+        ch.preambles.push_back(i);
+      }
+    }
+  }
+
+  conf.log.metrics_period =
+      toml["log"]["metrics_period"].value_or(METRICS_PERIOD_DEFAULT);
 
   std::string log_level_str = toml["log"]["level"].value_or("debug");
 
   if (log_level_str == "error")
-    log_level = ERROR;
+    set_log_level(ERROR);
   else if (log_level_str == "info")
-    log_level = INFO;
+    set_log_level(INFO);
   else if (log_level_str == "warning")
-    log_level = WARNING;
+    set_log_level(WARNING);
   else if (log_level_str == "debug")
-    log_level = DEBUG;
+    set_log_level(DEBUG);
 
   return conf;
 }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "config.h"
+#include "device_clock.h"
+#include "rf_base.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Maximum number of bursts waiting to be spliced into the stream
+#define CONTINUOUS_TX_QUEUE_SIZE 16
+
+/*
+ * Continuous TX mode. A dedicated thread keeps a single UHD burst open and
+ * feeds it with zeros between the scheduled bursts, which are spliced in at
+ * their exact sample offset straight from the caller's buffers. The stream
+ * cursor is kept lead_time ahead of the device clock.
+ */
+class continuous_tx {
+public:
+  continuous_tx(const spoofer_config_t &config, RFBase &rf);
+  ~continuous_tx();
+
+  continuous_tx(const continuous_tx &) = delete;
+  continuous_tx &operator=(const continuous_tx &) = delete;
+
+  // Start streaming at device time `start_time` (in seconds)
+  spoofer_error_e start(double start_time);
+  void stop();
+
+  // Queue a timed burst, blocks while the queue is full. The samples must
+  // remain valid until the burst has been sent, `owner` is held until then.
+  spoofer_error_e schedule(const tx_burst_t &burst,
+                           std::shared_ptr<const void> owner = nullptr);
+
+  uint64_t get_nof_sent() const { return nof_sent; }
+  uint64_t get_nof_late() const { return nof_late; }
+
+private:
+  void run_thread();
+  spoofer_error_e send(const void *const *data, size_t nof_samples,
+                       tx_format_t fmt);
+  spoofer_error_e send_zeros(uint64_t nof_samples);
+
+  const spoofer_config_t &config;
+  RFBase &rf;
+  double srate;
+  double lead_time;
+  uint32_t chunk_len; // zero padding granularity in samples
+  tx_format_t format;
+  uint32_t nof_channels;
+  void *zeros = nullptr;
+  // Every channel pads from the same zeros
+  const void *zero_buffs[RF_MAX_CHANNELS] = {};
+
+  // Stream position in samples since start_time
+  double start_time = 0.0;
+  uint64_t cursor = 0;
+  bool first_segment = true;
+
+  // Paces the stream against the device clock, only used by the TX thread
+  // once started
+  device_clock clock;
+
+  std::mutex queue_mutex;
+  std::condition_variable queue_cvar;
+  struct queued_burst_t {
+    tx_burst_t burst;
+    std::shared_ptr<const void> owner;
+  };
+  std::deque<queued_burst_t> queue;
+
+  std::atomic<bool> running{false};
+  std::atomic<uint64_t> nof_sent{0};
+  std::atomic<uint64_t> nof_late{0};
+  std::thread tx_thread;
+  log_limiter late_limiter{LOG_LIMIT_PERIOD};
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "rf_base.h"
+#include <chrono>
+
+// Host and device oscillators drift apart, re-read the device time this often
+#define DEVICE_CLOCK_RESYNC_PERIOD 1.0
+
+/*
+ * Estimates the device time from the host steady clock so that the TX path
+ * does not query the device on every burst. The pair is anchored by sync()
+ * and re-anchored by track() every DEVICE_CLOCK_RESYNC_PERIOD seconds, which
+ * keeps the drift between the two clocks well within the TX lead time.
+ */
+class device_clock {
+public:
+  explicit device_clock(RFBase &rf_) : rf(rf_) { sync(); }
+
+  // Re-anchor on the current device time
+  void sync() {
+    time_ref = rf.get_time_now();
+    host_ref = std::chrono::steady_clock::now();
+  }
+
+  // Re-anchor once the last anchor is older than the resync period
+  void track() {
+    std::chrono::duration<double> age =
+        std::chrono::steady_clock::now() - host_ref;
+    if (age.count() >= DEVICE_CLOCK_RESYNC_PERIOD) {
+      sync();
+    }
+  }
+
+  // Estimated current device time in seconds
+  double now() const {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - host_ref;
+    return time_ref + elapsed.count();
+  }
+
+  // Host time at which the device clock reaches `time_s`
+  std::chrono::steady_clock::time_point host_time(double time_s) const {
+    std::chrono::duration<double> wait(time_s - time_ref);
+    return host_ref +
+           std::chrono::duration_cast<std::chrono::nanoseconds>(wait);
+  }
+
+private:
+  RFBase &rf;
+  double time_ref = 0.0;
+  std::chrono::steady_clock::time_point host_ref;
+};
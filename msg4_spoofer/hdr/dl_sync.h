@@ -0,0 +1,54 @@
+#pragma once
+
+#include "config.h"
+#include "rf_base.h"
+#include <atomic>
+#include <mutex>
+#include <srsran/phy/ue/ue_sync_nr.h>
+#include <thread>
+
+/* Downlink timing of the target cell as seen by the device clock */
+typedef struct dl_timing_s {
+  bool in_sync;
+  uint32_t tti;   // SFN * 10 + subframe index of the TTI starting at `time`
+  double time;    // device time in seconds at which `tti` starts
+  float cfo_hz;   // estimated carrier frequency offset
+  float delay_us; // average residual SSB delay
+} dl_timing_t;
+
+/*
+ * Receive pipeline stage that acquires the configured cell SSB with
+ * srsran_ue_sync_nr and keeps tracking its frame and subframe boundaries in
+ * a background thread.
+ */
+class dl_sync {
+public:
+  dl_sync(const spoofer_config_t &config, RFBase &rf);
+  ~dl_sync();
+
+  spoofer_error_e start();
+  void stop();
+
+  // Latest SFN/subframe to device time mapping
+  dl_timing_t get_timing();
+
+  // Block until the cell is tracked or `timeout_s` seconds have elapsed
+  bool wait_sync(double timeout_s);
+
+private:
+  static int recv_callback(void *ptr, cf_t **buffer, uint32_t nof_samples,
+                           srsran_timestamp_t *timestamp);
+  void run_thread();
+
+  RFBase &rf;
+  srsran_ue_sync_nr_t ue_sync = {};
+  cf_t *sf_buffer = nullptr;
+  uint32_t sf_len = 0;
+  double srate = 0.0;
+
+  std::mutex timing_mutex;
+  dl_timing_t timing = {};
+
+  std::atomic<bool> running{false};
+  std::thread rx_thread;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "config.h"
+#include <vector>
+
+/*
+ * Offline FFTW wisdom generation. Plans every DFT the given sweep points use:
+ * the PRACH generation and detection sizes with their batched variants, and
+ * the SSB correlation sizes of downlink sync and cell scan when enabled. The
+ * accumulated wisdom is then written to the wisdom file, so that later runs
+ * with the same configuration only look plans up.
+ */
+spoofer_error_e
+precompute_fft_wisdom(const spoofer_config_t &config,
+                      const std::vector<spoofer_config_t> &points);
+
+// Logs how many plans this process created and the time they took
+void report_fft_planning();
@@ -1,32 +1,76 @@
 #ifndef LOGGING_H
 #define LOGGING_H
 
+#include <chrono>
+#include <cstdint>
+#include <srsran/srslog/srslog.h>
+
+// Rate of messages that can repeat on every burst
+#define LOG_LIMIT_PERIOD 1.0 // in seconds
+
 typedef enum log_level_e { ERROR = 0, WARNING, INFO, DEBUG } log_level_t;
 
 extern log_level_t log_level;
 
-#define LOG_ERROR(msg, ...)                                                    \
-  do {                                                                         \
-    if (log_level >= ERROR)                                                    \
-      fprintf(stderr, "[ERROR] " msg "\n", ##__VA_ARGS__);                     \
-  } while (0)
+// Starts the asynchronous backend. Messages are formatted and written by the
+// srslog worker thread, a full queue drops them instead of blocking the
+// caller. Messages logged before this call are queued.
+void init_logging();
 
-#define LOG_WARN(msg, ...)                                                     \
-  do {                                                                         \
-    if (log_level >= WARNING)                                                  \
-      fprintf(stderr, "[WARN ] " msg "\n", ##__VA_ARGS__);                     \
-  } while (0)
+void set_log_level(log_level_t level);
 
-#define LOG_INFO(msg, ...)                                                     \
-  do {                                                                         \
-    if (log_level >= INFO)                                                     \
-      fprintf(stdout, "[INFO ] " msg "\n", ##__VA_ARGS__);                     \
-  } while (0)
+// Entries dropped so far because the backend queue was full
+uint64_t get_nof_dropped_logs();
+
+// Errors and warnings go to stderr, the rest to stdout
+srslog::basic_logger &spoofer_logger();
+
+#define LOG_ERROR(msg, ...) spoofer_logger().error(msg, ##__VA_ARGS__)
+#define LOG_WARN(msg, ...) spoofer_logger().warning(msg, ##__VA_ARGS__)
+#define LOG_INFO(msg, ...) spoofer_logger().info(msg, ##__VA_ARGS__)
+#define LOG_DEBUG(msg, ...) spoofer_logger().debug(msg, ##__VA_ARGS__)
+
+/*
+ * Lets one message through per period and counts the ones it holds back, for
+ * events that can repeat on every burst. Not thread safe, each call site
+ * owns one.
+ */
+class log_limiter {
+public:
+  explicit log_limiter(double period_s)
+      : period(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(period_s))) {}
+
+  // True when a message may go out now, `suppressed` then holds the number
+  // held back since the previous one
+  bool allow(uint64_t &suppressed) {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next) {
+      held++;
+      return false;
+    }
+    next = now + period;
+    suppressed = held;
+    held = 0;
+    return true;
+  }
+
+private:
+  std::chrono::steady_clock::duration period;
+  std::chrono::steady_clock::time_point next = {};
+  uint64_t held = 0;
+};
 
-#define LOG_DEBUG(msg, ...)                                                    \
+#define LOG_WARN_LIMITED(limiter, msg, ...)                                    \
   do {                                                                         \
-    if (log_level >= DEBUG)                                                    \
-      fprintf(stdout, "[DEBUG] " msg "\n", ##__VA_ARGS__);                     \
+    uint64_t suppressed_;                                                      \
+    if ((limiter).allow(suppressed_)) {                                        \
+      if (suppressed_ > 0)                                                     \
+        LOG_WARN(msg " (%lu similar suppressed)", ##__VA_ARGS__,               \
+                 (unsigned long)suppressed_);                                  \
+      else                                                                     \
+        LOG_WARN(msg, ##__VA_ARGS__);                                          \
+    }                                                                          \
   } while (0)
 
 #endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "config.h"
+#include "prach_scheduler.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define PRACH_SCAN_MAGIC "PRACHDT"
+#define PRACH_SCAN_VERSION 1
+
+// Occasions handed to a worker at a time
+#define PRACH_SCAN_JOB_OCCASIONS 256
+
+/* One detected preamble, also the record layout of binary output files */
+typedef struct prach_detection_s {
+  double time;    // in seconds, device time of the occasion
+  uint32_t index; // preamble index
+  float t_offset; // in seconds, arrival after the occasion start
+  float peak_to_avg;
+} prach_detection_t;
+
+/*
+ * Offline PRACH detection over a recorded .fc32 capture, e.g. one written by
+ * the file backend. The capture is memory-mapped and cut into windows at the
+ * PRACH occasions of the [prach] configuration, TTI 0 starting at
+ * scan.tti0_time. Runs of occasions are queued on worker threads, each with
+ * its own srsran_prach_t, and a worker that runs out of work steals from the
+ * back of another worker's queue. Detections are written to scan.output
+ * sorted by time, as CSV or as a binary header followed by
+ * prach_detection_t records.
+ */
+class prach_scan {
+public:
+  prach_scan(const spoofer_config_t &config);
+  ~prach_scan();
+
+  prach_scan(const prach_scan &) = delete;
+  prach_scan &operator=(const prach_scan &) = delete;
+
+  spoofer_error_e run();
+
+private:
+  // Range of occasions
+  typedef struct job_s {
+    size_t begin;
+    size_t end;
+  } job_t;
+
+  typedef struct worker_s {
+    srsran_prach_t prach;
+    bool initialized;
+    std::mutex mutex;
+    std::deque<job_t> jobs;
+    std::vector<prach_detection_t> detections;
+    spoofer_error_e ret;
+  } worker_t;
+
+  // Workers and occasions, throws on failure
+  void init();
+  void release();
+  void work(uint32_t id);
+  bool next_job(uint32_t id, job_t &job);
+  spoofer_error_e write_csv(const std::vector<prach_detection_t> &detections);
+  spoofer_error_e
+  write_binary(const std::vector<prach_detection_t> &detections);
+
+  spoofer_config_t config;
+  prach_scheduler scheduler;
+
+  const cf_t *samples = nullptr;
+  size_t mapping_size = 0; // in bytes
+  uint64_t nof_samples = 0;
+
+  // Start sample and device time of every occasion inside the capture
+  std::vector<uint64_t> occasion_samples;
+  std::vector<double> occasion_times;
+
+  std::vector<std::unique_ptr<worker_t>> workers;
+};
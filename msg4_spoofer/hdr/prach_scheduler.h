@@ -0,0 +1,48 @@
+#pragma once
+
+#include "config.h"
+#include <cstdint>
+
+/*
+ * Finds the PRACH occasions of the configured config_idx and maps them to
+ * device time. TTIs are 1 ms subframes counted from the reference set with
+ * set_reference(); only the SFN/subframe (TTI mod 10240) is used to look up
+ * the occasion tables in prach.c.
+ */
+class prach_scheduler {
+public:
+  prach_scheduler(const spoofer_config_t &config);
+
+  // Switch to the occasions of another PRACH configuration, the reference
+  // is kept
+  void set_config_idx(uint32_t config_idx);
+
+  // Anchor TTI `tti` to the device time `time_s` (in seconds)
+  void set_reference(uint64_t tti, double time_s);
+
+  // Re-anchor on a cell TTI (SFN * 10 + subframe) starting at `time_s`, the
+  // TTI is unwrapped onto the count closest to the current mapping so that
+  // TTIs already handed out remain valid
+  void track_reference(uint32_t tti, double time_s);
+
+  // First TTI at or after `tti` carrying a PRACH occasion
+  spoofer_error_e next_occasion(uint64_t tti, uint64_t &occasion_tti) const;
+
+  // Device time of the first PRACH symbol of the occasion in `tti`
+  double occasion_time(uint64_t tti) const;
+
+  // First TTI starting at or after device time `time_s`
+  uint64_t tti_at(double time_s) const;
+
+private:
+  static const uint32_t NOF_TTI = 1024 * SRSRAN_NOF_SF_X_FRAME;
+
+  bool is_occasion(uint64_t tti) const;
+
+  uint32_t config_idx;
+  srsran_duplex_mode_t duplex_mode;
+  double start_offset_s;
+
+  uint64_t ref_tti = 0;
+  double ref_time_s = 0.0;
+};
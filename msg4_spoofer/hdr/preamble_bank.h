@@ -0,0 +1,48 @@
+#pragma once
+
+#include "config.h"
+#include "rf_base.h"
+#include <srsran/phy/phch/prach.h>
+
+/*
+ * All num_ra_preambles waveforms rendered once at start up into a single
+ * aligned arena, in the sample format the RF device takes without
+ * conversion. Bursts handed out point into the arena, so the transmit loop
+ * neither allocates nor copies. The arena can also be a read-only mapping
+ * of a waveform cache file.
+ */
+class preamble_bank {
+public:
+  preamble_bank(srsran_prach_t &prach, const spoofer_config_t &config,
+                tx_format_t format);
+  // Take over `mapping_size` bytes mapped with mmap, the arena starts at
+  // `arena_offset` and is unmapped on destruction
+  preamble_bank(void *mapping, size_t mapping_size, size_t arena_offset,
+                tx_format_t format, uint32_t nof_preambles, uint32_t len);
+  ~preamble_bank();
+
+  preamble_bank(const preamble_bank &) = delete;
+  preamble_bank &operator=(const preamble_bank &) = delete;
+
+  // Samples of preamble `idx`, shared by every channel transmitting it
+  const void *data(uint32_t idx) const;
+  // Untimed single channel burst pointing at preamble `idx`
+  tx_burst_t burst(uint32_t idx) const;
+
+  uint32_t size() const { return nof_preambles; }
+  uint32_t preamble_len() const { return len; }
+  tx_format_t get_format() const { return format; }
+
+  // Raw arena, stride aligned preambles one after another
+  const void *arena_data() const { return arena; }
+  size_t arena_size() const;
+
+private:
+  tx_format_t format;
+  uint32_t nof_preambles = 0;
+  uint32_t len = 0;
+  uint32_t stride = 0; // in samples, keeps every preamble SIMD aligned
+  void *arena = nullptr;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+};
@@ -11,6 +11,7 @@ class rf_handler {
 public:
   uhd::usrp::multi_usrp::sptr usrp = nullptr;
   uhd::stream_args_t stream_args = {};
+  std::string tx_cpu_format = "fc32";
   float lo_freq_tx_hz = 0.0;
   float lo_freq_rx_hz = 0.0;
   float lo_freq_offset_hz = 0.0;
@@ -53,6 +54,11 @@ public:
     usrp->set_time_unknown_pps(timespec);
     return UHD_ERROR_NONE;
   }
+  uhd_error set_time_now(const uhd::time_spec_t &timespec) {
+    std::cout << "Setting Time now..." << "\n";
+    usrp->set_time_now(timespec);
+    return UHD_ERROR_NONE;
+  }
   uhd_error get_time_now(uhd::time_spec_t &timespec) {
     timespec = usrp->get_time_now();
     return UHD_ERROR_NONE;
@@ -95,10 +101,17 @@ public:
     usrp->set_command_time(timespec);
     return UHD_ERROR_NONE;
   }
+  uhd_error clear_command_time() {
+    usrp->clear_command_time();
+    return UHD_ERROR_NONE;
+  }
   uhd_error get_rx_stream(size_t &max_num_samps) {
     std::cout << "Creating Rx stream" << "\n";
     rx_stream = nullptr;
-    rx_stream = usrp->get_rx_stream(stream_args);
+    // Only the first channel listens to the downlink
+    uhd::stream_args_t rx_stream_args = stream_args;
+    rx_stream_args.channels.resize(1);
+    rx_stream = usrp->get_rx_stream(rx_stream_args);
     max_num_samps = rx_stream->get_max_num_samps();
     if (max_num_samps == 0UL) {
       std::cerr << "The maximum number of receive samples is zero." << "\n";
@@ -109,7 +122,9 @@ public:
   uhd_error get_tx_stream(size_t &max_num_samps) {
     std::cout << "Creating Tx stream" << "\n";
     tx_stream = nullptr;
-    tx_stream = usrp->get_tx_stream(stream_args);
+    uhd::stream_args_t tx_stream_args = stream_args;
+    tx_stream_args.cpu_format = tx_cpu_format;
+    tx_stream = usrp->get_tx_stream(tx_stream_args);
     max_num_samps = tx_stream->get_max_num_samps();
     if (max_num_samps == 0UL) {
       std::cerr << "The maximum number of transmit samples is zero."
@@ -203,6 +218,12 @@ public:
     return UHD_ERROR_NONE;
   }
 
+  uhd_error recv_async_msg(uhd::async_metadata_t &metadata, float timeout,
+                           bool &valid) {
+    valid = tx_stream->recv_async_msg(metadata, timeout);
+    return UHD_ERROR_NONE;
+  }
+
   uhd_error start_rx_stream(float delay) {
     std::cout << "Starting Rx stream\n";
     uhd::time_spec_t time_spec;
@@ -1,14 +1,76 @@
 #pragma once
 
 #include "config.h"
+#include <complex>
 #include <memory>
+#include <vector>
+
+// Full scale used when converting fc32 samples to sc16
+#define TX_SC16_SCALE 32767.0f
+
+typedef enum tx_format_e { TX_FORMAT_FC32 = 0, TX_FORMAT_SC16 } tx_format_t;
+
+/*
+ * Non-owning view of a burst, samples are interleaved I/Q in `format`. A
+ * standalone burst sets both start_of_burst and end_of_burst, a continuous
+ * stream sets start_of_burst on its first segment and end_of_burst on its
+ * last one only. Multi-channel bursts carry one buffer per TX channel, all
+ * of them nof_samples long and sent with the same time spec.
+ */
+typedef struct tx_burst_s {
+  const void *data[RF_MAX_CHANNELS];
+  uint32_t nof_channels;
+  size_t nof_samples;
+  tx_format_t format;
+  bool has_time_spec; // Transmit at `time` instead of as soon as possible
+  double time;        // Device time in seconds
+  bool start_of_burst;
+  bool end_of_burst;
+} tx_burst_t;
+
+#define TX_LATENCY_HIST_BINS 16
+
+/* TX events reported asynchronously by the RF device */
+typedef struct tx_metrics_s {
+  uint64_t nof_burst_ack;
+  uint64_t nof_underflow;
+  uint64_t nof_time_error;
+  uint64_t nof_seq_error;
+  // Device time in seconds of the last event of each kind
+  double last_underflow_time;
+  double last_time_error_time;
+  double last_seq_error_time;
+  // Acknowledged minus scheduled end of burst time, bin i counts latencies in
+  // [2^i, 2^(i+1)) microseconds, bin 0 also takes anything below 1 us
+  uint64_t latency_hist[TX_LATENCY_HIST_BINS];
+} tx_metrics_t;
 
 class RFBase {
 public:
   virtual ~RFBase() = default;
-  virtual spoofer_error_e
-  transmit(const spoofer_config_t &args,
-           const std::vector<std::complex<float>> &tx_data) = 0;
+  // Hand a burst to the device without copying it
+  virtual spoofer_error_e transmit(const spoofer_config_t &args,
+                                   const tx_burst_t &burst) = 0;
+  // Number of TX channels every burst must carry
+  virtual uint32_t get_nof_tx_channels() const { return 1; }
+  // Sample format the device takes without conversion
+  virtual tx_format_t get_tx_format() const { return TX_FORMAT_FC32; }
+  // Current device time in seconds
+  virtual double get_time_now() = 0;
+  // Asynchronous TX event counters, false if the device does not report them
+  virtual bool get_tx_metrics(tx_metrics_t &metrics) { return false; }
+  // Receive nof_samples into data, timestamp is the device time of the first
+  // sample
+  virtual spoofer_error_e receive(cf_t *data, uint32_t nof_samples,
+                                  double &timestamp) = 0;
+
+  spoofer_error_e transmit(const spoofer_config_t &args,
+                           const std::vector<std::complex<float>> &tx_data);
+  // Transmit tx_data so that it leaves the device at tx_time (in seconds of
+  // device time)
+  spoofer_error_e transmit(const spoofer_config_t &args,
+                           const std::vector<std::complex<float>> &tx_data,
+                           double tx_time);
 };
 
 // Factory function declaration
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "rf_base.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+// Bytes of the capture mapped at a time, a multiple of the page size
+#define RF_FILE_WINDOW_SIZE (64UL << 20)
+
+/*
+ * Capture backend writing the TX timeline into rf.file_path, as raw .fc32 or
+ * .sc16 samples depending on the file extension. Timed bursts land at their
+ * sample offset and the gaps between them are left as holes of the sparse
+ * file, so padding costs nothing. Samples are copied into a sliding
+ * memory-mapped window. Device time is the host clock since the file was
+ * opened.
+ *
+ * With rf.file_index the start offset, length and time of every timed burst
+ * is also written, one line each, to rf.file_path + ".idx".
+ */
+class RF_File : public RFBase {
+public:
+  RF_File(const spoofer_config_t &config);
+  spoofer_error_e transmit(const spoofer_config_t &args,
+                           const tx_burst_t &burst) override;
+  tx_format_t get_tx_format() const override { return format; }
+  double get_time_now() override;
+  bool get_tx_metrics(tx_metrics_t &metrics_) override;
+  spoofer_error_e receive(cf_t *data, uint32_t nof_samples,
+                          double &timestamp) override;
+  ~RF_File() override;
+
+  RF_File(const RF_File &) = delete;
+  RF_File &operator=(const RF_File &) = delete;
+
+private:
+  spoofer_error_e write(const void *data, uint64_t offset, size_t nof_bytes);
+  spoofer_error_e map_window(uint64_t offset);
+
+  std::string path;
+  int fd = -1;
+  FILE *index = nullptr;
+  tx_format_t format = TX_FORMAT_FC32;
+  size_t sample_sz = 0;
+  double srate = 0.0;
+
+  uint64_t cursor = 0; // in samples, end of the last burst
+  uint8_t *window = nullptr;
+  uint64_t window_offset = 0; // in bytes
+  uint64_t file_size = 0;     // in bytes
+
+  // Written bursts are reported as acknowledged, late ones as time errors.
+  // Updated by the TX thread and read by the metrics report.
+  std::mutex metrics_mutex;
+  tx_metrics_t metrics = {};
+  std::chrono::steady_clock::time_point host_ref;
+  log_limiter overlap_limiter{LOG_LIMIT_PERIOD};
+};
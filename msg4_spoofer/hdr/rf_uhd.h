@@ -1,17 +1,33 @@
 #include "rf.h"
 #include "rf_base.h"
+#include "uhd_tx_monitor.h"
 #include <uhd/stream.hpp>
 #include <uhd/usrp/multi_usrp.hpp>
 
+// Margin in seconds for the timed retune of a multi-channel device
+#define TUNE_COMMAND_DELAY 0.1
+
 class RF_UHD : public RFBase {
 public:
   RF_UHD(const spoofer_config_t &config);
-  spoofer_error_e
-  transmit(const spoofer_config_t &args,
-           const std::vector<std::complex<float>> &tx_data) override;
+  spoofer_error_e transmit(const spoofer_config_t &args,
+                           const tx_burst_t &burst) override;
+  uint32_t get_nof_tx_channels() const override { return nof_channels; }
+  tx_format_t get_tx_format() const override { return tx_format; }
+  double get_time_now() override;
+  bool get_tx_metrics(tx_metrics_t &metrics) override;
+  spoofer_error_e receive(cf_t *data, uint32_t nof_samples,
+                          double &timestamp) override;
   ~RF_UHD() override = default;
 
 private:
   void handle_uhd_error(uhd_error err);
   rf_handler rf_dev;
+  uhd_tx_monitor tx_monitor{rf_dev};
+  double srate = 0.0;
+  uint32_t nof_channels = 1;
+  bool rx_streaming = false;
+  tx_format_t tx_format = TX_FORMAT_FC32;
+  std::vector<int16_t> conversion_buffer;
+  log_limiter overflow_limiter{LOG_LIMIT_PERIOD};
 };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "rf_base.h"
+#include <chrono>
+#include <srsran/phy/rf/rf.h>
+#include <string>
+#include <vector>
+
+/*
+ * ZeroMQ backend on top of the srsRAN zmq RF plugin, for running the TX
+ * pipeline against a local sink without a radio. The plugin keeps its own
+ * sample timeline and pads the gaps before timed bursts with zeros, device
+ * time is the host clock since the device was opened. When rate_limit is set
+ * the samples handed to the sink, padding included, are throttled to that
+ * many samples per second.
+ */
+class RF_ZMQ : public RFBase {
+public:
+  RF_ZMQ(const spoofer_config_t &config);
+  spoofer_error_e transmit(const spoofer_config_t &args,
+                           const tx_burst_t &burst) override;
+  uint32_t get_nof_tx_channels() const override { return nof_channels; }
+  double get_time_now() override;
+  spoofer_error_e receive(cf_t *data, uint32_t nof_samples,
+                          double &timestamp) override;
+  ~RF_ZMQ() override;
+
+private:
+  void throttle(uint64_t nof_pushed);
+
+  srsran_rf_t rf_dev = {};
+  std::string device_args;
+  double srate = 0.0;
+  double rate_limit = 0.0; // in samples per second, 0 disables throttling
+  uint32_t nof_channels = 1;
+  bool rx_streaming = false;
+
+  // Per-channel copies of the burst being sent and their linear TX gain
+  std::vector<cf_t> scratch[SRSRAN_MAX_CHANNELS];
+  float tx_scale[SRSRAN_MAX_CHANNELS] = {};
+
+  // Samples handed to the plugin since it was opened, padding included
+  uint64_t tx_cursor = 0;
+  std::chrono::steady_clock::time_point host_ref;
+};
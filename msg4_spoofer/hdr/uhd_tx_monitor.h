@@ -0,0 +1,78 @@
+#pragma once
+
+#include "rf.h"
+#include "rf_base.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// Maximum number of bursts waiting for their acknowledgement
+#define TX_MONITOR_MAX_PENDING 1024
+// Acknowledgements may be time stamped this much before the computed burst
+// end, which accumulates rounding of the sample count to device ticks
+#define TX_MONITOR_ACK_TOLERANCE 1e-6
+// Error events reported by different channels this close in time are the
+// same event on a multi-channel streamer
+#define TX_MONITOR_EVENT_WINDOW 100e-6
+
+/*
+ * Background reader of the UHD TX async message queue. Counts underflow,
+ * time and sequence errors and burst acknowledgements, and matches the
+ * latter against the scheduled end of each timed burst on the channel that
+ * reported them. UHD reports every event once per channel, a burst counts as
+ * acknowledged once all its channels have acknowledged it and an error seen
+ * on several channels is counted once. Acknowledgements of bursts never
+ * registered, e.g. the end of a continuous stream, are ignored.
+ */
+class uhd_tx_monitor {
+public:
+  uhd_tx_monitor(rf_handler &rf_dev);
+  ~uhd_tx_monitor();
+
+  // `time_ref` is the device time at the moment of the call
+  void start(double time_ref);
+  void stop();
+
+  // Register a timed burst sent on `nof_channels` channels and ending at
+  // device time `end_time`
+  void burst_scheduled(double end_time, uint32_t nof_channels);
+
+  tx_metrics_t get_metrics();
+
+private:
+  void run_thread();
+  double device_time_now() const;
+  void add_latency(double latency_s);
+  bool ack_burst(size_t channel, double ack_time, double &end_time);
+
+  // A timed burst still waiting for the acknowledgement of some channels
+  struct pending_burst_t {
+    double end_time;
+    uint32_t all_channels; // bit mask of the channels it was sent on
+    uint32_t acked;        // bit mask of the channels that acknowledged it
+  };
+
+  // Last occurrence of an error event and the channels that reported it
+  struct channel_event_t {
+    double time = 0.0;
+    uint32_t channels = 0;
+  };
+  bool is_new_event(channel_event_t &event, size_t channel, double time);
+
+  rf_handler &rf_dev;
+
+  double time_ref = 0.0;
+  std::chrono::steady_clock::time_point host_ref;
+
+  std::mutex metrics_mutex;
+  tx_metrics_t metrics = {};
+  std::deque<pending_burst_t> pending;
+  channel_event_t underflow_event;
+  channel_event_t time_error_event;
+  channel_event_t seq_error_event;
+
+  std::atomic<bool> running{false};
+  std::thread monitor_thread;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "config.h"
+#include "preamble_bank.h"
+#include <memory>
+#include <string>
+
+// Bytes reserved for the header of a cache file, keeps the arena page aligned
+#define WAVEFORM_CACHE_HEADER_SIZE 4096
+#define WAVEFORM_CACHE_VERSION 1
+
+/* Everything the rendered preambles depend on */
+typedef struct waveform_key_s {
+  uint32_t config_idx;
+  uint32_t root_seq_idx;
+  uint32_t zero_corr_zone;
+  uint32_t num_ra_preambles;
+  uint32_t N_ifft;
+  uint32_t freq_offset;
+  uint32_t is_nr;
+  uint32_t hs_flag;
+  uint32_t format;
+} waveform_key_t;
+
+/*
+ * Content addressed on-disk store of preamble banks. Each configuration is
+ * kept in <dir>/<hash of its key>.prach, a header followed by the bank arena
+ * exactly as held in memory, so a hit only maps the file. Files are written
+ * to a temporary name and renamed into place, several processes can share a
+ * directory. Without a directory every bank is generated.
+ */
+class waveform_cache {
+public:
+  waveform_cache(const std::string &dir);
+
+  // Preambles of `config` in `format`, mapped from the cache on a hit or
+  // generated with `prach` and stored on a miss
+  std::unique_ptr<preamble_bank> get(srsran_prach_t &prach,
+                                     const spoofer_config_t &config,
+                                     tx_format_t format);
+
+  uint64_t get_nof_hits() const { return nof_hits; }
+  uint64_t get_nof_misses() const { return nof_misses; }
+
+private:
+  std::string path_of(const waveform_key_t &key) const;
+  std::unique_ptr<preamble_bank> load(const waveform_key_t &key,
+                                      const std::string &path);
+  void store(const waveform_key_t &key, const preamble_bank &bank,
+             const std::string &path);
+
+  std::string dir;
+  uint64_t nof_hits = 0;
+  uint64_t nof_misses = 0;
+};
@@ -0,0 +1,196 @@
+#include "cell_scan.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <srsran/common/band_helper.h>
+#include <srsran/phy/utils/vector.h>
+#include <stdexcept>
+#include <thread>
+
+cell_scan::cell_scan(const spoofer_config_t &config_) : config(config_) {
+  try {
+    init();
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+cell_scan::~cell_scan() { release(); }
+
+void cell_scan::release() {
+  for (std::unique_ptr<worker_t> &w : workers) {
+    if (w->ssb_initialized) {
+      srsran_ssb_free(&w->ssb);
+    }
+    if (w->resampler_initialized) {
+      srsran_resampler_fft_free(&w->resampler);
+    }
+    free(w->mixed);
+    free(w->subband);
+  }
+  workers.clear();
+  free(capture);
+  capture = nullptr;
+}
+
+void cell_scan::init() {
+  double srate = config.rf.srate;
+  double subband_srate = config.cell_scan.subband_srate;
+  double ratio_f = srate / subband_srate;
+  ratio = (uint32_t)std::round(ratio_f);
+  if (ratio == 0 || std::fabs(ratio_f - ratio) > 1e-6) {
+    throw std::runtime_error("rf.srate is not a multiple of the sub-band rate");
+  }
+
+  srsran::srsran_band_helper bands;
+  uint16_t band = config.cell_scan.band;
+  if (band == 0) {
+    band = bands.get_band_from_dl_freq_Hz(config.rf.rx_frequency);
+  }
+  srsran::srsran_band_helper::sync_raster_t raster =
+      bands.get_sync_raster(band, config.ssb.ssb_scs);
+  if (!raster.valid()) {
+    throw std::runtime_error("No SSB raster for band " + std::to_string(band));
+  }
+  pattern = srsran::srsran_band_helper::get_ssb_pattern(band,
+                                                        config.ssb.ssb_scs);
+  duplex_mode = bands.get_duplex_mode(band);
+
+  // Raster points whose whole sub-band is inside the capture
+  double max_offset = (srate - subband_srate) / 2.0;
+  for (; !raster.end(); raster.next()) {
+    double frequency = raster.get_frequency();
+    if (std::fabs(frequency - config.rf.rx_frequency) <= max_offset) {
+      candidates.push_back(frequency);
+    }
+  }
+  if (candidates.empty()) {
+    throw std::runtime_error("No SSB raster point inside the capture");
+  }
+
+  nof_samples = (uint32_t)std::round(config.cell_scan.duration * srate);
+  nof_samples -= nof_samples % ratio;
+  capture = srsran_vec_cf_malloc(nof_samples);
+  if (capture == nullptr) {
+    throw std::runtime_error("Failed to allocate the capture");
+  }
+
+  uint32_t nof_threads = config.cell_scan.threads;
+  if (nof_threads == 0) {
+    nof_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  nof_threads = std::min<uint32_t>(nof_threads, candidates.size());
+
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.max_srate_hz = subband_srate;
+  ssb_args.min_scs = config.ssb.ssb_scs;
+  ssb_args.enable_search = true;
+  ssb_args.enable_decode = true;
+  ssb_args.pss_prune_thr = config.ssb.pss_prune_thr;
+
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    workers.push_back(std::make_unique<worker_t>());
+    worker_t &w = *workers.back();
+
+    w.mixed = srsran_vec_cf_malloc(nof_samples);
+    w.subband = srsran_vec_cf_malloc(nof_samples / ratio);
+    if (w.mixed == nullptr || w.subband == nullptr) {
+      throw std::runtime_error("Failed to allocate sub-band buffers");
+    }
+    if (srsran_resampler_fft_init(&w.resampler, SRSRAN_RESAMPLER_MODE_DECIMATE,
+                                  ratio) < SRSRAN_SUCCESS) {
+      throw std::runtime_error("Failed to initialize resampler");
+    }
+    w.resampler_initialized = true;
+    if (srsran_ssb_init(&w.ssb, &ssb_args) < SRSRAN_SUCCESS) {
+      throw std::runtime_error("Failed to initialize SSB");
+    }
+    w.ssb_initialized = true;
+  }
+
+  LOG_INFO("Cell scan: band n%u, %zu raster points within %.2f MHz of "
+           "%.2f MHz, %u threads",
+           band, candidates.size(), max_offset / 1e6,
+           config.rf.rx_frequency / 1e6, nof_threads);
+}
+
+void cell_scan::work(uint32_t id) {
+  worker_t &w = *workers[id];
+  uint32_t subband_len = nof_samples / ratio;
+
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz = config.cell_scan.subband_srate;
+  ssb_cfg.scs = config.ssb.ssb_scs;
+  ssb_cfg.pattern = pattern;
+  ssb_cfg.duplex_mode = duplex_mode;
+  ssb_cfg.periodicity_ms = config.ssb.periodicity_ms;
+
+  for (size_t i = next_candidate++; i < candidates.size();
+       i = next_candidate++) {
+    double frequency = candidates[i];
+
+    // Bring the raster point to DC and keep only its sub-band
+    float cfo = (float)(-(frequency - config.rf.rx_frequency) /
+                        config.rf.srate);
+    srsran_vec_apply_cfo(capture, cfo, w.mixed, nof_samples);
+    srsran_resampler_fft_reset_state(&w.resampler);
+    srsran_resampler_fft_run(&w.resampler, w.mixed, w.subband, nof_samples);
+
+    ssb_cfg.center_freq_hz = frequency;
+    ssb_cfg.ssb_freq_hz = frequency;
+    if (srsran_ssb_set_cfg(&w.ssb, &ssb_cfg) < SRSRAN_SUCCESS) {
+      LOG_ERROR("Cell scan: failed to configure SSB at %.3f MHz",
+                frequency / 1e6);
+      continue;
+    }
+
+    srsran_ssb_search_res_t res = {};
+    if (srsran_ssb_search(&w.ssb, w.subband, subband_len, &res) <
+        SRSRAN_SUCCESS) {
+      LOG_ERROR("Cell scan: search failed at %.3f MHz", frequency / 1e6);
+      continue;
+    }
+    if (!res.pbch_msg.crc) {
+      continue;
+    }
+
+    LOG_DEBUG("Cell scan: N_id=%u at %.3f MHz", res.N_id, frequency / 1e6);
+    std::lock_guard<std::mutex> lock(results_mutex);
+    found.push_back({frequency, res.N_id, res.measurements.rsrp_dB,
+                     res.measurements.snr_dB});
+  }
+}
+
+spoofer_error_e cell_scan::run(RFBase &rf,
+                               std::vector<cell_scan_result_t> &results) {
+  double timestamp = 0.0;
+  if (rf.receive(capture, nof_samples, timestamp) != SUCCESS) {
+    LOG_ERROR("Cell scan: capture failed");
+    return SAMPLE_ERROR;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  found.clear();
+  next_candidate = 0;
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < workers.size(); i++) {
+    threads.emplace_back(&cell_scan::work, this, i);
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  std::sort(found.begin(), found.end(),
+            [](const cell_scan_result_t &a, const cell_scan_result_t &b) {
+              return a.rsrp_dB > b.rsrp_dB;
+            });
+  results = found;
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LOG_INFO("Cell scan: %zu cells on %zu raster points, took %.1f ms",
+           results.size(), candidates.size(), elapsed.count() * 1e3);
+  return SUCCESS;
+}
@@ -0,0 +1,186 @@
+#include "continuous_tx.h"
+#include <cmath>
+#include <cstring>
+#include <srsran/phy/utils/vector.h>
+#include <stdexcept>
+
+continuous_tx::continuous_tx(const spoofer_config_t &config_, RFBase &rf_)
+    : config(config_), rf(rf_), clock(rf_) {
+  srate = config.rf.srate;
+  lead_time = config.prach.lead_time;
+  chunk_len = (uint32_t)std::round(srate / 1000.0);
+  format = rf.get_tx_format();
+  nof_channels = rf.get_nof_tx_channels();
+
+  uint32_t sample_sz = format == TX_FORMAT_SC16 ? 2 * sizeof(int16_t)
+                                                : sizeof(cf_t);
+  zeros = srsran_vec_malloc(chunk_len * sample_sz);
+  if (zeros == nullptr) {
+    throw std::runtime_error("Failed to allocate zero padding buffer");
+  }
+  memset(zeros, 0, chunk_len * sample_sz);
+  for (uint32_t ch = 0; ch < RF_MAX_CHANNELS; ch++) {
+    zero_buffs[ch] = zeros;
+  }
+}
+
+continuous_tx::~continuous_tx() {
+  stop();
+  free(zeros);
+}
+
+spoofer_error_e continuous_tx::start(double start_time_) {
+  if (tx_thread.joinable()) {
+    return SUCCESS;
+  }
+
+  start_time = start_time_;
+  cursor = 0;
+  first_segment = true;
+  clock.sync();
+
+  running = true;
+  tx_thread = std::thread(&continuous_tx::run_thread, this);
+  return SUCCESS;
+}
+
+void continuous_tx::stop() {
+  running = false;
+  queue_cvar.notify_all();
+  if (!tx_thread.joinable()) {
+    return;
+  }
+  tx_thread.join();
+  LOG_INFO("Continuous TX stopped: %lu bursts sent, %lu late",
+           (unsigned long)nof_sent, (unsigned long)nof_late);
+}
+
+spoofer_error_e continuous_tx::schedule(const tx_burst_t &burst,
+                                        std::shared_ptr<const void> owner) {
+  if (!burst.has_time_spec) {
+    LOG_ERROR("Continuous TX only takes timed bursts");
+    return CONFIG_ERROR;
+  }
+  if (burst.nof_channels != nof_channels) {
+    LOG_ERROR("Continuous TX: burst has %u channels, stream has %u",
+              burst.nof_channels, nof_channels);
+    return CONFIG_ERROR;
+  }
+
+  std::unique_lock<std::mutex> lock(queue_mutex);
+  queue_cvar.wait(lock, [this] {
+    return queue.size() < CONTINUOUS_TX_QUEUE_SIZE || !running;
+  });
+  if (!running) {
+    return SAMPLE_ERROR;
+  }
+  queue.push_back({burst, std::move(owner)});
+  queue_cvar.notify_all();
+  return SUCCESS;
+}
+
+spoofer_error_e continuous_tx::send(const void *const *data,
+                                    size_t nof_samples, tx_format_t fmt) {
+  tx_burst_t segment = {};
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    segment.data[ch] = data[ch];
+  }
+  segment.nof_channels = nof_channels;
+  segment.nof_samples = nof_samples;
+  segment.format = fmt;
+  segment.has_time_spec = first_segment;
+  segment.time = start_time;
+  segment.start_of_burst = first_segment;
+  segment.end_of_burst = false;
+  first_segment = false;
+
+  spoofer_error_e ret = rf.transmit(config, segment);
+  if (ret == SUCCESS) {
+    cursor += nof_samples;
+  }
+  return ret;
+}
+
+spoofer_error_e continuous_tx::send_zeros(uint64_t nof_samples) {
+  while (nof_samples > 0) {
+    uint64_t n = std::min<uint64_t>(nof_samples, chunk_len);
+    spoofer_error_e ret = send(zero_buffs, n, format);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+    nof_samples -= n;
+  }
+  return SUCCESS;
+}
+
+void continuous_tx::run_thread() {
+  while (running) {
+    clock.track();
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+    if (!queue.empty()) {
+      tx_burst_t burst = queue.front().burst;
+      int64_t offset = std::llround((burst.time - start_time) * srate);
+
+      // The stream has already gone past the burst start
+      if (offset < (int64_t)cursor) {
+        queue.pop_front();
+        queue_cvar.notify_all();
+        lock.unlock();
+
+        nof_late++;
+        LOG_WARN_LIMITED(late_limiter,
+                         "Continuous TX: burst at %.6f s is late by %.1f us",
+                         burst.time, (cursor - offset) / srate * 1e6);
+        continue;
+      }
+
+      // Splice the burst in once it falls within the next chunk
+      uint64_t gap = (uint64_t)offset - cursor;
+      if (gap <= chunk_len) {
+        std::shared_ptr<const void> owner = std::move(queue.front().owner);
+        queue.pop_front();
+        queue_cvar.notify_all();
+        lock.unlock();
+
+        if (send_zeros(gap) != SUCCESS ||
+            send(burst.data, burst.nof_samples, burst.format) != SUCCESS) {
+          LOG_ERROR("Continuous TX: error sending burst");
+          break;
+        }
+        nof_sent++;
+        continue;
+      }
+    }
+
+    // Nothing due in the next chunk, wait until the device clock is within
+    // lead_time of the cursor unless a new burst shows up
+    double cursor_time = start_time + cursor / srate;
+    queue_cvar.wait_until(lock, clock.host_time(cursor_time - lead_time));
+    lock.unlock();
+
+    cursor_time = start_time + cursor / srate;
+    if (cursor_time - lead_time > clock.now()) {
+      continue;
+    }
+
+    if (send_zeros(chunk_len) != SUCCESS) {
+      LOG_ERROR("Continuous TX: error sending padding");
+      break;
+    }
+  }
+
+  // Close the burst
+  tx_burst_t eob = {};
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    eob.data[ch] = zeros;
+  }
+  eob.nof_channels = nof_channels;
+  eob.nof_samples = 0;
+  eob.format = format;
+  eob.end_of_burst = true;
+  rf.transmit(config, eob);
+
+  running = false;
+  queue_cvar.notify_all();
+}
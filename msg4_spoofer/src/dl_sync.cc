@@ -0,0 +1,130 @@
+#include "dl_sync.h"
+#include <chrono>
+#include <cmath>
+#include <srsran/phy/utils/vector.h>
+
+dl_sync::dl_sync(const spoofer_config_t &config, RFBase &rf_) : rf(rf_) {
+  srate = config.rf.srate;
+  sf_len = (uint32_t)std::round(srate / 1000.0);
+
+  srsran_ue_sync_nr_args_t ue_sync_args = {};
+  ue_sync_args.max_srate_hz = srate;
+  ue_sync_args.min_scs = config.ssb.ssb_scs;
+  ue_sync_args.nof_rx_channels = 1;
+  ue_sync_args.pss_prune_thr = config.ssb.pss_prune_thr;
+  ue_sync_args.recv_obj = this;
+  ue_sync_args.recv_callback = &dl_sync::recv_callback;
+  if (srsran_ue_sync_nr_init(&ue_sync, &ue_sync_args) < SRSRAN_SUCCESS) {
+    throw std::runtime_error("Failed to initialize UE sync");
+  }
+
+  srsran_ue_sync_nr_cfg_t ue_sync_cfg = {};
+  ue_sync_cfg.ssb.srate_hz = srate;
+  ue_sync_cfg.ssb.center_freq_hz = config.rf.rx_frequency;
+  ue_sync_cfg.ssb.ssb_freq_hz = config.ssb.ssb_frequency;
+  ue_sync_cfg.ssb.scs = config.ssb.ssb_scs;
+  ue_sync_cfg.ssb.pattern = config.ssb.ssb_pattern;
+  ue_sync_cfg.ssb.duplex_mode = config.ssb.duplex_mode;
+  ue_sync_cfg.ssb.periodicity_ms = config.ssb.periodicity_ms;
+  ue_sync_cfg.N_id = config.rf.N_id;
+  if (srsran_ue_sync_nr_set_cfg(&ue_sync, &ue_sync_cfg) < SRSRAN_SUCCESS) {
+    srsran_ue_sync_nr_free(&ue_sync);
+    throw std::runtime_error("Failed to configure UE sync");
+  }
+
+  sf_buffer = srsran_vec_cf_malloc(sf_len);
+  if (sf_buffer == nullptr) {
+    srsran_ue_sync_nr_free(&ue_sync);
+    throw std::runtime_error("Failed to allocate subframe buffer");
+  }
+}
+
+dl_sync::~dl_sync() {
+  stop();
+  srsran_ue_sync_nr_free(&ue_sync);
+  free(sf_buffer);
+}
+
+int dl_sync::recv_callback(void *ptr, cf_t **buffer, uint32_t nof_samples,
+                           srsran_timestamp_t *timestamp) {
+  dl_sync *q = (dl_sync *)ptr;
+  double rx_time = 0.0;
+
+  if (q->rf.receive(buffer[0], nof_samples, rx_time) != SUCCESS) {
+    return SRSRAN_ERROR;
+  }
+
+  double full_secs = std::floor(rx_time);
+  srsran_timestamp_init(timestamp, (time_t)full_secs, rx_time - full_secs);
+  return SRSRAN_SUCCESS;
+}
+
+spoofer_error_e dl_sync::start() {
+  if (running) {
+    return SUCCESS;
+  }
+  running = true;
+  rx_thread = std::thread(&dl_sync::run_thread, this);
+  return SUCCESS;
+}
+
+void dl_sync::stop() {
+  running = false;
+  if (rx_thread.joinable()) {
+    rx_thread.join();
+  }
+}
+
+void dl_sync::run_thread() {
+  bool was_in_sync = false;
+
+  while (running) {
+    srsran_ue_sync_nr_outcome_t outcome = {};
+    if (srsran_ue_sync_nr_zerocopy(&ue_sync, &sf_buffer, &outcome) <
+        SRSRAN_SUCCESS) {
+      LOG_ERROR("Error receiving downlink subframe");
+      break;
+    }
+
+    if (outcome.in_sync != was_in_sync) {
+      if (outcome.in_sync) {
+        LOG_INFO("Cell in sync: sfn=%u cfo=%+.1f Hz", outcome.sfn,
+                 outcome.cfo_hz);
+      } else {
+        LOG_WARN("Cell sync lost");
+      }
+      was_in_sync = outcome.in_sync;
+    }
+
+    // The buffer holds the subframe preceding outcome.sfn/sf_idx, the latter
+    // starts right after it
+    std::lock_guard<std::mutex> lock(timing_mutex);
+    timing.in_sync = outcome.in_sync;
+    timing.tti = outcome.sfn * SRSRAN_NOF_SF_X_FRAME + outcome.sf_idx;
+    timing.time = srsran_timestamp_real(&outcome.timestamp) + sf_len / srate;
+    timing.cfo_hz = outcome.cfo_hz;
+    timing.delay_us = outcome.delay_us;
+  }
+
+  std::lock_guard<std::mutex> lock(timing_mutex);
+  timing.in_sync = false;
+}
+
+dl_timing_t dl_sync::get_timing() {
+  std::lock_guard<std::mutex> lock(timing_mutex);
+  return timing;
+}
+
+bool dl_sync::wait_sync(double timeout_s) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<double>(timeout_s));
+
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (get_timing().in_sync) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return false;
+}
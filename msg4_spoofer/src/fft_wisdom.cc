@@ -0,0 +1,115 @@
+#include "fft_wisdom.h"
+#include <srsran/phy/dft/dft.h>
+#include <srsran/phy/sync/ssb.h>
+#include <srsran/phy/utils/vector.h>
+
+static spoofer_error_e precompute_prach(const spoofer_config_t &point) {
+  srsran_prach_t prach = {};
+  if (srsran_prach_init(&prach, srsran_symbol_sz(point.rf.nof_prb))) {
+    LOG_ERROR("Failed to initialize PRACH");
+    return INIT_ERROR;
+  }
+
+  spoofer_error_e ret = SUCCESS;
+  srsran_prach_cfg_t prach_cfg = get_prach_cfg(point);
+  if (srsran_prach_set_cfg(&prach, &prach_cfg, point.rf.nof_prb)) {
+    LOG_ERROR("Error configuring PRACH");
+    ret = CONFIG_ERROR;
+  } else {
+    uint32_t sizes[] = {prach.N_ifft_prach, prach.N_zc};
+    if (srsran_dft_precompute(sizes, 2, 1) < SRSRAN_SUCCESS ||
+        srsran_dft_precompute(&prach.N_ifft_prach, 1,
+                              SRSRAN_PRACH_GEN_BATCH_MAX) < SRSRAN_SUCCESS ||
+        srsran_dft_precompute(&prach.N_zc, 1,
+                              SRSRAN_PRACH_DETECT_BATCH_MAX) <
+            SRSRAN_SUCCESS) {
+      ret = INIT_ERROR;
+    }
+  }
+
+  srsran_prach_free(&prach);
+  return ret;
+}
+
+// Configures an SSB object as the receive path would and runs one search
+// over silence, which plans the correlation FFTs and the hypothesis batch
+static spoofer_error_e precompute_ssb(const spoofer_config_t &config,
+                                      double srate) {
+  srsran_ssb_args_t ssb_args = {};
+  ssb_args.max_srate_hz = srate;
+  ssb_args.min_scs = config.ssb.ssb_scs;
+  ssb_args.enable_search = true;
+  ssb_args.enable_decode = true;
+
+  srsran_ssb_t ssb = {};
+  if (srsran_ssb_init(&ssb, &ssb_args) < SRSRAN_SUCCESS) {
+    LOG_ERROR("Failed to initialize SSB");
+    return INIT_ERROR;
+  }
+
+  spoofer_error_e ret = SUCCESS;
+  srsran_ssb_cfg_t ssb_cfg = {};
+  ssb_cfg.srate_hz = srate;
+  ssb_cfg.center_freq_hz = config.rf.rx_frequency;
+  ssb_cfg.ssb_freq_hz = config.ssb.ssb_frequency;
+  ssb_cfg.scs = config.ssb.ssb_scs;
+  ssb_cfg.pattern = config.ssb.ssb_pattern;
+  ssb_cfg.duplex_mode = config.ssb.duplex_mode;
+  ssb_cfg.periodicity_ms = config.ssb.periodicity_ms;
+  cf_t *silence = nullptr;
+  if (srsran_ssb_set_cfg(&ssb, &ssb_cfg) < SRSRAN_SUCCESS) {
+    LOG_ERROR("Failed to configure SSB at %.2f Msps", srate / 1e6);
+    ret = CONFIG_ERROR;
+  } else if ((silence = srsran_vec_cf_malloc(ssb.sf_sz)) == nullptr) {
+    ret = INIT_ERROR;
+  } else {
+    srsran_vec_cf_zero(silence, ssb.sf_sz);
+    srsran_ssb_search_res_t res = {};
+    if (srsran_ssb_search(&ssb, silence, ssb.sf_sz, &res) < SRSRAN_SUCCESS) {
+      LOG_ERROR("SSB search failed at %.2f Msps", srate / 1e6);
+      ret = INIT_ERROR;
+    }
+  }
+
+  free(silence);
+  srsran_ssb_free(&ssb);
+  return ret;
+}
+
+spoofer_error_e
+precompute_fft_wisdom(const spoofer_config_t &config,
+                      const std::vector<spoofer_config_t> &points) {
+  for (const spoofer_config_t &point : points) {
+    spoofer_error_e ret = precompute_prach(point);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  if (config.ssb.enable_sync) {
+    spoofer_error_e ret = precompute_ssb(config, config.rf.srate);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  if (config.cell_scan.enable) {
+    spoofer_error_e ret =
+        precompute_ssb(config, config.cell_scan.subband_srate);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+
+  report_fft_planning();
+  if (srsran_dft_wisdom_export() < SRSRAN_SUCCESS) {
+    LOG_ERROR("Failed to store FFTW wisdom");
+    return FILE_ERROR;
+  }
+  return SUCCESS;
+}
+
+void report_fft_planning() {
+  uint32_t nof_plans = 0;
+  double time_s = 0.0;
+  srsran_dft_get_plan_stats(&nof_plans, &time_s);
+  LOG_INFO("FFT planning: %u plans took %.1f ms", nof_plans, time_s * 1e3);
+}
@@ -1,5 +1,59 @@
 #include "logging.h"
+#include <cstdlib>
 
 log_level_t log_level = DEBUG;
 
-void set_log_level(log_level_t level) { log_level = level; }
+static srslog::basic_levels to_srslog_level(log_level_t level) {
+  switch (level) {
+  case ERROR:
+    return srslog::basic_levels::error;
+  case WARNING:
+    return srslog::basic_levels::warning;
+  case INFO:
+    return srslog::basic_levels::info;
+  case DEBUG:
+  default:
+    return srslog::basic_levels::debug;
+  }
+}
+
+static srslog::basic_logger &create_logger() {
+  srslog::sink &err = srslog::fetch_stderr_sink();
+  srslog::sink &out = srslog::fetch_stdout_sink();
+
+  srslog::log_channel &error = srslog::fetch_log_channel(
+      "SPOOFER_E", err, srslog::log_channel_config{"SPOOFER", 'E', false});
+  srslog::log_channel &warning = srslog::fetch_log_channel(
+      "SPOOFER_W", err, srslog::log_channel_config{"SPOOFER", 'W', false});
+  srslog::log_channel &info = srslog::fetch_log_channel(
+      "SPOOFER_I", out, srslog::log_channel_config{"SPOOFER", 'I', false});
+  srslog::log_channel &debug = srslog::fetch_log_channel(
+      "SPOOFER_D", out, srslog::log_channel_config{"SPOOFER", 'D', false});
+
+  srslog::basic_logger &logger = srslog::fetch_logger<srslog::basic_logger>(
+      "SPOOFER", error, warning, info, debug);
+  logger.set_level(to_srslog_level(log_level));
+  return logger;
+}
+
+srslog::basic_logger &spoofer_logger() {
+  static srslog::basic_logger &logger = create_logger();
+  return logger;
+}
+
+void init_logging() {
+  // A full queue drops entries, the TX path never waits for the terminal
+  srslog::set_queue_overflow_policy(srslog::queue_overflow_policy::drop_newest);
+  spoofer_logger();
+  srslog::init();
+
+  // Every return from main goes through exit, write out what is queued
+  std::atexit([]() { srslog::flush(); });
+}
+
+void set_log_level(log_level_t level) {
+  log_level = level;
+  spoofer_logger().set_level(to_srslog_level(level));
+}
+
+uint64_t get_nof_dropped_logs() { return srslog::get_nof_dropped_entries(); }
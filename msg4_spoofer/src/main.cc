@@ -1,9 +1,20 @@
+#include "cell_scan.h"
 #include "config.h"
+#include "continuous_tx.h"
 #include "data_source.h"
+#include "device_clock.h"
+#include "dl_sync.h"
+#include "fft_wisdom.h"
 #include "logging.h"
+#include "prach_scan.h"
+#include "prach_scheduler.h"
+#include "preamble_bank.h"
 #include "rf_base.h"
+#include "waveform_cache.h"
 #include "srsran/srsran.h"
+#include <algorithm>
 #include <chrono>
+#include <future>
 #include <iostream>
 #include <srsran/phy/utils/vector.h>
 #include <string>
@@ -14,7 +25,12 @@
 #define MAX_LEN 70176
 
 spoofer_error_e check_config_validity(spoofer_config_t &config) {
-  if (config.rf.device_name != "uhd" && config.rf.device_name != "zmq") {
+  if (config.scan.enable && config.scan.input.empty()) {
+    LOG_ERROR("scan.input is not set");
+    return CONFIG_ERROR;
+  }
+  if (config.rf.device_name != "uhd" && config.rf.device_name != "zmq" &&
+      config.rf.device_name != "file") {
     LOG_ERROR("invalid device name");
     return CONFIG_ERROR;
   }
@@ -24,12 +40,109 @@ spoofer_error_e check_config_validity(spoofer_config_t &config) {
     LOG_ERROR("invalid  number of preambles");
     return CONFIG_ERROR;
   }
+  if (config.rf.channels.size() > RF_MAX_CHANNELS) {
+    LOG_ERROR("at most %d TX channels are supported", RF_MAX_CHANNELS);
+    return CONFIG_ERROR;
+  }
+  if (config.sweep.enable && config.sweep.occasions == 0) {
+    LOG_ERROR("sweep occasions must be positive");
+    return CONFIG_ERROR;
+  }
+  for (const channel_config_t &ch : config.rf.channels) {
+    for (uint32_t idx : ch.preambles) {
+      if (idx >= config.prach.num_ra_preambles) {
+        LOG_ERROR("invalid preamble index %u", idx);
+        return CONFIG_ERROR;
+      }
+    }
+  }
   return SUCCESS;
 }
 
+// Every combination of the swept PRACH parameters, a parameter that is not
+// swept keeps its [prach] value
+static std::vector<spoofer_config_t>
+sweep_points(const spoofer_config_t &config) {
+  if (!config.sweep.enable) {
+    return {config};
+  }
+
+  auto or_default = [](const std::vector<uint32_t> &list, uint32_t value) {
+    return list.empty() ? std::vector<uint32_t>{value} : list;
+  };
+  std::vector<uint32_t> config_idx =
+      or_default(config.sweep.config_idx, config.prach.config_idx);
+  std::vector<uint32_t> root_seq_idx =
+      or_default(config.sweep.root_seq_idx, config.prach.root_seq_idx);
+  std::vector<uint32_t> zero_corr_zone =
+      or_default(config.sweep.zero_corr_zone, config.prach.zero_corr_zone);
+
+  std::vector<spoofer_config_t> points;
+  for (uint32_t c : config_idx) {
+    for (uint32_t r : root_seq_idx) {
+      for (uint32_t z : zero_corr_zone) {
+        spoofer_config_t point = config;
+        point.prach.config_idx = c;
+        point.prach.root_seq_idx = r;
+        point.prach.zero_corr_zone = z;
+        points.push_back(point);
+      }
+    }
+  }
+  return points;
+}
+
+static void report_tx_metrics(RFBase &rf) {
+  tx_metrics_t metrics = {};
+  if (!rf.get_tx_metrics(metrics)) {
+    return;
+  }
+
+  LOG_INFO("TX events: ack=%lu underflow=%lu time_error=%lu seq_error=%lu "
+           "log_dropped=%lu",
+           (unsigned long)metrics.nof_burst_ack,
+           (unsigned long)metrics.nof_underflow,
+           (unsigned long)metrics.nof_time_error,
+           (unsigned long)metrics.nof_seq_error,
+           (unsigned long)get_nof_dropped_logs());
+
+  std::string hist;
+  for (uint32_t i = 0; i < TX_LATENCY_HIST_BINS; i++) {
+    if (metrics.latency_hist[i] > 0) {
+      hist += " <" + std::to_string(2U << i) +
+              "us:" + std::to_string(metrics.latency_hist[i]);
+    }
+  }
+  if (!hist.empty()) {
+    LOG_INFO("TX ack latency:%s", hist.c_str());
+  }
+}
+
+// Lists the cells around rf.rx_frequency, strongest first
+static int run_cell_scan(const spoofer_config_t &conf, RFBase &rf) {
+  std::vector<cell_scan_result_t> cells;
+  try {
+    cell_scan scan(conf);
+    if (scan.run(rf, cells) != SUCCESS) {
+      return EXIT_FAILURE;
+    }
+  } catch (const std::exception &e) {
+    LOG_ERROR("Failed to scan cells: %s", e.what());
+    return INIT_ERROR;
+  }
+
+  for (const cell_scan_result_t &cell : cells) {
+    LOG_INFO("Cell N_id=%u at %.3f MHz, RSRP %.1f dB, SNR %.1f dB",
+             cell.N_id, cell.frequency / 1e6, cell.rsrp_dB, cell.snr_dB);
+  }
+  return EXIT_SUCCESS;
+}
+
 int main(int argc, char *argv[]) {
+  init_logging();
+
   if (argc != 2) {
-    LOG_ERROR("Usage: msg4_spoofer <config file>\n");
+    LOG_ERROR("Usage: msg4_spoofer <config file>");
     return EXIT_FAILURE;
   }
 
@@ -39,19 +152,32 @@ int main(int argc, char *argv[]) {
   if (check_config_validity(conf) != SUCCESS)
     return CONFIG_ERROR;
 
+  if (!conf.fft.wisdom_file.empty() &&
+      srsran_dft_wisdom_set_file(conf.fft.wisdom_file.c_str()) <
+          SRSRAN_SUCCESS) {
+    LOG_ERROR("Invalid FFTW wisdom file %s", conf.fft.wisdom_file.c_str());
+    return CONFIG_ERROR;
+  }
+  if (conf.fft.precompute) {
+    return precompute_fft_wisdom(conf, sweep_points(conf)) == SUCCESS
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+  }
+
+  if (conf.scan.enable) {
+    try {
+      prach_scan scan(conf);
+      return scan.run() == SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to scan capture: %s", e.what());
+      return INIT_ERROR;
+    }
+  }
+
   srsran_prach_t prach;
-  srsran_prach_cfg_t prach_cfg;
 
   int nof_prb = conf.rf.nof_prb;
 
-  prach_cfg.is_nr = conf.prach.is_nr;
-  prach_cfg.config_idx = conf.prach.config_idx;
-  prach_cfg.hs_flag = conf.prach.hs_flag;
-  prach_cfg.freq_offset = conf.prach.freq_offset;
-  prach_cfg.root_seq_idx = conf.prach.root_seq_idx;
-  prach_cfg.zero_corr_zone = conf.prach.zero_corr_zone;
-  prach_cfg.num_ra_preambles = conf.prach.num_ra_preambles;
-
   uint32_t fft_size = srsran_symbol_sz(conf.rf.nof_prb);
   if (fft_size == 0) {
     LOG_ERROR("Invalid number of PRBs");
@@ -62,12 +188,8 @@ int main(int argc, char *argv[]) {
     LOG_ERROR("Failed to initialize PRACH");
     return INIT_ERROR;
   }
-  if (srsran_prach_set_cfg(&prach, &prach_cfg, nof_prb)) {
-    LOG_ERROR("Error configuring PRACH\n");
-    return CONFIG_ERROR;
-  }
 
-  LOG_INFO("PRACH CONFIGURED");
+  LOG_INFO("PRACH INITIALIZED");
 
   LOG_INFO("Creating RF instance for: %s", conf.rf.device_name.c_str());
   std::unique_ptr<RFBase> rf_dev = create_rf_instance(conf);
@@ -76,35 +198,177 @@ int main(int argc, char *argv[]) {
     return EXIT_FAILURE;
   }
 
-  size_t preamble_len = prach.N_seq + prach.N_cp;
+  if (conf.cell_scan.enable) {
+    return run_cell_scan(conf, *rf_dev);
+  }
+
+  // Only the current bank and the next one are held here. Bursts queued on
+  // the continuous stream keep a reference to their bank, which is released
+  // once the last of them has been sent.
+  std::vector<spoofer_config_t> points = sweep_points(conf);
+  std::unique_ptr<waveform_cache> cache;
+  try {
+    cache = std::make_unique<waveform_cache>(conf.prach.cache_dir);
+  } catch (const std::exception &e) {
+    LOG_ERROR("%s", e.what());
+    return INIT_ERROR;
+  }
 
-  std::vector<cf_t *> preambles(conf.prach.num_ra_preambles);
-  for (int i = 0; i < preambles.size(); ++i) {
-    preambles[i] = srsran_vec_cf_malloc(preamble_len);
-    srsran_prach_gen(&prach, i, conf.rf.freq_offset, preambles[i]);
+  // Only one bank is built at a time, `prach` and `cache` are not shared
+  tx_format_t tx_format = rf_dev->get_tx_format();
+  auto build_bank = [&](size_t point) -> std::shared_ptr<preamble_bank> {
+    try {
+      return cache->get(prach, points[point], tx_format);
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to render preambles: %s", e.what());
+      return nullptr;
+    }
+  };
+
+  size_t point = 0;
+  std::shared_ptr<preamble_bank> preambles = build_bank(point);
+  if (preambles == nullptr) {
+    return INIT_ERROR;
   }
 
-  uint32_t current_seq_idx = 0;
+  // The next sweep point is rendered or loaded off the TX thread while the
+  // current one is being transmitted
+  std::future<std::shared_ptr<preamble_bank>> next_bank;
+  if (points.size() > 1) {
+    LOG_INFO("Sweeping %zu PRACH configurations, %u occasions each",
+             points.size(), conf.sweep.occasions);
+    next_bank = std::async(std::launch::async, build_bank, 1);
+  }
+
+  prach_scheduler scheduler(points[point]);
+
+  std::unique_ptr<dl_sync> sync;
+  if (conf.ssb.enable_sync) {
+    try {
+      sync = std::make_unique<dl_sync>(conf, *rf_dev);
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to create downlink sync: %s", e.what());
+      return INIT_ERROR;
+    }
+    sync->start();
+
+    LOG_INFO("Waiting for cell N_id=%u SSB...", conf.rf.N_id);
+    if (!sync->wait_sync(conf.ssb.sync_timeout)) {
+      LOG_ERROR("Failed to synchronize with cell N_id=%u", conf.rf.N_id);
+      return INIT_ERROR;
+    }
+  }
+
+  // Without precomputed wisdom this includes measuring every plan
+  report_fft_planning();
+
+  // The host clock is only used to decide when to hand each burst to the
+  // device, it is re-anchored on the device time as the loop runs
+  device_clock clock(*rf_dev);
+  double time_ref = clock.now();
+
+  // Without downlink sync TTI 0 starts now, otherwise follow the cell
+  if (sync) {
+    dl_timing_t timing = sync->get_timing();
+    scheduler.set_reference(timing.tti, timing.time);
+  } else {
+    scheduler.set_reference(0, time_ref);
+    LOG_INFO("TTI 0 at device time %.9f s", time_ref);
+  }
+
+  // In continuous mode the TX thread paces the stream, the loop below only
+  // blocks on its queue
+  std::unique_ptr<continuous_tx> stream;
+  if (conf.rf.continuous_tx) {
+    try {
+      stream = std::make_unique<continuous_tx>(conf, *rf_dev);
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to create continuous TX: %s", e.what());
+      return INIT_ERROR;
+    }
+    stream->start(time_ref + conf.prach.lead_time);
+  }
+
+  auto metrics_period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(conf.log.metrics_period));
+  auto next_report = std::chrono::steady_clock::now() + metrics_period;
+
+  // Every channel cycles through its own preamble subset, all channels
+  // share the rendered preambles
+  uint32_t nof_channels = conf.rf.channels.size();
+  tx_burst_t burst = preambles->burst(0);
+  burst.nof_channels = nof_channels;
+  burst.has_time_spec = true;
+
+  uint64_t nof_occasions = 0;
+  uint64_t tti = scheduler.tti_at(time_ref + conf.prach.lead_time);
 
   while (true) {
+    if (sync) {
+      dl_timing_t timing = sync->get_timing();
+      if (timing.in_sync) {
+        scheduler.track_reference(timing.tti, timing.time);
+      }
+    }
 
-    cf_t *tx_buffer = preambles[current_seq_idx];
-    std::vector<std::complex<float>> tx_vector(tx_buffer,
-                                               tx_buffer + preamble_len);
+    // Never schedule inside the lead time, e.g. after a timing correction.
+    // The continuous stream cursor itself runs lead_time ahead of the device.
+    clock.track();
+    double margin = stream ? 2 * conf.prach.lead_time : conf.prach.lead_time;
+    tti = std::max(tti, scheduler.tti_at(clock.now() + margin));
 
-    if (rf_dev->transmit(conf, tx_vector) != SUCCESS) {
-      LOG_ERROR("Error during transmission.");
+    if (scheduler.next_occasion(tti, tti) != SUCCESS) {
       return CONFIG_ERROR;
     }
+    double tx_time = scheduler.occasion_time(tti);
 
-    current_seq_idx = (current_seq_idx + 1) % conf.prach.num_ra_preambles;
-    if (conf.prach.time_delay > 0) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(conf.prach.time_delay));
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      const std::vector<uint32_t> &subset = conf.rf.channels[ch].preambles;
+      burst.data[ch] = preambles->data(subset[nof_occasions % subset.size()]);
     }
-  }
+    burst.time = tx_time;
+
+    if (stream) {
+      if (stream->schedule(burst, preambles) != SUCCESS) {
+        LOG_ERROR("Error scheduling burst on continuous stream.");
+        return CONFIG_ERROR;
+      }
+    } else {
+      // Wait until the occasion is within the lead time, the burst itself is
+      // released by the device at tx_time regardless of host wake up jitter
+      std::this_thread::sleep_until(
+          clock.host_time(tx_time - conf.prach.lead_time));
+
+      if (rf_dev->transmit(conf, burst) != SUCCESS) {
+        LOG_ERROR("Error during transmission.");
+        return CONFIG_ERROR;
+      }
+    }
+
+    nof_occasions++;
 
-  for (auto &preamble : preambles) {
-    free(preamble);
+    if (points.size() > 1 && nof_occasions % conf.sweep.occasions == 0) {
+      point = (point + 1) % points.size();
+      const prach_config_t &next = points[point].prach;
+      LOG_INFO("Sweep: config_idx=%u root_sequence_index=%u "
+               "zero_correlation_zone=%u",
+               next.config_idx, next.root_seq_idx, next.zero_corr_zone);
+
+      preambles = next_bank.get();
+      if (preambles == nullptr) {
+        return CONFIG_ERROR;
+      }
+      next_bank = std::async(std::launch::async, build_bank,
+                             (point + 1) % points.size());
+      scheduler.set_config_idx(next.config_idx);
+      burst.nof_samples = preambles->preamble_len();
+    }
+    tti++;
+
+    if (conf.log.metrics_period > 0 &&
+        std::chrono::steady_clock::now() >= next_report) {
+      report_tx_metrics(*rf_dev);
+      next_report += metrics_period;
+    }
   }
 }
@@ -0,0 +1,271 @@
+#include "prach_scan.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+typedef struct prach_scan_header_s {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+} prach_scan_header_t;
+
+static bool ends_with(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+prach_scan::prach_scan(const spoofer_config_t &config_)
+    : config(config_), scheduler(config_) {
+  int fd = open(config.scan.input.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open " + config.scan.input + ": " +
+                             strerror(errno));
+  }
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(cf_t)) {
+    close(fd);
+    throw std::runtime_error("Empty capture " + config.scan.input);
+  }
+  mapping_size = st.st_size;
+  void *ptr = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error("Failed to map " + config.scan.input + ": " +
+                             strerror(errno));
+  }
+  samples = (const cf_t *)ptr;
+  nof_samples = mapping_size / sizeof(cf_t);
+
+  try {
+    init();
+  } catch (...) {
+    release();
+    throw;
+  }
+}
+
+prach_scan::~prach_scan() { release(); }
+
+void prach_scan::release() {
+  for (std::unique_ptr<worker_t> &w : workers) {
+    if (w->initialized) {
+      srsran_prach_free(&w->prach);
+    }
+  }
+  workers.clear();
+  if (samples != nullptr) {
+    munmap((void *)samples, mapping_size);
+    samples = nullptr;
+  }
+}
+
+void prach_scan::init() {
+  uint32_t nof_threads = config.scan.threads;
+  if (nof_threads == 0) {
+    nof_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  // Workers share the sequence tables, only the first one generates them
+  uint32_t fft_size = srsran_symbol_sz(config.rf.nof_prb);
+  srsran_prach_cfg_t prach_cfg = get_prach_cfg(config);
+  for (uint32_t i = 0; i < nof_threads; i++) {
+    auto w = std::make_unique<worker_t>();
+    w->initialized = false;
+    w->ret = SUCCESS;
+    workers.push_back(std::move(w));
+
+    srsran_prach_t &prach = workers.back()->prach;
+    if (srsran_prach_init(&prach, fft_size)) {
+      throw std::runtime_error("Failed to initialize PRACH");
+    }
+    workers.back()->initialized = true;
+    if (srsran_prach_set_cfg(&prach, &prach_cfg, config.rf.nof_prb)) {
+      throw std::runtime_error("Error configuring PRACH");
+    }
+  }
+  if (std::fabs(config.rf.srate - fft_size * 15e3) > 1.0) {
+    LOG_WARN("rf.srate %.2f Msps differs from the PRACH rate %.2f Msps",
+             config.rf.srate / 1e6, fft_size * 15e-3);
+  }
+
+  // Detection runs on N_seq samples after the cyclic prefix
+  const srsran_prach_t &prach = workers[0]->prach;
+  uint64_t window_len = prach.N_cp + prach.N_seq;
+  scheduler.set_reference(0, config.scan.tti0_time);
+  uint64_t tti = scheduler.tti_at(0.0);
+  while (true) {
+    if (scheduler.next_occasion(tti, tti) != SUCCESS) {
+      throw std::runtime_error("No PRACH occasions to scan");
+    }
+    double t = scheduler.occasion_time(tti);
+    int64_t start = std::llround(t * config.rf.srate);
+    if (start >= 0) {
+      if ((uint64_t)start + window_len > nof_samples) {
+        break;
+      }
+      occasion_samples.push_back(start);
+      occasion_times.push_back(t);
+    }
+    tti++;
+  }
+
+  // Neighbouring jobs start on the same worker, which keeps each worker on
+  // one stretch of the file until it runs dry and steals
+  size_t nof_jobs = (occasion_samples.size() + PRACH_SCAN_JOB_OCCASIONS - 1) /
+                    PRACH_SCAN_JOB_OCCASIONS;
+  for (size_t j = 0; j < nof_jobs; j++) {
+    size_t begin = j * PRACH_SCAN_JOB_OCCASIONS;
+    size_t end = std::min(begin + PRACH_SCAN_JOB_OCCASIONS,
+                          occasion_samples.size());
+    workers[j * nof_threads / nof_jobs]->jobs.push_back({begin, end});
+  }
+
+  LOG_INFO("Scanning %zu PRACH occasions of %s (%.1f s) on %u threads",
+           occasion_samples.size(), config.scan.input.c_str(),
+           nof_samples / config.rf.srate, nof_threads);
+}
+
+bool prach_scan::next_job(uint32_t id, job_t &job) {
+  {
+    worker_t &own = *workers[id];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = own.jobs.front();
+      own.jobs.pop_front();
+      return true;
+    }
+  }
+
+  // No jobs are added once running, empty queues stay empty
+  for (size_t k = 1; k < workers.size(); k++) {
+    worker_t &victim = *workers[(id + k) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = victim.jobs.back();
+      victim.jobs.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void prach_scan::work(uint32_t id) {
+  worker_t &w = *workers[id];
+  srsran_prach_t &prach = w.prach;
+
+  // Every window of every root sequence can report once
+  uint32_t max_detections =
+      prach.num_ra_preambles * (prach.N_cs != 0 ? prach.N_zc / prach.N_cs : 1);
+  std::vector<uint32_t> indices(max_detections);
+  std::vector<float> t_offsets(max_detections);
+  std::vector<float> peak_to_avg(max_detections);
+
+  job_t job;
+  while (next_job(id, job)) {
+    for (size_t i = job.begin; i < job.end; i++) {
+      // The detector does not write the signal
+      cf_t *window = (cf_t *)&samples[occasion_samples[i] + prach.N_cp];
+      uint32_t n = 0;
+      if (srsran_prach_detect_offset(&prach, config.prach.freq_offset, window,
+                                     prach.N_seq, indices.data(),
+                                     t_offsets.data(), peak_to_avg.data(),
+                                     &n) != SRSRAN_SUCCESS) {
+        LOG_ERROR("PRACH detection failed at %.6f s", occasion_times[i]);
+        w.ret = SAMPLE_ERROR;
+        return;
+      }
+      for (uint32_t k = 0; k < n; k++) {
+        w.detections.push_back(
+            {occasion_times[i], indices[k], t_offsets[k], peak_to_avg[k]});
+      }
+    }
+  }
+}
+
+spoofer_error_e prach_scan::run() {
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < workers.size(); i++) {
+    threads.emplace_back(&prach_scan::work, this, i);
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  std::vector<prach_detection_t> detections;
+  for (std::unique_ptr<worker_t> &w : workers) {
+    if (w->ret != SUCCESS) {
+      return w->ret;
+    }
+    detections.insert(detections.end(), w->detections.begin(),
+                      w->detections.end());
+  }
+  std::sort(detections.begin(), detections.end(),
+            [](const prach_detection_t &a, const prach_detection_t &b) {
+              return a.time < b.time ||
+                     (a.time == b.time && a.index < b.index);
+            });
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  LOG_INFO("Found %zu preambles in %zu occasions, took %.1f s",
+           detections.size(), occasion_samples.size(), elapsed.count());
+
+  if (ends_with(config.scan.output, ".csv")) {
+    return write_csv(detections);
+  }
+  return write_binary(detections);
+}
+
+spoofer_error_e
+prach_scan::write_csv(const std::vector<prach_detection_t> &detections) {
+  FILE *f = fopen(config.scan.output.c_str(), "w");
+  if (f == nullptr) {
+    LOG_ERROR("Failed to open %s: %s", config.scan.output.c_str(),
+              strerror(errno));
+    return FILE_ERROR;
+  }
+  fprintf(f, "time,index,t_offset,peak_to_avg\n");
+  for (const prach_detection_t &d : detections) {
+    fprintf(f, "%.9f,%u,%.9g,%.2f\n", d.time, d.index, d.t_offset,
+            d.peak_to_avg);
+  }
+  if (fclose(f) != 0) {
+    LOG_ERROR("Failed to write %s", config.scan.output.c_str());
+    return FILE_ERROR;
+  }
+  return SUCCESS;
+}
+
+spoofer_error_e
+prach_scan::write_binary(const std::vector<prach_detection_t> &detections) {
+  FILE *f = fopen(config.scan.output.c_str(), "wb");
+  if (f == nullptr) {
+    LOG_ERROR("Failed to open %s: %s", config.scan.output.c_str(),
+              strerror(errno));
+    return FILE_ERROR;
+  }
+
+  prach_scan_header_t header = {};
+  memcpy(header.magic, PRACH_SCAN_MAGIC, sizeof(header.magic));
+  header.version = PRACH_SCAN_VERSION;
+  header.record_size = sizeof(prach_detection_t);
+
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(detections.data(), sizeof(prach_detection_t),
+                   detections.size(), f) == detections.size();
+  if (fclose(f) != 0 || !ok) {
+    LOG_ERROR("Failed to write %s", config.scan.output.c_str());
+    return FILE_ERROR;
+  }
+  return SUCCESS;
+}
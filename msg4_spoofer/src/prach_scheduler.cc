@@ -0,0 +1,79 @@
+#include "prach_scheduler.h"
+#include <cmath>
+#include <srsran/phy/phch/prach.h>
+
+prach_scheduler::prach_scheduler(const spoofer_config_t &config)
+    : duplex_mode(config.ssb.duplex_mode) {
+  set_config_idx(config.prach.config_idx);
+}
+
+void prach_scheduler::set_config_idx(uint32_t config_idx_) {
+  config_idx = config_idx_;
+  uint32_t start_symbol = srsran_prach_nr_start_symbol(config_idx, duplex_mode);
+  // The FR1 tables only hold long preambles, whose starting symbol is counted
+  // in the 15 kHz reference numerology regardless of the SSB or UL SCS
+  // (TS 38.211 5.3.2)
+  start_offset_s =
+      srsran_symbol_offset_s(start_symbol, srsran_subcarrier_spacing_15kHz);
+  LOG_DEBUG("PRACH scheduler: config_idx=%u start_symbol=%u (%.1f us)",
+            config_idx, start_symbol, start_offset_s * 1e6);
+}
+
+void prach_scheduler::set_reference(uint64_t tti, double time_s) {
+  ref_tti = tti;
+  ref_time_s = time_s;
+}
+
+void prach_scheduler::track_reference(uint32_t tti, double time_s) {
+  int64_t expected =
+      (int64_t)ref_tti + std::llround((time_s - ref_time_s) * 1e3);
+  int64_t diff = ((int64_t)tti - expected) % NOF_TTI;
+  if (diff > NOF_TTI / 2) {
+    diff -= NOF_TTI;
+  } else if (diff < -(int64_t)NOF_TTI / 2) {
+    diff += NOF_TTI;
+  }
+
+  if (expected + diff < 0) {
+    diff += NOF_TTI;
+  }
+
+  ref_tti = (uint64_t)(expected + diff);
+  ref_time_s = time_s;
+}
+
+bool prach_scheduler::is_occasion(uint64_t tti) const {
+  uint32_t current_tti = tti % NOF_TTI;
+  if (duplex_mode == SRSRAN_DUPLEX_MODE_TDD) {
+    return srsran_prach_nr_tti_opportunity_fr1_unpaired(config_idx,
+                                                        current_tti);
+  }
+  return srsran_prach_nr_tti_opportunity_fr1_paired(config_idx, current_tti);
+}
+
+spoofer_error_e prach_scheduler::next_occasion(uint64_t tti,
+                                               uint64_t &occasion_tti) const {
+  // Every configuration repeats at most once per hyper frame
+  for (uint32_t i = 0; i < NOF_TTI; i++) {
+    if (is_occasion(tti + i)) {
+      occasion_tti = tti + i;
+      return SUCCESS;
+    }
+  }
+
+  LOG_ERROR("No PRACH occasion for config_idx %u", config_idx);
+  return CONFIG_ERROR;
+}
+
+double prach_scheduler::occasion_time(uint64_t tti) const {
+  double tti_offset = (double)tti - (double)ref_tti;
+  return ref_time_s + tti_offset * 1e-3 + start_offset_s;
+}
+
+uint64_t prach_scheduler::tti_at(double time_s) const {
+  double elapsed_ms = std::ceil((time_s - ref_time_s) * 1e3);
+  if (elapsed_ms <= 0) {
+    return ref_tti;
+  }
+  return ref_tti + (uint64_t)elapsed_ms;
+}
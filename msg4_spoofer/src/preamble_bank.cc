@@ -0,0 +1,118 @@
+#include "preamble_bank.h"
+#include <algorithm>
+#include <srsran/phy/utils/vector.h>
+#include <stdexcept>
+#include <sys/mman.h>
+
+// Stride granularity in samples, 64 bytes for sc16 and 128 bytes for fc32
+#define PREAMBLE_STRIDE_ALIGN 16
+
+preamble_bank::preamble_bank(srsran_prach_t &prach,
+                             const spoofer_config_t &config,
+                             tx_format_t format_)
+    : format(format_) {
+  nof_preambles = config.prach.num_ra_preambles;
+  len = prach.N_seq + prach.N_cp;
+  stride = SRSRAN_CEIL(len, PREAMBLE_STRIDE_ALIGN) * PREAMBLE_STRIDE_ALIGN;
+
+  if (format == TX_FORMAT_SC16) {
+    arena = srsran_vec_i16_malloc(2 * stride * nof_preambles);
+  } else {
+    arena = srsran_vec_cf_malloc(stride * nof_preambles);
+  }
+  if (arena == nullptr) {
+    throw std::runtime_error("Failed to allocate preamble arena");
+  }
+
+  // fc32 preambles are generated straight into their arena slots, sc16 ones
+  // through a scratch buffer holding one generation batch
+  cf_t *scratch = nullptr;
+  if (format == TX_FORMAT_SC16) {
+    scratch = srsran_vec_cf_malloc(SRSRAN_PRACH_GEN_BATCH_MAX * len);
+    if (scratch == nullptr) {
+      free(arena);
+      throw std::runtime_error("Failed to allocate preamble buffer");
+    }
+  }
+
+  uint32_t indices[SRSRAN_PRACH_GEN_BATCH_MAX];
+  cf_t *out[SRSRAN_PRACH_GEN_BATCH_MAX];
+  for (uint32_t b = 0; b < nof_preambles; b += SRSRAN_PRACH_GEN_BATCH_MAX) {
+    uint32_t n = std::min<uint32_t>(nof_preambles - b,
+                                    SRSRAN_PRACH_GEN_BATCH_MAX);
+    for (uint32_t i = 0; i < n; i++) {
+      indices[i] = b + i;
+      out[i] = format == TX_FORMAT_SC16
+                   ? scratch + (size_t)len * i
+                   : (cf_t *)arena + (size_t)stride * (b + i);
+    }
+
+    if (srsran_prach_gen_batch(&prach, indices, n, config.rf.freq_offset,
+                               out) != SRSRAN_SUCCESS) {
+      free(scratch);
+      free(arena);
+      throw std::runtime_error("Failed to generate preambles");
+    }
+
+    if (format == TX_FORMAT_SC16) {
+      for (uint32_t i = 0; i < n; i++) {
+        int16_t *dst = (int16_t *)arena + 2 * (size_t)stride * (b + i);
+        srsran_vec_convert_fi((const float *)out[i], TX_SC16_SCALE, dst,
+                              2 * len);
+      }
+    }
+  }
+
+  free(scratch);
+
+  LOG_INFO("Rendered %u preambles of %u samples (%s, %.1f MB)", nof_preambles,
+           len, format == TX_FORMAT_SC16 ? "sc16" : "fc32",
+           (format == TX_FORMAT_SC16 ? 4.0 : 8.0) * stride * nof_preambles /
+               1e6);
+}
+
+preamble_bank::preamble_bank(void *mapping_, size_t mapping_size_,
+                             size_t arena_offset, tx_format_t format_,
+                             uint32_t nof_preambles_, uint32_t len_)
+    : format(format_), nof_preambles(nof_preambles_), len(len_),
+      mapping(mapping_), mapping_size(mapping_size_) {
+  stride = SRSRAN_CEIL(len, PREAMBLE_STRIDE_ALIGN) * PREAMBLE_STRIDE_ALIGN;
+  arena = (uint8_t *)mapping + arena_offset;
+  if (arena_offset + arena_size() > mapping_size) {
+    munmap(mapping, mapping_size);
+    throw std::runtime_error("Preamble mapping is too small");
+  }
+}
+
+preamble_bank::~preamble_bank() {
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+  } else {
+    free(arena);
+  }
+}
+
+size_t preamble_bank::arena_size() const {
+  size_t sample_sz =
+      format == TX_FORMAT_SC16 ? 2 * sizeof(int16_t) : sizeof(cf_t);
+  return sample_sz * stride * nof_preambles;
+}
+
+const void *preamble_bank::data(uint32_t idx) const {
+  if (format == TX_FORMAT_SC16) {
+    return (const int16_t *)arena + 2 * (size_t)stride * idx;
+  }
+  return (const cf_t *)arena + (size_t)stride * idx;
+}
+
+tx_burst_t preamble_bank::burst(uint32_t idx) const {
+  tx_burst_t burst = {};
+  burst.data[0] = data(idx);
+  burst.nof_channels = 1;
+  burst.nof_samples = len;
+  burst.format = format;
+  burst.has_time_spec = false;
+  burst.start_of_burst = true;
+  burst.end_of_burst = true;
+  return burst;
+}
@@ -1,6 +1,37 @@
 #include "rf_base.h"
+#include "rf_file.h"
 #include "rf_uhd.h"
-#include <iostream>
+#include "rf_zmq.h"
+
+spoofer_error_e
+RFBase::transmit(const spoofer_config_t &args,
+                 const std::vector<std::complex<float>> &tx_data) {
+  tx_burst_t burst = {};
+  burst.data[0] = tx_data.data();
+  burst.nof_channels = 1;
+  burst.nof_samples = tx_data.size();
+  burst.format = TX_FORMAT_FC32;
+  burst.start_of_burst = true;
+  burst.end_of_burst = true;
+  burst.has_time_spec = false;
+  return transmit(args, burst);
+}
+
+spoofer_error_e
+RFBase::transmit(const spoofer_config_t &args,
+                 const std::vector<std::complex<float>> &tx_data,
+                 double tx_time) {
+  tx_burst_t burst = {};
+  burst.data[0] = tx_data.data();
+  burst.nof_channels = 1;
+  burst.nof_samples = tx_data.size();
+  burst.format = TX_FORMAT_FC32;
+  burst.start_of_burst = true;
+  burst.end_of_burst = true;
+  burst.has_time_spec = true;
+  burst.time = tx_time;
+  return transmit(args, burst);
+}
 
 std::unique_ptr<RFBase> create_rf_instance(const spoofer_config_t &config) {
   if (config.rf.device_name == "uhd") {
@@ -10,13 +41,23 @@ std::unique_ptr<RFBase> create_rf_instance(const spoofer_config_t &config) {
       LOG_ERROR("Failed to create RF_UHD object: %s", e.what());
       return nullptr;
     }
-  }
-  // else if (rf_type == "zmq") {
-  // return std::make_unique<RF_ZMQ>();
-  // }
-  else {
-    std::cerr << "Unknown/Unsupported RF type: " << config.rf.device_name
-              << std::endl;
+  } else if (config.rf.device_name == "zmq") {
+    try {
+      return std::make_unique<RF_ZMQ>(config);
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to create RF_ZMQ object: %s", e.what());
+      return nullptr;
+    }
+  } else if (config.rf.device_name == "file") {
+    try {
+      return std::make_unique<RF_File>(config);
+    } catch (const std::exception &e) {
+      LOG_ERROR("Failed to create RF_File object: %s", e.what());
+      return nullptr;
+    }
+  } else {
+    LOG_ERROR("Unknown/Unsupported RF type: %s",
+              config.rf.device_name.c_str());
     return nullptr;
   }
 }
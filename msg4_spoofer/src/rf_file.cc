@@ -0,0 +1,190 @@
+#include "rf_file.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Buffer of the sidecar index stream
+#define RF_FILE_INDEX_BUFFER_SIZE (1UL << 20)
+
+static bool ends_with(const std::string &str, const std::string &suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+RF_File::RF_File(const spoofer_config_t &config)
+    : path(config.rf.file_path), srate(config.rf.srate) {
+  if (path.empty()) {
+    throw std::runtime_error("rf.file_path is not set");
+  }
+  if (config.rf.channels.size() != 1) {
+    throw std::runtime_error("The file backend records a single channel");
+  }
+
+  format = ends_with(path, ".sc16") ? TX_FORMAT_SC16 : TX_FORMAT_FC32;
+  sample_sz = format == TX_FORMAT_SC16 ? 2 * sizeof(int16_t) : sizeof(cf_t);
+
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open " + path + ": " +
+                             strerror(errno));
+  }
+
+  if (config.rf.file_index) {
+    std::string index_path = path + ".idx";
+    index = fopen(index_path.c_str(), "w");
+    if (index == nullptr) {
+      close(fd);
+      throw std::runtime_error("Failed to open " + index_path);
+    }
+    setvbuf(index, nullptr, _IOFBF, RF_FILE_INDEX_BUFFER_SIZE);
+    fprintf(index, "# offset nof_samples time\n");
+  }
+
+  host_ref = std::chrono::steady_clock::now();
+  LOG_INFO("Recording %s samples at %.2f Msps to %s",
+           format == TX_FORMAT_SC16 ? "sc16" : "fc32", srate / 1e6,
+           path.c_str());
+}
+
+RF_File::~RF_File() {
+  if (window != nullptr) {
+    munmap(window, RF_FILE_WINDOW_SIZE);
+  }
+  if (fd >= 0) {
+    // Drop the unwritten tail of the last window
+    if (ftruncate(fd, cursor * sample_sz) != 0) {
+      LOG_ERROR("Failed to truncate %s: %s", path.c_str(), strerror(errno));
+    }
+    close(fd);
+  }
+  if (index != nullptr) {
+    fclose(index);
+  }
+  LOG_INFO("Recorded %lu bursts, %lu samples to %s",
+           (unsigned long)metrics.nof_burst_ack, (unsigned long)cursor,
+           path.c_str());
+}
+
+double RF_File::get_time_now() {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - host_ref;
+  return elapsed.count();
+}
+
+bool RF_File::get_tx_metrics(tx_metrics_t &metrics_) {
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  metrics_ = metrics;
+  return true;
+}
+
+spoofer_error_e RF_File::receive(cf_t *data, uint32_t nof_samples,
+                                 double &timestamp) {
+  LOG_ERROR("RF_File: receive is not supported");
+  return CONFIG_ERROR;
+}
+
+spoofer_error_e RF_File::map_window(uint64_t offset) {
+  if (window != nullptr) {
+    munmap(window, RF_FILE_WINDOW_SIZE);
+    window = nullptr;
+  }
+
+  // Growing the file leaves a hole, which reads back as zeros
+  if (file_size < offset + RF_FILE_WINDOW_SIZE) {
+    file_size = offset + RF_FILE_WINDOW_SIZE;
+    if (ftruncate(fd, file_size) != 0) {
+      LOG_ERROR("Failed to grow %s: %s", path.c_str(), strerror(errno));
+      return FILE_ERROR;
+    }
+  }
+
+  void *ptr = mmap(nullptr, RF_FILE_WINDOW_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, offset);
+  if (ptr == MAP_FAILED) {
+    LOG_ERROR("Failed to map %s: %s", path.c_str(), strerror(errno));
+    return FILE_ERROR;
+  }
+  madvise(ptr, RF_FILE_WINDOW_SIZE, MADV_SEQUENTIAL);
+
+  window = (uint8_t *)ptr;
+  window_offset = offset;
+  return SUCCESS;
+}
+
+spoofer_error_e RF_File::write(const void *data, uint64_t offset,
+                               size_t nof_bytes) {
+  const uint8_t *src = (const uint8_t *)data;
+  while (nof_bytes > 0) {
+    if (window == nullptr || offset < window_offset ||
+        offset >= window_offset + RF_FILE_WINDOW_SIZE) {
+      spoofer_error_e ret =
+          map_window(offset - offset % RF_FILE_WINDOW_SIZE);
+      if (ret != SUCCESS) {
+        return ret;
+      }
+    }
+
+    size_t n = std::min<uint64_t>(
+        nof_bytes, window_offset + RF_FILE_WINDOW_SIZE - offset);
+    memcpy(window + (offset - window_offset), src, n);
+    src += n;
+    offset += n;
+    nof_bytes -= n;
+  }
+  return SUCCESS;
+}
+
+spoofer_error_e RF_File::transmit(const spoofer_config_t &args,
+                                  const tx_burst_t &burst) {
+  if (burst.nof_channels != 1) {
+    LOG_ERROR("RF_File: burst has %u channels", burst.nof_channels);
+    return CONFIG_ERROR;
+  }
+  if (burst.format != format) {
+    LOG_ERROR("RF_File: burst format does not match the capture");
+    return CONFIG_ERROR;
+  }
+
+  uint64_t offset = cursor;
+  if (burst.has_time_spec) {
+    int64_t start = std::llround(burst.time * srate);
+    if (start < (int64_t)cursor) {
+      // Same as a radio, a burst whose time has passed never goes out
+      {
+        std::lock_guard<std::mutex> lock(metrics_mutex);
+        metrics.nof_time_error++;
+        metrics.last_time_error_time = burst.time;
+      }
+      LOG_WARN_LIMITED(overlap_limiter,
+                       "RF_File: burst at %.6f s overlaps the previous one",
+                       burst.time);
+      return SUCCESS;
+    }
+    offset = start;
+  }
+
+  if (burst.nof_samples > 0) {
+    spoofer_error_e ret =
+        write(burst.data[0], offset * sample_sz, burst.nof_samples * sample_sz);
+    if (ret != SUCCESS) {
+      return ret;
+    }
+  }
+  cursor = offset + burst.nof_samples;
+
+  if (burst.has_time_spec) {
+    {
+      std::lock_guard<std::mutex> lock(metrics_mutex);
+      metrics.nof_burst_ack++;
+    }
+    if (index != nullptr) {
+      fprintf(index, "%lu %zu %.9f\n", (unsigned long)offset,
+              burst.nof_samples, burst.time);
+    }
+  }
+  return SUCCESS;
+}
@@ -1,85 +1,219 @@
 #include "rf_uhd.h"
+#include <srsran/phy/utils/vector.h>
+#include <thread>
 #include <uhd/usrp/multi_usrp.hpp>
 
 void RF_UHD::handle_uhd_error(uhd_error err) {
   if (err != UHD_ERROR_NONE) {
-    fprintf(stderr, "UHD ERROR: %s\n", strerror(err));
+    LOG_ERROR("UHD ERROR: %s", strerror(err));
     exit(EXIT_FAILURE);
   }
 }
 
-RF_UHD::RF_UHD(const spoofer_config_t &config) {
+RF_UHD::RF_UHD(const spoofer_config_t &config) : srate(config.rf.srate) {
 
   try {
-    std::cout << "Initializing RF_UHD device..." << std::endl;
+    LOG_INFO("Initializing RF_UHD device...");
 
-    uint32_t nof_channels = 1;
+    nof_channels = config.rf.channels.size();
     const uhd::device_addr_t dev_addr(config.rf.device_args);
 
     handle_uhd_error(rf_dev.usrp_make(dev_addr, nof_channels));
 
-    size_t channel_no = 0;
-    float actual_frequency = 0.0;
-
-    handle_uhd_error(rf_dev.set_tx_gain(channel_no, config.rf.tx_gain));
     handle_uhd_error(rf_dev.set_tx_rate(config.rf.srate));
-    handle_uhd_error(
-        rf_dev.set_tx_freq(0, config.rf.frequency, actual_frequency));
+    handle_uhd_error(rf_dev.set_rx_rate(config.rf.srate));
+
+    // Device time starts at zero so that timed bursts are relative to start
+    // up. Several motherboards latch it on the same edge of a shared PPS.
+    if (config.rf.time_source == "internal") {
+      handle_uhd_error(rf_dev.set_time_now(uhd::time_spec_t(0.0)));
+    } else {
+      handle_uhd_error(rf_dev.set_sync_source(config.rf.time_source,
+                                              config.rf.time_source));
+      handle_uhd_error(rf_dev.set_time_unknown_pps(uhd::time_spec_t(0.0)));
+    }
+
+    // Retune every channel at the same device time so that the LOs and DSP
+    // chains of all channels start from a common reference
+    uhd::time_spec_t tune_time;
+    if (nof_channels > 1) {
+      handle_uhd_error(rf_dev.get_time_now(tune_time));
+      tune_time += TUNE_COMMAND_DELAY;
+      handle_uhd_error(rf_dev.set_command_time(tune_time));
+    }
+
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      const channel_config_t &ch_config = config.rf.channels[ch];
+      float actual_frequency = 0.0;
+      handle_uhd_error(rf_dev.set_tx_gain(ch, ch_config.tx_gain));
+      handle_uhd_error(
+          rf_dev.set_tx_freq(ch, ch_config.frequency, actual_frequency));
+    }
 
+    size_t channel_no = 0;
     float actual_rx_frequency = 0.0;
     handle_uhd_error(rf_dev.set_rx_gain(channel_no, config.rf.rx_gain));
-    handle_uhd_error(rf_dev.set_rx_rate(config.rf.srate));
-    handle_uhd_error(rf_dev.set_rx_freq(channel_no, config.rf.frequency,
+    handle_uhd_error(rf_dev.set_rx_freq(channel_no, config.rf.rx_frequency,
                                         actual_rx_frequency));
 
+    if (nof_channels > 1) {
+      handle_uhd_error(rf_dev.clear_command_time());
+      uhd::time_spec_t now;
+      do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        handle_uhd_error(rf_dev.get_time_now(now));
+      } while (now < tune_time);
+    }
+
+    // Take sc16 from the host when it is also the over the wire format, so
+    // that UHD only copies the samples
+    if (rf_dev.stream_args.otw_format == "sc16") {
+      rf_dev.tx_cpu_format = "sc16";
+      tx_format = TX_FORMAT_SC16;
+    }
+
     size_t max_tx_samps = 0;
     handle_uhd_error(rf_dev.get_tx_stream(max_tx_samps));
     size_t max_rx_samps = 0;
     handle_uhd_error(rf_dev.get_rx_stream(max_rx_samps));
-    std::cout << "RF_UHD device initialized and configured." << std::endl;
+
+    tx_monitor.start(get_time_now());
+    LOG_INFO("RF_UHD device initialized and configured.");
   } catch (const uhd::exception &e) {
 
     throw std::runtime_error(e.what());
   }
 }
 
-spoofer_error_e
-RF_UHD::transmit(const spoofer_config_t &args,
-                 const std::vector<std::complex<float>> &tx_data_buffer) {
+bool RF_UHD::get_tx_metrics(tx_metrics_t &metrics) {
+  metrics = tx_monitor.get_metrics();
+  return true;
+}
+
+double RF_UHD::get_time_now() {
+  uhd::time_spec_t time_spec;
+  handle_uhd_error(rf_dev.get_time_now(time_spec));
+  return time_spec.get_real_secs();
+}
+
+spoofer_error_e RF_UHD::receive(cf_t *data, uint32_t nof_samples,
+                                double &timestamp) {
+  if (!rf_dev.rx_stream) {
+    LOG_ERROR("RF_UHD Error: Receive streamer not initialized.");
+    return CONFIG_ERROR;
+  }
+
+  try {
+    if (!rx_streaming) {
+      handle_uhd_error(rf_dev.start_rx_stream(0.1));
+      rx_streaming = true;
+    }
+
+    // Keep receiving until the whole request is filled, the timestamp is
+    // taken from the first packet
+    uint32_t nof_rxd_total = 0;
+    while (nof_rxd_total < nof_samples) {
+      void *buff = (void *)(data + nof_rxd_total);
+      uhd::rx_metadata_t metadata;
+      size_t nof_rxd_samples = 0;
+
+      handle_uhd_error(rf_dev.receive(&buff, nof_samples - nof_rxd_total,
+                                      metadata, 1.0f, false,
+                                      nof_rxd_samples));
+
+      if (metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_TIMEOUT) {
+        LOG_ERROR("RF_UHD Error: Receive timeout.");
+        return SAMPLE_ERROR;
+      }
+      if (metadata.error_code == uhd::rx_metadata_t::ERROR_CODE_OVERFLOW) {
+        LOG_WARN_LIMITED(overflow_limiter, "RF_UHD: Receive overflow");
+      }
+
+      if (nof_rxd_total == 0) {
+        timestamp = metadata.time_spec.get_real_secs();
+      }
+      nof_rxd_total += nof_rxd_samples;
+    }
+  } catch (const uhd::exception &e) {
+    LOG_ERROR("UHD RX Exception: %s", e.what());
+    return SAMPLE_ERROR;
+  }
+
+  return SUCCESS;
+}
+
+spoofer_error_e RF_UHD::transmit(const spoofer_config_t &args,
+                                 const tx_burst_t &burst) {
   uhd::tx_streamer::sptr tx_stream = rf_dev.tx_stream;
 
   if (!tx_stream) {
-    std::cerr << "RF_UHD Error: Transmit streamer not initialized."
-              << std::endl;
+    LOG_ERROR("RF_UHD Error: Transmit streamer not initialized.");
     return CONFIG_ERROR;
   }
 
-  size_t samples_to_send = tx_data_buffer.size();
+  size_t samples_to_send = burst.nof_samples;
 
-  if (samples_to_send == 0) {
-    std::cerr << "RF_UHD Warning: Data buffer is empty, nothing to transmit."
-              << std::endl;
+  // An empty burst is only meaningful to close a continuous stream
+  if (samples_to_send == 0 && !burst.end_of_burst) {
+    LOG_WARN("RF_UHD Warning: Data buffer is empty, nothing to transmit.");
     return SUCCESS;
   }
 
+  if (burst.nof_channels != nof_channels) {
+    LOG_ERROR("RF_UHD Error: Burst has %u channels, streamer has %u",
+              burst.nof_channels, nof_channels);
+    return CONFIG_ERROR;
+  }
+
+  // Bursts not rendered in the streamer format are converted here, the
+  // preamble bank hands them over already in the streamer format
+  const void *tx_data[RF_MAX_CHANNELS];
+  if (burst.format != tx_format) {
+    if (burst.format != TX_FORMAT_FC32) {
+      LOG_ERROR("RF_UHD Error: Unsupported burst format.");
+      return CONFIG_ERROR;
+    }
+    conversion_buffer.resize(2 * samples_to_send * nof_channels);
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      int16_t *out = conversion_buffer.data() + 2 * samples_to_send * ch;
+      srsran_vec_convert_fi((const float *)burst.data[ch], TX_SC16_SCALE, out,
+                            2 * samples_to_send);
+      tx_data[ch] = out;
+    }
+  } else {
+    for (uint32_t ch = 0; ch < nof_channels; ch++) {
+      tx_data[ch] = burst.data[ch];
+    }
+  }
+  uhd::tx_streamer::buffs_type buffs(tx_data, nof_channels);
+
   uhd::tx_metadata_t metadata;
-  metadata.start_of_burst = true;
-  metadata.end_of_burst = true;
-  metadata.has_time_spec = false;
+  metadata.start_of_burst = burst.start_of_burst;
+  metadata.end_of_burst = burst.end_of_burst;
+  metadata.has_time_spec = burst.has_time_spec;
+  if (burst.has_time_spec) {
+    metadata.time_spec = uhd::time_spec_t(burst.time);
+  }
 
   try {
-    size_t num_tx_samps =
-        tx_stream->send(tx_data_buffer.data(), samples_to_send, metadata);
+    size_t num_tx_samps = tx_stream->send(buffs, samples_to_send, metadata);
 
     if (num_tx_samps != samples_to_send) {
       return CONFIG_ERROR;
     }
 
+    // Only standalone timed bursts are acknowledged one by one
+    if (burst.has_time_spec && burst.end_of_burst) {
+      tx_monitor.burst_scheduled(burst.time + samples_to_send / srate,
+                                 nof_channels);
+    }
+
   } catch (const uhd::exception &e) {
-    std::cerr << "UHD TX Exception: " << e.what() << std::endl;
+    LOG_ERROR("UHD TX Exception: %s", e.what());
     return CONFIG_ERROR;
   }
 
-  std::cout << "RF_UHD: Transmission complete." << std::endl;
+  // Completed bursts are counted by the TX monitor and reported with the
+  // periodic TX metrics
   return SUCCESS;
 }
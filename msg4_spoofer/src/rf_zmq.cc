@@ -0,0 +1,155 @@
+#include "rf_zmq.h"
+#include <algorithm>
+#include <cmath>
+#include <srsran/phy/utils/vector.h>
+#include <stdexcept>
+#include <thread>
+
+RF_ZMQ::RF_ZMQ(const spoofer_config_t &config)
+    : device_args(config.rf.device_args), srate(config.rf.srate),
+      rate_limit(config.rf.rate_limit) {
+  LOG_INFO("Initializing RF_ZMQ device...");
+
+  nof_channels = config.rf.channels.size();
+  if (nof_channels > SRSRAN_MAX_CHANNELS) {
+    throw std::runtime_error("Too many channels for the zmq plugin");
+  }
+
+  if (srsran_rf_open_devname(&rf_dev, "zmq", device_args.data(),
+                             nof_channels) != SRSRAN_SUCCESS) {
+    throw std::runtime_error("Failed to open zmq device with args " +
+                             device_args);
+  }
+
+  srsran_rf_set_tx_srate(&rf_dev, srate);
+  srsran_rf_set_rx_srate(&rf_dev, srate);
+
+  // The plugin maps channels to ports by frequency. Its TX gain is common
+  // to all channels and left at 0 dB, the per-channel gain is applied while
+  // copying each burst into the scratch buffers.
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    srsran_rf_set_tx_freq(&rf_dev, ch, config.rf.channels[ch].frequency);
+    tx_scale[ch] =
+        srsran_convert_dB_to_amplitude(config.rf.channels[ch].tx_gain);
+  }
+  srsran_rf_set_rx_freq(&rf_dev, 0, config.rf.rx_frequency);
+  srsran_rf_set_rx_gain(&rf_dev, config.rf.rx_gain);
+
+  host_ref = std::chrono::steady_clock::now();
+  LOG_INFO("RF_ZMQ device initialized and configured.");
+}
+
+RF_ZMQ::~RF_ZMQ() { srsran_rf_close(&rf_dev); }
+
+double RF_ZMQ::get_time_now() {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - host_ref;
+  return elapsed.count();
+}
+
+void RF_ZMQ::throttle(uint64_t nof_pushed) {
+  if (rate_limit <= 0) {
+    return;
+  }
+  std::chrono::duration<double> due(nof_pushed / rate_limit);
+  std::this_thread::sleep_until(
+      host_ref + std::chrono::duration_cast<std::chrono::nanoseconds>(due));
+}
+
+spoofer_error_e RF_ZMQ::receive(cf_t *data, uint32_t nof_samples,
+                                double &timestamp) {
+  if (!rx_streaming) {
+    if (srsran_rf_start_rx_stream(&rf_dev, true) != SRSRAN_SUCCESS) {
+      LOG_ERROR("RF_ZMQ Error: Failed to start receive stream.");
+      return CONFIG_ERROR;
+    }
+    rx_streaming = true;
+  }
+
+  // Keep receiving until the whole request is filled, the timestamp is taken
+  // from the first chunk
+  uint32_t nof_rxd_total = 0;
+  while (nof_rxd_total < nof_samples) {
+    time_t secs = 0;
+    double frac_secs = 0.0;
+    int n = srsran_rf_recv_with_time(&rf_dev, data + nof_rxd_total,
+                                     nof_samples - nof_rxd_total, true, &secs,
+                                     &frac_secs);
+    if (n < 0) {
+      LOG_ERROR("RF_ZMQ Error: Receive failed.");
+      return SAMPLE_ERROR;
+    }
+    if (n == 0) {
+      LOG_ERROR("RF_ZMQ Error: Receive timeout.");
+      return SAMPLE_ERROR;
+    }
+
+    // Follows the plugin RX sample count, which only matches the TX timeline
+    // when the sink loops the stream back
+    if (nof_rxd_total == 0) {
+      timestamp = secs + frac_secs;
+    }
+    nof_rxd_total += std::min((uint32_t)n, nof_samples - nof_rxd_total);
+  }
+  return SUCCESS;
+}
+
+spoofer_error_e RF_ZMQ::transmit(const spoofer_config_t &args,
+                                 const tx_burst_t &burst) {
+  // The plugin has no notion of an open burst, closing one is a no-op
+  if (burst.nof_samples == 0) {
+    return SUCCESS;
+  }
+
+  if (burst.format != TX_FORMAT_FC32) {
+    LOG_ERROR("RF_ZMQ Error: Unsupported burst format.");
+    return CONFIG_ERROR;
+  }
+  if (burst.nof_channels != nof_channels) {
+    LOG_ERROR("RF_ZMQ Error: Burst has %u channels, device has %u",
+              burst.nof_channels, nof_channels);
+    return CONFIG_ERROR;
+  }
+
+  // The plugin scales the buffers in place, never hand it the shared
+  // preamble bank samples
+  void *tx_data[SRSRAN_MAX_CHANNELS] = {};
+  for (uint32_t ch = 0; ch < nof_channels; ch++) {
+    std::vector<cf_t> &buffer = scratch[ch];
+    if (buffer.size() < burst.nof_samples) {
+      buffer.resize(burst.nof_samples);
+    }
+    srsran_vec_sc_prod_cfc((const cf_t *)burst.data[ch], tx_scale[ch],
+                           buffer.data(), burst.nof_samples);
+    tx_data[ch] = buffer.data();
+  }
+
+  // A timed burst starts after the padding the plugin inserts up to its
+  // time, throttle before handing both over
+  uint64_t start = tx_cursor;
+  time_t secs = 0;
+  double frac_secs = 0.0;
+  if (burst.has_time_spec) {
+    secs = (time_t)std::floor(burst.time);
+    frac_secs = burst.time - secs;
+    start = std::max<uint64_t>(start, std::llround(burst.time * srate));
+  }
+  throttle(start);
+
+  int ret;
+  if (burst.has_time_spec) {
+    ret = srsran_rf_send_timed_multi(&rf_dev, tx_data, burst.nof_samples,
+                                     secs, frac_secs, true,
+                                     burst.start_of_burst, burst.end_of_burst);
+  } else {
+    ret = srsran_rf_send_multi(&rf_dev, tx_data, burst.nof_samples, true,
+                               burst.start_of_burst, burst.end_of_burst);
+  }
+  if (ret != SRSRAN_SUCCESS) {
+    LOG_ERROR("RF_ZMQ Error: Send failed, burst time %.6f s", burst.time);
+    return SAMPLE_ERROR;
+  }
+
+  tx_cursor = start + burst.nof_samples;
+  return SUCCESS;
+}
@@ -0,0 +1,161 @@
+#include "uhd_tx_monitor.h"
+#include "logging.h"
+#include <algorithm>
+#include <cmath>
+
+// recv_async_msg timeout in seconds, bounds how long stop() takes
+#define TX_MONITOR_TIMEOUT 0.1f
+
+uhd_tx_monitor::uhd_tx_monitor(rf_handler &rf_dev_) : rf_dev(rf_dev_) {}
+
+uhd_tx_monitor::~uhd_tx_monitor() { stop(); }
+
+void uhd_tx_monitor::start(double time_ref_) {
+  if (monitor_thread.joinable()) {
+    return;
+  }
+  time_ref = time_ref_;
+  host_ref = std::chrono::steady_clock::now();
+  running = true;
+  monitor_thread = std::thread(&uhd_tx_monitor::run_thread, this);
+}
+
+void uhd_tx_monitor::stop() {
+  running = false;
+  if (monitor_thread.joinable()) {
+    monitor_thread.join();
+  }
+}
+
+double uhd_tx_monitor::device_time_now() const {
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - host_ref;
+  return time_ref + elapsed.count();
+}
+
+void uhd_tx_monitor::burst_scheduled(double end_time, uint32_t nof_channels) {
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  if (pending.size() >= TX_MONITOR_MAX_PENDING) {
+    pending.pop_front();
+  }
+  uint32_t all_channels = (uint32_t)((1ULL << nof_channels) - 1);
+  pending.push_back({end_time, all_channels, 0});
+}
+
+// The acknowledgement belongs to the latest burst that ended by `ack_time`.
+// Older bursts still missing this channel were dropped by the device, e.g.
+// after a time error, and will never be complete. Returns true once the
+// burst has been acknowledged on all of its channels.
+bool uhd_tx_monitor::ack_burst(size_t channel, double ack_time,
+                               double &end_time) {
+  uint32_t mask = 1U << channel;
+  auto match = pending.end();
+  for (auto it = pending.begin(); it != pending.end(); ++it) {
+    if (it->end_time > ack_time + TX_MONITOR_ACK_TOLERANCE) {
+      break;
+    }
+    match = it;
+  }
+  if (match == pending.end() || (match->all_channels & mask) == 0 ||
+      (match->acked & mask) != 0) {
+    return false;
+  }
+
+  match->acked |= mask;
+  bool complete = match->acked == match->all_channels;
+  end_time = match->end_time;
+  if (complete) {
+    match = pending.erase(match);
+  }
+
+  auto last = std::remove_if(pending.begin(), match,
+                             [mask](const pending_burst_t &burst) {
+                               return (burst.acked & mask) == 0;
+                             });
+  pending.erase(last, match);
+  return complete;
+}
+
+bool uhd_tx_monitor::is_new_event(channel_event_t &event, size_t channel,
+                                  double time) {
+  uint32_t mask = 1U << channel;
+  if (event.channels != 0 && (event.channels & mask) == 0 &&
+      std::abs(time - event.time) <= TX_MONITOR_EVENT_WINDOW) {
+    event.channels |= mask;
+    return false;
+  }
+  event.time = time;
+  event.channels = mask;
+  return true;
+}
+
+void uhd_tx_monitor::add_latency(double latency_s) {
+  double latency_us = latency_s * 1e6;
+  uint32_t bin = 0;
+  if (latency_us >= 1.0) {
+    bin = std::min<uint32_t>((uint32_t)std::log2(latency_us),
+                             TX_LATENCY_HIST_BINS - 1);
+  }
+  metrics.latency_hist[bin]++;
+}
+
+void uhd_tx_monitor::run_thread() {
+  while (running) {
+    uhd::async_metadata_t md;
+    bool valid = false;
+
+    try {
+      rf_dev.recv_async_msg(md, TX_MONITOR_TIMEOUT, valid);
+    } catch (const uhd::exception &e) {
+      LOG_ERROR("UHD async message error: %s", e.what());
+      break;
+    }
+    if (!valid) {
+      continue;
+    }
+
+    double event_time =
+        md.has_time_spec ? md.time_spec.get_real_secs() : device_time_now();
+
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    switch (md.event_code) {
+    case uhd::async_metadata_t::EVENT_CODE_BURST_ACK: {
+      double end_time = 0.0;
+      if (ack_burst(md.channel, event_time, end_time)) {
+        metrics.nof_burst_ack++;
+        add_latency(event_time - end_time);
+      }
+      break;
+    }
+    case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW:
+    case uhd::async_metadata_t::EVENT_CODE_UNDERFLOW_IN_PACKET:
+      if (is_new_event(underflow_event, md.channel, event_time)) {
+        metrics.nof_underflow++;
+        metrics.last_underflow_time = event_time;
+      }
+      break;
+    case uhd::async_metadata_t::EVENT_CODE_TIME_ERROR:
+      // The late burst is dropped by the device and never acknowledged, its
+      // pending entry goes with the next acknowledgement on the channel
+      if (is_new_event(time_error_event, md.channel, event_time)) {
+        metrics.nof_time_error++;
+        metrics.last_time_error_time = event_time;
+      }
+      break;
+    case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR:
+    case uhd::async_metadata_t::EVENT_CODE_SEQ_ERROR_IN_BURST:
+      if (is_new_event(seq_error_event, md.channel, event_time)) {
+        metrics.nof_seq_error++;
+        metrics.last_seq_error_time = event_time;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+tx_metrics_t uhd_tx_monitor::get_metrics() {
+  std::lock_guard<std::mutex> lock(metrics_mutex);
+  return metrics;
+}
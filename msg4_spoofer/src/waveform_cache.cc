@@ -0,0 +1,186 @@
+#include "waveform_cache.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define WAVEFORM_CACHE_MAGIC "PRACHWF"
+
+typedef struct waveform_cache_header_s {
+  char magic[8];
+  uint32_t version;
+  waveform_key_t key;
+  uint32_t nof_preambles;
+  uint32_t len;
+} waveform_cache_header_t;
+
+static_assert(sizeof(waveform_cache_header_t) <= WAVEFORM_CACHE_HEADER_SIZE,
+              "Waveform cache header does not fit");
+
+// 64-bit FNV-1a
+static uint64_t hash_key(const waveform_key_t &key) {
+  const uint8_t *ptr = (const uint8_t *)&key;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < sizeof(key); i++) {
+    hash ^= ptr[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static waveform_key_t make_key(const spoofer_config_t &config,
+                               tx_format_t format) {
+  waveform_key_t key = {};
+  key.config_idx = config.prach.config_idx;
+  key.root_seq_idx = config.prach.root_seq_idx;
+  key.zero_corr_zone = config.prach.zero_corr_zone;
+  key.num_ra_preambles = config.prach.num_ra_preambles;
+  key.N_ifft = srsran_symbol_sz(config.rf.nof_prb);
+  key.freq_offset = config.rf.freq_offset;
+  key.is_nr = config.prach.is_nr;
+  key.hs_flag = config.prach.hs_flag;
+  key.format = format;
+  return key;
+}
+
+static bool write_all(int fd, const void *data, size_t nof_bytes) {
+  const uint8_t *ptr = (const uint8_t *)data;
+  while (nof_bytes > 0) {
+    ssize_t n = write(fd, ptr, nof_bytes);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    ptr += n;
+    nof_bytes -= n;
+  }
+  return true;
+}
+
+waveform_cache::waveform_cache(const std::string &dir_) : dir(dir_) {
+  if (!dir.empty() && mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+    throw std::runtime_error("Failed to create waveform cache " + dir + ": " +
+                             strerror(errno));
+  }
+}
+
+std::string waveform_cache::path_of(const waveform_key_t &key) const {
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.prach",
+           (unsigned long long)hash_key(key));
+  return dir + "/" + name;
+}
+
+std::unique_ptr<preamble_bank>
+waveform_cache::get(srsran_prach_t &prach, const spoofer_config_t &config,
+                    tx_format_t format) {
+  waveform_key_t key = make_key(config, format);
+  std::string path;
+
+  if (!dir.empty()) {
+    path = path_of(key);
+    std::unique_ptr<preamble_bank> bank = load(key, path);
+    if (bank) {
+      nof_hits++;
+      return bank;
+    }
+  }
+  nof_misses++;
+
+  srsran_prach_cfg_t prach_cfg = get_prach_cfg(config);
+  if (srsran_prach_set_cfg(&prach, &prach_cfg, config.rf.nof_prb)) {
+    throw std::runtime_error("Error configuring PRACH");
+  }
+  auto bank = std::make_unique<preamble_bank>(prach, config, format);
+
+  if (!dir.empty()) {
+    store(key, *bank, path);
+  }
+  return bank;
+}
+
+std::unique_ptr<preamble_bank>
+waveform_cache::load(const waveform_key_t &key, const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  struct stat st = {};
+  if (fstat(fd, &st) != 0 ||
+      (size_t)st.st_size < WAVEFORM_CACHE_HEADER_SIZE) {
+    close(fd);
+    return nullptr;
+  }
+
+  size_t size = st.st_size;
+  // Read-only mapping, backends only read the bursts they are handed, so a
+  // stray write faults instead of silently copying the page
+  void *ptr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    LOG_WARN("Failed to map %s: %s", path.c_str(), strerror(errno));
+    return nullptr;
+  }
+
+  // The key check also rules out hash collisions
+  const waveform_cache_header_t *header =
+      (const waveform_cache_header_t *)ptr;
+  if (memcmp(header->magic, WAVEFORM_CACHE_MAGIC, sizeof(header->magic)) ||
+      header->version != WAVEFORM_CACHE_VERSION ||
+      memcmp(&header->key, &key, sizeof(key)) != 0) {
+    LOG_WARN("Ignoring stale waveform cache file %s", path.c_str());
+    munmap(ptr, size);
+    return nullptr;
+  }
+  madvise(ptr, size, MADV_WILLNEED);
+
+  try {
+    auto bank = std::make_unique<preamble_bank>(
+        ptr, size, WAVEFORM_CACHE_HEADER_SIZE, (tx_format_t)key.format,
+        header->nof_preambles, header->len);
+    LOG_DEBUG("Mapped %u preambles from %s", header->nof_preambles,
+              path.c_str());
+    return bank;
+  } catch (const std::exception &e) {
+    LOG_WARN("Ignoring waveform cache file %s: %s", path.c_str(), e.what());
+    return nullptr;
+  }
+}
+
+void waveform_cache::store(const waveform_key_t &key,
+                           const preamble_bank &bank,
+                           const std::string &path) {
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+  int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LOG_WARN("Failed to create %s: %s", tmp_path.c_str(), strerror(errno));
+    return;
+  }
+
+  uint8_t header_page[WAVEFORM_CACHE_HEADER_SIZE] = {};
+  waveform_cache_header_t *header = (waveform_cache_header_t *)header_page;
+  memcpy(header->magic, WAVEFORM_CACHE_MAGIC, sizeof(header->magic));
+  header->version = WAVEFORM_CACHE_VERSION;
+  header->key = key;
+  header->nof_preambles = bank.size();
+  header->len = bank.preamble_len();
+
+  bool ok = write_all(fd, header_page, sizeof(header_page)) &&
+            write_all(fd, bank.arena_data(), bank.arena_size());
+  close(fd);
+
+  // A reader sees either no file or a complete one
+  if (!ok || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    LOG_WARN("Failed to store waveform cache file %s: %s", path.c_str(),
+             strerror(errno));
+    unlink(tmp_path.c_str());
+    return;
+  }
+  LOG_DEBUG("Stored %u preambles to %s", bank.size(), path.c_str());
+}